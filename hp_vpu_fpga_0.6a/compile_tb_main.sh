@@ -6,6 +6,8 @@ g++ -I systemc/ \
     -o sim_main \
     systemc/hp_vpu_decode.cpp \
     systemc/hp_vpu_lanes.cpp \
+    systemc/hp_vpu_func.cpp \
+    systemc/hp_vpu_simd.cpp \
     systemc/golden_model.cpp \
     systemc/tb_main.cpp \
     -lsystemc
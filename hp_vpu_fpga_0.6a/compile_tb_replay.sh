@@ -0,0 +1,16 @@
+#!/bin/bash
+set -e
+
+echo "Compiling Trace Replay..."
+g++ -O2 -I systemc/ \
+    -o sim_replay \
+    systemc/hp_vpu_decode.cpp \
+    systemc/hp_vpu_lanes.cpp \
+    systemc/hp_vpu_func.cpp \
+    systemc/hp_vpu_simd.cpp \
+    systemc/golden_model.cpp \
+    systemc/tb_replay.cpp \
+    -lsystemc
+
+echo "Compilation successful. Replaying $1..."
+./sim_replay "$@"
@@ -0,0 +1,16 @@
+#!/bin/bash
+set -e
+
+echo "Compiling Parameter Sweep Runner..."
+g++ -O2 -I systemc/ \
+    -o sim_sweep \
+    systemc/hp_vpu_decode.cpp \
+    systemc/hp_vpu_lanes.cpp \
+    systemc/hp_vpu_func.cpp \
+    systemc/hp_vpu_simd.cpp \
+    systemc/golden_model.cpp \
+    systemc/tb_sweep.cpp \
+    -lsystemc
+
+echo "Compilation successful. Running sweep..."
+./sim_sweep config/sweep_gemv.json "$@"
@@ -0,0 +1,16 @@
+#!/bin/bash
+set -e
+
+echo "Compiling TOML Test-Vector Runner..."
+g++ -O2 -I systemc/ \
+    -o sim_toml \
+    systemc/hp_vpu_decode.cpp \
+    systemc/hp_vpu_lanes.cpp \
+    systemc/hp_vpu_func.cpp \
+    systemc/hp_vpu_simd.cpp \
+    systemc/golden_model.cpp \
+    systemc/tb_toml.cpp \
+    -lsystemc
+
+echo "Compilation successful. Running tests/toml..."
+./sim_toml tests/toml "$@"
@@ -0,0 +1,131 @@
+//==============================================================================
+// Hyperplane VPU - Co-simulation Probe
+// Verilator top for systemc/tb_cosim.cpp: hp_vpu_top with the pins the
+// SystemC testbench drives, unused inputs tied off, and the pipeline state
+// compared per cycle against the SystemC model brought out as ports
+//==============================================================================
+
+module hp_vpu_cosim_probe
+  import hp_vpu_pkg::*;
+#(
+  parameter int unsigned DLEN = hp_vpu_pkg::NLANES * 64  // As hp_vpu_top
+)(
+  input  logic                      clk,
+  input  logic                      rst_n,
+
+  // Issue (same pins as the SystemC hp_vpu_top)
+  input  logic                      x_issue_valid_i,
+  output logic                      x_issue_ready_o,
+  input  logic [31:0]               x_issue_instr_i,
+  input  logic [CVXIF_ID_W-1:0]     x_issue_id_i,
+  input  logic [31:0]               x_issue_rs1_i,
+  input  logic [31:0]               x_issue_rs2_i,
+
+  input  logic [31:0]               csr_vtype_i,
+  input  logic [31:0]               csr_vl_i,
+
+  // DMA write port (full-register writes only)
+  input  logic                      dma_we_i,
+  input  logic [4:0]                dma_addr_i,
+  input  logic [DLEN-1:0]           dma_wdata_i,
+  output logic                      dma_ready_o,
+
+  output logic                      busy_o,
+
+  // Configuration, for picking the matching SystemC instance
+  output logic [31:0]               cfg_vlen_o,
+  output logic [31:0]               cfg_dlen_o,
+
+  // Pipeline state (pre-edge values when sampled before the clock rises)
+  output logic                      p_d_valid_o,
+  output logic                      p_of_valid_o,
+  output logic                      p_e1_valid_o,
+  output logic                      p_e1m_valid_o,
+  output logic                      p_e2_valid_o,
+  output logic                      p_e3_valid_o,
+  output logic [2:0]                p_red_state_o,
+  output logic [1:0]                p_wide_state_o,
+  output logic                      p_r3_valid_o,
+  output logic                      p_w2_valid_o,
+  output logic                      p_stall_dec_o,
+  output logic                      p_mul_stall_o,
+  output logic                      p_multicycle_busy_o,
+
+  // Lanes result port (VRF write one cycle later)
+  output logic                      p_wb_valid_o,
+  output logic [4:0]                p_wb_vd_o,
+  output logic [CVXIF_ID_W-1:0]     p_wb_id_o,
+  output logic [DLEN-1:0]           p_wb_data_o
+);
+
+  hp_vpu_top u_top (
+    .clk              (clk),
+    .rst_n            (rst_n),
+    .x_issue_valid_i  (x_issue_valid_i),
+    .x_issue_ready_o  (x_issue_ready_o),
+    .x_issue_accept_o (),
+    .x_issue_instr_i  (x_issue_instr_i),
+    .x_issue_id_i     (x_issue_id_i),
+    .x_issue_rs1_i    (x_issue_rs1_i),
+    .x_issue_rs2_i    (x_issue_rs2_i),
+    .x_result_valid_o (),
+    .x_result_ready_i (1'b1),
+    .x_result_id_o    (),
+    .x_result_data_o  (),
+    .x_result_we_o    (),
+    .csr_vtype_i      (csr_vtype_i),
+    .csr_vl_i         (csr_vl_i),
+    .csr_vtype_o      (),
+    .csr_vl_o         (),
+    .csr_vl_valid_o   (),
+    .csr_req_i        (1'b0),
+    .csr_gnt_o        (),
+    .csr_we_i         (1'b0),
+    .csr_addr_i       (12'd0),
+    .csr_wdata_i      (32'd0),
+    .csr_rdata_o      (),
+    .csr_rvalid_o     (),
+    .csr_error_o      (),
+    .exc_valid_o      (),
+    .exc_cause_o      (),
+    .exc_ack_i        (1'b0),
+    .dma_valid_i      (dma_we_i),
+    .dma_ready_o      (dma_ready_o),
+    .dma_we_i         (dma_we_i),
+    .dma_addr_i       (dma_addr_i),
+    .dma_wdata_i      (dma_wdata_i),
+    .dma_be_i         ({(DLEN/8){1'b1}}),
+    .dma_rvalid_o     (),
+    .dma_rdata_o      (),
+    .dma_dbuf_en_i    (1'b0),
+    .dma_dbuf_swap_i  (1'b0),
+    .x_commit_valid_i (1'b0),
+    .x_commit_id_i    ('0),
+    .x_commit_kill_i  (1'b0),
+    .busy_o           (busy_o),
+    .perf_cnt_o       ()
+  );
+
+  assign cfg_vlen_o = VLEN;
+  assign cfg_dlen_o = DLEN;
+
+  assign p_d_valid_o         = u_top.d2_valid;
+  assign p_of_valid_o        = u_top.of_valid;
+  assign p_e1_valid_o        = u_top.u_lanes.e1_valid;
+  assign p_e1m_valid_o       = u_top.u_lanes.e1m_valid;
+  assign p_e2_valid_o        = u_top.u_lanes.e2_valid;
+  assign p_e3_valid_o        = u_top.u_lanes.e3_valid;
+  assign p_red_state_o       = u_top.u_lanes.red_state;
+  assign p_wide_state_o      = u_top.u_lanes.wide_state;
+  assign p_r3_valid_o        = u_top.u_lanes.r3_valid;
+  assign p_w2_valid_o        = u_top.u_lanes.w2_valid;
+  assign p_stall_dec_o       = u_top.stall_dec;
+  assign p_mul_stall_o       = u_top.mul_stall;
+  assign p_multicycle_busy_o = u_top.multicycle_busy;
+
+  assign p_wb_valid_o = u_top.e3_valid;
+  assign p_wb_vd_o    = u_top.e3_vd;
+  assign p_wb_id_o    = u_top.e3_id;
+  assign p_wb_data_o  = u_top.e3_result;
+
+endmodule
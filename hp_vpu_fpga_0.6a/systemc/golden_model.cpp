@@ -1,367 +1,373 @@
 #include "golden_model.h"
+#include "hp_vpu_simd.h"
 
 namespace hp_vpu {
 
 // LUT Tables (Truncated for brevity)
-const uint16_t GoldenModel::exp_table[256] = { /* ... */ };
-const uint16_t GoldenModel::recip_table[256] = { /* ... */ };
-const uint16_t GoldenModel::rsqrt_table[256] = { /* ... */ };
-const uint16_t GoldenModel::gelu_table[256] = { /* ... */ };
-
-// Compute dispatch
-sc_biguint<DLEN> GoldenModel::compute(
-    vpu_op_e op, sew_e sew,
-    sc_biguint<DLEN> vs1_data, sc_biguint<DLEN> vs2_data, sc_biguint<DLEN> vs3_data,
-    sc_biguint<DLEN> vmask, bool vm, bool is_vx, sc_uint<32> scalar
-) {
-    sc_biguint<DLEN> op_a = vs2_data;
-    sc_biguint<DLEN> op_b;
-    sc_biguint<DLEN> res = 0;
+template<class CFG> const uint16_t GoldenModel_t<CFG>::exp_table[256] = { /* ... */ };
+template<class CFG> const uint16_t GoldenModel_t<CFG>::recip_table[256] = { /* ... */ };
+template<class CFG> const uint16_t GoldenModel_t<CFG>::rsqrt_table[256] = { /* ... */ };
+template<class CFG> const uint16_t GoldenModel_t<CFG>::gelu_table[256] = { /* ... */ };
+
+namespace {
+
+// Element types per width (W = SEW bits); wide types hold 2*SEW results
+template<int W> struct elem_types;
+template<> struct elem_types<8>  { typedef uint8_t  u_t; typedef int8_t  s_t; typedef uint16_t wu_t; static const int sew = SEW_8;  };
+template<> struct elem_types<16> { typedef uint16_t u_t; typedef int16_t s_t; typedef uint32_t wu_t; static const int sew = SEW_16; };
+template<> struct elem_types<32> { typedef uint32_t u_t; typedef int32_t s_t; typedef uint64_t wu_t; static const int sew = SEW_32; };
+
+// All per-op steps for one element width. Element counts and widths are
+// compile-time constants, so every loop below unrolls/vectorizes freely.
+template<class CFG, int W>
+struct golden_ops {
+    typedef vreg<CFG::DLEN> vreg_t;
+    typedef typename elem_types<W>::u_t  u_t;
+    typedef typename elem_types<W>::s_t  s_t;
+    typedef typename elem_types<W>::wu_t wu_t;
+    static const int SEW = elem_types<W>::sew;
+    static const int N   = CFG::DLEN / W;
+    static const int NW  = CFG::DLEN / (2 * W); // Widening outputs
+
+    // --- Operand B / masking ---
+    static vreg_t bcast(uint32_t scalar) {
+        vreg_t r;
+        r.broadcast(W, scalar);
+        return r;
+    }
 
-    // Operand B setup (Vector or Scalar broadcast)
-    if (is_vx) {
-        int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-        int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-        for(int k=0; k<num_elem; k++) {
-            op_b((k+1)*elem_width-1, k*elem_width) = scalar(elem_width-1, 0);
-        }
-    } else {
-        op_b = vs1_data;
+    static vreg_t mask(const vreg_t& res, const vreg_t& old, const vreg_t& m) {
+        vreg_t out;
+        for (int i = 0; i < N; i++) out.template set<u_t>(i, m.bit(i) ? res.template get<u_t>(i) : old.template get<u_t>(i));
+        return out;
     }
 
-    // Operation Dispatch
-    if (op == OP_VADD) res = do_add_sub(op_a, op_b, sew, false);
-    else if (op == OP_VSUB) res = do_add_sub(op_a, op_b, sew, true);
-    else if (op == OP_VRSUB) res = do_add_sub(op_b, op_a, sew, true); // b - a
-    else if (op == OP_VMUL) res = do_mul(op_a, op_b, sew, false, true, true);
-    else if (op == OP_VMULH) res = do_mul(op_a, op_b, sew, true, true, true);
-    else if (op == OP_VMULHU) res = do_mul(op_a, op_b, sew, true, false, false);
-    else if (op == OP_VMULHSU) res = do_mul(op_a, op_b, sew, true, true, false);
-    else if (op == OP_VMACC) { // vd = vd + vs1*vs2
-        sc_biguint<DLEN> prod = do_mul(op_a, op_b, sew, false, true, true);
-        res = do_add_sub(prod, vs3_data, sew, false);
+    // --- Element-wise (shared SIMD kernels) ---
+    static vreg_t run(simd::kop_e k, const vreg_t& a, const vreg_t& b) {
+        vreg_t r;
+        simd::kernel(k, SEW)(r.w, a.w, b.w, vreg_t::NWORDS);
+        return r;
     }
-    else if (op == OP_VNMSAC) { // vd = vd - vs1*vs2
-        sc_biguint<DLEN> prod = do_mul(op_a, op_b, sew, false, true, true);
-        res = do_add_sub(vs3_data, prod, sew, true);
+
+    template<simd::kop_e K>
+    static vreg_t kern(const vreg_t& a, const vreg_t& b, const vreg_t&, uint32_t) { return run(K, a, b); }
+
+    static vreg_t rsub(const vreg_t& a, const vreg_t& b, const vreg_t&, uint32_t) { return run(simd::K_SUB, b, a); }
+
+    // vd = vd + vs1*vs2
+    static vreg_t macc(const vreg_t& a, const vreg_t& b, const vreg_t& c, uint32_t) {
+        return run(simd::K_ADD, run(simd::K_MUL, a, b), c);
     }
-    else if (op == OP_VMADD) { // vd = vs1*vd + vs2
-        sc_biguint<DLEN> prod = do_mul(op_b, vs3_data, sew, false, true, true);
-        res = do_add_sub(prod, op_a, sew, false);
+    // vd = vd - vs1*vs2
+    static vreg_t nmsac(const vreg_t& a, const vreg_t& b, const vreg_t& c, uint32_t) {
+        return run(simd::K_SUB, c, run(simd::K_MUL, a, b));
     }
-    else if (op == OP_VNMSUB) { // vd = vs2 - vs1*vd
-        sc_biguint<DLEN> prod = do_mul(op_b, vs3_data, sew, false, true, true);
-        res = do_add_sub(op_a, prod, sew, true);
+    // vd = vs1*vd + vs2
+    static vreg_t madd(const vreg_t& a, const vreg_t& b, const vreg_t& c, uint32_t) {
+        return run(simd::K_ADD, run(simd::K_MUL, b, c), a);
     }
-    else if (op >= OP_VWMACCU && op <= OP_VWMACCSU) { // Widening MACs
-         res = do_widening(op, op_a, op_b, vs3_data, sew);
+    // vd = vs2 - vs1*vd
+    static vreg_t nmsub(const vreg_t& a, const vreg_t& b, const vreg_t& c, uint32_t) {
+        return run(simd::K_SUB, a, run(simd::K_MUL, b, c));
     }
-    else if (op == OP_VAND || op == OP_VOR || op == OP_VXOR) res = do_logic(op_a, op_b, op);
-    else if (op == OP_VSLL || op == OP_VSRL || op == OP_VSRA || op == OP_VSSRL || op == OP_VSSRA) res = do_shift(op_a, op_b, sew, op);
-    else if (op >= OP_VMINU && op <= OP_VMAX) res = do_minmax(op_a, op_b, sew, op);
-    else if (op >= OP_VSADDU && op <= OP_VSSUB) {
-        // Inline Saturation Logic using standard ints
-        int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-        int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-        int64_t smax = (1LL << (elem_width - 1)) - 1;
-        int64_t smin = -(1LL << (elem_width - 1));
-        uint64_t umax = (1ULL << elem_width) - 1;
-
-        for (int i = 0; i < num_elem; ++i) {
-            int lo = i * elem_width; int hi = lo + elem_width - 1;
-            sc_uint<32> ua = op_a(hi, lo).to_uint();
-            sc_uint<32> ub = op_b(hi, lo).to_uint();
-
-            int64_t sa = (sew==SEW_8)?(int64_t)(int8_t)ua:(sew==SEW_16)?(int64_t)(int16_t)ua:(int64_t)(int32_t)ua;
-            int64_t sb = (sew==SEW_8)?(int64_t)(int8_t)ub:(sew==SEW_16)?(int64_t)(int16_t)ub:(int64_t)(int32_t)ub;
-            uint64_t u_a = (uint64_t)ua;
-            uint64_t u_b = (uint64_t)ub;
-
-            uint64_t r_u = 0;
-            int64_t r_s = 0;
-            bool is_signed = false;
-
-            if (op == OP_VSADDU) {
-                uint64_t sum = u_a + u_b;
-                if (sum > umax) r_u = umax; else r_u = sum;
-            } else if (op == OP_VSADD) {
-                int64_t sum = sa + sb;
-                if (sum > smax) r_s = smax; else if (sum < smin) r_s = smin; else r_s = sum;
-                is_signed = true;
-            } else if (op == OP_VSSUBU) {
-                if (u_a < u_b) r_u = 0; else r_u = u_a - u_b;
-            } else if (op == OP_VSSUB) {
-                int64_t diff = sa - sb;
-                if (diff > smax) r_s = smax; else if (diff < smin) r_s = smin; else r_s = diff;
-                is_signed = true;
-            }
-            if (is_signed) res(hi, lo) = (sc_int<64>)r_s;
-            else res(hi, lo) = (sc_uint<64>)r_u;
+
+    static vreg_t v_and(const vreg_t& a, const vreg_t& b, const vreg_t&, uint32_t) { return a & b; }
+    static vreg_t v_or (const vreg_t& a, const vreg_t& b, const vreg_t&, uint32_t) { return a | b; }
+    static vreg_t v_xor(const vreg_t& a, const vreg_t& b, const vreg_t&, uint32_t) { return a ^ b; }
+
+    // --- Scalar loops ---
+    template<int OP>
+    static vreg_t shift(const vreg_t& a, const vreg_t& b, const vreg_t&, uint32_t) {
+        vreg_t r;
+        for (int i = 0; i < N; i++) {
+            u_t val = a.template get<u_t>(i);
+            int shamt = b.template get<u_t>(i) & 0x1F;
+            if (OP == OP_VSLL)      r.template set<u_t>(i, (u_t)((uint64_t)val << shamt));
+            else if (OP == OP_VSRL) r.template set<u_t>(i, (u_t)(val >> shamt));
+            else                    r.template set<u_t>(i, (u_t)((s_t)val >> shamt));
         }
+        return r;
     }
-    else if (op >= OP_VMSEQ && op <= OP_VMSGTU) res = do_cmp(op_a, op_b, sew, op);
-    else if (op >= OP_VEXP && op <= OP_VGELU) res = do_lut(op, op_a, sew);
-    else if (op >= OP_VREDSUM && op <= OP_VREDMAX) res = do_reduction(op, op_a, op_b, sew);
-    else if (op >= OP_VWMUL && op <= OP_VWSUBU) res = do_widening(op, op_a, op_b, vs3_data, sew);
-    else if (op == OP_VSLIDEUP || op == OP_VSLIDEDN || op == OP_VSLIDE1UP || op == OP_VSLIDE1DN)
-        res = do_slide(op, op_a, vs3_data, scalar, sew);
-    else if (op == OP_VRGATHER || op == OP_VRGATHEREI16)
-        res = do_gather(op, op_a, op_b, sew);
-    else if (op == OP_VMV || op == OP_VMERGE) res = op_b;
-    else res = 0;
 
-    // Apply Mask
-    if (!(op >= OP_VMSEQ && op <= OP_VMSGTU) && !(op >= OP_VREDSUM && op <= OP_VREDMAX)) {
-        res = apply_mask(res, vs3_data, vmask, vm, sew);
+    // Basic LUT simulation
+    template<int OP>
+    static vreg_t lut(const vreg_t& a, const vreg_t&, const vreg_t&, uint32_t) {
+        vreg_t r;
+        for (int i = 0; i < N; i++) {
+            uint32_t index = a.template get<u_t>(i) & 0xFF;
+            uint32_t val = 0;
+            if (OP == OP_VEXP) val = index + 1;
+            else if (OP == OP_VRECIP) val = (index == 0) ? 0xFFFF : (32768 / index);
+            else if (OP == OP_VRSQRT) val = (index == 0) ? 0xFFFF : (16384 / (int)std::sqrt((double)index));
+            else if (OP == OP_VGELU) val = index;
+            r.template set<u_t>(i, (u_t)(val & 0xFFFF));
+        }
+        return r;
     }
 
-    return res;
-}
-
-sc_biguint<DLEN> GoldenModel::do_add_sub(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, bool is_sub) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width;
-        int hi = lo + elem_width - 1;
-        sc_uint<32> val_a = a(hi, lo).to_uint();
-        sc_uint<32> val_b = b(hi, lo).to_uint();
-        if (is_sub) res(hi, lo) = val_a - val_b;
-        else        res(hi, lo) = val_a + val_b;
+    // Fold vs2 into vs1[0]; result in element 0, upper elements zero
+    template<int OP>
+    static vreg_t reduce(const vreg_t& a, const vreg_t& b, const vreg_t&, uint32_t) {
+        u_t acc = b.template get<u_t>(0);
+        for (int i = 0; i < N; i++) {
+            u_t u = a.template get<u_t>(i);
+            if (OP == OP_VREDSUM)       acc = (u_t)(acc + u); // Wrap around
+            else if (OP == OP_VREDAND)  acc &= u;
+            else if (OP == OP_VREDOR)   acc |= u;
+            else if (OP == OP_VREDXOR)  acc ^= u;
+            else if (OP == OP_VREDMINU) acc = (u < acc) ? u : acc;
+            else if (OP == OP_VREDMAXU) acc = (u > acc) ? u : acc;
+            else if (OP == OP_VREDMIN)  acc = ((s_t)u < (s_t)acc) ? u : acc;
+            else if (OP == OP_VREDMAX)  acc = ((s_t)u > (s_t)acc) ? u : acc;
+        }
+        vreg_t r;
+        r.template set<u_t>(0, acc);
+        return r;
     }
-    return res;
-}
 
-sc_biguint<DLEN> GoldenModel::do_mul(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, bool high, bool signed_a, bool signed_b) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
+    // 2*SEW results from the low half of the sources; VWMACC accumulates into vd
+    template<int OP>
+    static vreg_t widen(const vreg_t& a, const vreg_t& b, const vreg_t& c, uint32_t) {
+        vreg_t r;
+        for (int i = 0; i < NW; i++) {
+            int64_t u1 = a.template get<u_t>(i), u2 = b.template get<u_t>(i);
+            int64_t s1 = a.template get<s_t>(i), s2 = b.template get<s_t>(i);
+            int64_t v = 0;
+            if (OP == OP_VWMUL)        v = s1 * s2;
+            else if (OP == OP_VWMULU)  v = (int64_t)((uint64_t)u1 * (uint64_t)u2);
+            else if (OP == OP_VWMULSU) v = s1 * u2;
+            else if (OP == OP_VWADD)   v = s1 + s2;
+            else if (OP == OP_VWADDU)  v = u1 + u2;
+            else if (OP == OP_VWSUB)   v = s1 - s2;
+            else if (OP == OP_VWSUBU)  v = u1 - u2;
+            else if (OP == OP_VWMACC)  v = (int64_t)c.template get<wu_t>(i) + s1 * s2;
+            r.template set<wu_t>(i, (wu_t)v);
+        }
+        return r;
+    }
 
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width;
-        int hi = lo + elem_width - 1;
+    // Offset from the scalar; vd elements without a source keep old_vd
+    template<int OP>
+    static vreg_t slide(const vreg_t& a, const vreg_t&, const vreg_t& c, uint32_t scalar) {
+        if (OP == OP_VSLIDE1UP || OP == OP_VSLIDE1DN) return slide1<OP>(a, scalar);
+        vreg_t r = c;
+        int offset = (int)scalar;
+        for (int i = 0; i < N; i++) {
+            int src_idx = -1;
+            if (OP == OP_VSLIDEUP) {
+                if (i >= offset) src_idx = i - offset;
+            } else if (OP == OP_VSLIDEDN) {
+                if (i + offset < N) src_idx = i + offset;
+            }
+            if (src_idx >= 0 && src_idx < N) r.template set<u_t>(i, a.template get<u_t>(src_idx));
+        }
+        return r;
+    }
 
-        sc_uint<32> ua = a(hi, lo).to_uint();
-        sc_uint<32> ub = b(hi, lo).to_uint();
+    // Shift by one element, the scalar filling the vacated end (as the RTL)
+    template<int OP>
+    static vreg_t slide1(const vreg_t& a, uint32_t scalar) {
+        vreg_t r;
+        for (int i = 0; i < N; i++) {
+            if (OP == OP_VSLIDE1UP) r.template set<u_t>(i, i == 0 ? (u_t)scalar : a.template get<u_t>(i - 1));
+            else r.template set<u_t>(i, i == N - 1 ? (u_t)scalar : a.template get<u_t>(i + 1));
+        }
+        return r;
+    }
 
-        int64_t sa = (sew==SEW_8)?(int64_t)(int8_t)ua : (sew==SEW_16)?(int64_t)(int16_t)ua : (int64_t)(int32_t)ua;
-        int64_t sb = (sew==SEW_8)?(int64_t)(int8_t)ub : (sew==SEW_16)?(int64_t)(int16_t)ub : (int64_t)(int32_t)ub;
+    static vreg_t move(const vreg_t&, const vreg_t& b, const vreg_t&, uint32_t) { return b; }
 
-        uint64_t prod_u = (uint64_t)ua * (uint64_t)ub;
-        int64_t prod_s = sa * sb;
-        int64_t prod_su = sa * (int64_t)(uint64_t)ub;
+    // Unimplemented ops (incl. VRGATHER, VSSRL/VSSRA) produce zero
+    static vreg_t zero(const vreg_t&, const vreg_t&, const vreg_t&, uint32_t) { return vreg_t(); }
+};
 
-        sc_uint<64> final_prod;
-        if (signed_a && signed_b) final_prod = (uint64_t)prod_s;
-        else if (!signed_a && !signed_b) final_prod = prod_u;
-        else final_prod = (uint64_t)prod_su;
+// (op, SEW) dispatch table, built once on first use (per config)
+template<class CFG>
+struct golden_table {
+    typedef GoldenModel_t<CFG> GM;
+    typename GM::entry_t e[OP_COUNT][3];
+    bool known[OP_COUNT];
 
-        if (high) res(hi, lo) = (final_prod >> elem_width);
-        else      res(hi, lo) = final_prod;
+    golden_table() {
+        for (int op = 0; op < OP_COUNT; op++) known[op] = false;
+        fill<8>(0);
+        fill<16>(1);
+        fill<32>(2);
     }
-    return res;
-}
 
-sc_biguint<DLEN> GoldenModel::do_logic(sc_biguint<DLEN> a, sc_biguint<DLEN> b, vpu_op_e op) {
-    if (op == OP_VAND) return a & b;
-    if (op == OP_VOR) return a | b;
-    return a ^ b;
-}
-
-sc_biguint<DLEN> GoldenModel::do_shift(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width; int hi = lo + elem_width - 1;
-        sc_uint<32> val = a(hi, lo).to_uint();
-        sc_uint<5> shamt = b(lo + 4, lo).to_uint();
-
-        if (op == OP_VSLL) res(hi, lo) = val << shamt;
-        else if (op == OP_VSRL) res(hi, lo) = val >> shamt;
-        else if (op == OP_VSRA) {
-            if (sew==SEW_8) res(hi,lo) = (sc_int<8>)val >> shamt;
-            else if (sew==SEW_16) res(hi,lo) = (sc_int<16>)val >> shamt;
-            else res(hi,lo) = (sc_int<32>)val >> shamt;
-        }
+    template<int W>
+    void fill(int col) {
+        typedef golden_ops<CFG, W> G;
+        for (int op = 0; op < OP_COUNT; op++) e[op][col] = { &G::zero, &G::bcast, &G::mask };
+
+        set(OP_VADD,    col, &G::template kern<simd::K_ADD>);
+        set(OP_VSUB,    col, &G::template kern<simd::K_SUB>);
+        set(OP_VRSUB,   col, &G::rsub);
+        set(OP_VMUL,    col, &G::template kern<simd::K_MUL>);
+        set(OP_VMULH,   col, &G::template kern<simd::K_MULH>);
+        set(OP_VMULHU,  col, &G::template kern<simd::K_MULHU>);
+        set(OP_VMULHSU, col, &G::template kern<simd::K_MULHSU>);
+        set(OP_VMACC,   col, &G::macc);
+        set(OP_VNMSAC,  col, &G::nmsac);
+        set(OP_VMADD,   col, &G::madd);
+        set(OP_VNMSUB,  col, &G::nmsub);
+
+        set(OP_VAND, col, &G::v_and);
+        set(OP_VOR,  col, &G::v_or);
+        set(OP_VXOR, col, &G::v_xor);
+        set(OP_VSLL, col, &G::template shift<OP_VSLL>);
+        set(OP_VSRL, col, &G::template shift<OP_VSRL>);
+        set(OP_VSRA, col, &G::template shift<OP_VSRA>);
+
+        set(OP_VMINU, col, &G::template kern<simd::K_MINU>);
+        set(OP_VMIN,  col, &G::template kern<simd::K_MIN>);
+        set(OP_VMAXU, col, &G::template kern<simd::K_MAXU>);
+        set(OP_VMAX,  col, &G::template kern<simd::K_MAX>);
+
+        set(OP_VSADDU, col, &G::template kern<simd::K_SADDU>);
+        set(OP_VSADD,  col, &G::template kern<simd::K_SADD>);
+        set(OP_VSSUBU, col, &G::template kern<simd::K_SSUBU>);
+        set(OP_VSSUB,  col, &G::template kern<simd::K_SSUB>);
+
+        // Compares write a mask register: never merged with old_vd
+        set(OP_VMSEQ,  col, &G::template kern<simd::K_MSEQ>,  false);
+        set(OP_VMSNE,  col, &G::template kern<simd::K_MSNE>,  false);
+        set(OP_VMSLTU, col, &G::template kern<simd::K_MSLTU>, false);
+        set(OP_VMSLT,  col, &G::template kern<simd::K_MSLT>,  false);
+        set(OP_VMSLEU, col, &G::template kern<simd::K_MSLEU>, false);
+        set(OP_VMSLE,  col, &G::template kern<simd::K_MSLE>,  false);
+        set(OP_VMSGTU, col, &G::template kern<simd::K_MSGTU>, false);
+
+        set(OP_VEXP,   col, &G::template lut<OP_VEXP>);
+        set(OP_VRECIP, col, &G::template lut<OP_VRECIP>);
+        set(OP_VRSQRT, col, &G::template lut<OP_VRSQRT>);
+        set(OP_VGELU,  col, &G::template lut<OP_VGELU>);
+
+        set(OP_VREDSUM,  col, &G::template reduce<OP_VREDSUM>,  false);
+        set(OP_VREDAND,  col, &G::template reduce<OP_VREDAND>,  false);
+        set(OP_VREDOR,   col, &G::template reduce<OP_VREDOR>,   false);
+        set(OP_VREDXOR,  col, &G::template reduce<OP_VREDXOR>,  false);
+        set(OP_VREDMINU, col, &G::template reduce<OP_VREDMINU>, false);
+        set(OP_VREDMIN,  col, &G::template reduce<OP_VREDMIN>,  false);
+        set(OP_VREDMAXU, col, &G::template reduce<OP_VREDMAXU>, false);
+        set(OP_VREDMAX,  col, &G::template reduce<OP_VREDMAX>,  false);
+
+        set(OP_VWMUL,   col, &G::template widen<OP_VWMUL>);
+        set(OP_VWMULU,  col, &G::template widen<OP_VWMULU>);
+        set(OP_VWMULSU, col, &G::template widen<OP_VWMULSU>);
+        set(OP_VWMACC,  col, &G::template widen<OP_VWMACC>);
+        set(OP_VWADD,   col, &G::template widen<OP_VWADD>);
+        set(OP_VWADDU,  col, &G::template widen<OP_VWADDU>);
+        set(OP_VWSUB,   col, &G::template widen<OP_VWSUB>);
+        set(OP_VWSUBU,  col, &G::template widen<OP_VWSUBU>);
+
+        set(OP_VSLIDEUP,  col, &G::template slide<OP_VSLIDEUP>);
+        set(OP_VSLIDEDN,  col, &G::template slide<OP_VSLIDEDN>);
+        set(OP_VSLIDE1UP, col, &G::template slide<OP_VSLIDE1UP>);
+        set(OP_VSLIDE1DN, col, &G::template slide<OP_VSLIDE1DN>);
+
+        set(OP_VMV,    col, &G::move);
+        set(OP_VMERGE, col, &G::move);
     }
-    return res;
-}
 
-sc_biguint<DLEN> GoldenModel::do_minmax(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width; int hi = lo + elem_width - 1;
-        sc_uint<32> ua = a(hi, lo).to_uint();
-        sc_uint<32> ub = b(hi, lo).to_uint();
-        int64_t sa = (sew==SEW_8)?(int64_t)(int8_t)ua : (sew==SEW_16)?(int64_t)(int16_t)ua : (int64_t)(int32_t)ua;
-        int64_t sb = (sew==SEW_8)?(int64_t)(int8_t)ub : (sew==SEW_16)?(int64_t)(int16_t)ub : (int64_t)(int32_t)ub;
-
-        if (op == OP_VMINU) res(hi, lo) = (ua < ub) ? ua : ub;
-        else if (op == OP_VMIN) res(hi, lo) = (sa < sb) ? (sc_uint<32>)(int32_t)sa : (sc_uint<32>)(int32_t)sb;
-        else if (op == OP_VMAXU) res(hi, lo) = (ua > ub) ? ua : ub;
-        else if (op == OP_VMAX) res(hi, lo) = (sa > sb) ? (sc_uint<32>)(int32_t)sa : (sc_uint<32>)(int32_t)sb;
+    void set(vpu_op_e op, int col, typename GM::op_fn fn, bool masked = true) {
+        e[op][col].fn = fn;
+        if (!masked) e[op][col].mask = nullptr;
+        known[op] = true;
     }
-    return res;
+};
+
+} // namespace
+
+template<class CFG>
+static const golden_table<CFG>& golden_table_instance() {
+    static const golden_table<CFG> table;
+    return table;
 }
 
-sc_biguint<DLEN> GoldenModel::do_cmp(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op) {
-    sc_biguint<DLEN> res = 0; // Mask result
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width; int hi = lo + elem_width - 1;
-        sc_uint<32> ua = a(hi, lo).to_uint();
-        sc_uint<32> ub = b(hi, lo).to_uint();
-        int64_t sa = (sew==SEW_8)?(int64_t)(int8_t)ua : (sew==SEW_16)?(int64_t)(int16_t)ua : (int64_t)(int32_t)ua;
-        int64_t sb = (sew==SEW_8)?(int64_t)(int8_t)ub : (sew==SEW_16)?(int64_t)(int16_t)ub : (int64_t)(int32_t)ub;
-
-        bool bit = false;
-        if (op == OP_VMSEQ) bit = (ua == ub);
-        else if (op == OP_VMSNE) bit = (ua != ub);
-        else if (op == OP_VMSLTU) bit = (ua < ub);
-        else if (op == OP_VMSLT) bit = (sa < sb);
-        else if (op == OP_VMSLEU) bit = (ua <= ub);
-        else if (op == OP_VMSLE) bit = (sa <= sb);
-        else if (op == OP_VMSGTU) bit = (ua > ub);
-        else if (op == OP_VMSGT) bit = (sa > sb);
-
-        res[i] = bit;
-    }
-    return res;
+template<class CFG>
+auto GoldenModel_t<CFG>::lookup(vpu_op_e op, sew_e sew) -> const entry_t& {
+    int o = ((unsigned)op < (unsigned)OP_COUNT) ? (int)op : (int)OP_NOP;
+    return golden_table_instance<CFG>().e[o][(sew > SEW_32) ? 2 : (int)sew];
 }
 
-sc_biguint<DLEN> GoldenModel::do_lut(vpu_op_e op, sc_biguint<DLEN> idx, sew_e sew) {
-    // Basic LUT simulation
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int idx_stride = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-    for (int i = 0; i < num_elem; ++i) {
-        int idx_lo = i * idx_stride; int idx_hi = idx_lo + 7;
-        sc_uint<8> index = idx(idx_hi, idx_lo).to_uint();
-        sc_uint<16> val = 0;
-        if (op == OP_VEXP) val = index + 1;
-        else if (op == OP_VRECIP) val = (index == 0) ? 0xFFFF : (32768 / index);
-        int res_lo = i * ((sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32);
-        int res_hi = res_lo + ((sew == SEW_8) ? 7 : (sew == SEW_16) ? 15 : 31);
-        res(res_hi, res_lo) = val;
-    }
-    return res;
+template<class CFG>
+bool GoldenModel_t<CFG>::supports(vpu_op_e op) {
+    return (unsigned)op < (unsigned)OP_COUNT && golden_table_instance<CFG>().known[op];
 }
 
-sc_biguint<DLEN> GoldenModel::do_reduction(vpu_op_e op, sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sew_e sew) {
-    sc_biguint<DLEN> res = vs1;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    sc_uint<32> acc_u = vs1(elem_width-1, 0).to_uint();
-    int64_t acc_s = (sew==SEW_8)?(int64_t)(int8_t)acc_u : (sew==SEW_16)?(int64_t)(int16_t)acc_u : (int64_t)(int32_t)acc_u;
-
-    for (int i=0; i<num_elem; i++) {
-        int lo = i*elem_width, hi = lo+elem_width-1;
-        sc_uint<32> u = vs2(hi, lo).to_uint();
-        int64_t s = (sew==SEW_8)?(int64_t)(int8_t)u : (sew==SEW_16)?(int64_t)(int16_t)u : (int64_t)(int32_t)u;
-
-        if (op == OP_VREDSUM) {
-             acc_s += s; // Wrap around
-             acc_u += u;
-        } else if (op == OP_VREDAND) acc_u &= u;
-        else if (op == OP_VREDOR) acc_u |= u;
-        else if (op == OP_VREDXOR) acc_u ^= u;
-        else if (op == OP_VREDMINU) acc_u = (u < acc_u) ? u : acc_u;
-        else if (op == OP_VREDMIN) acc_s = (s < acc_s) ? s : acc_s;
-        else if (op == OP_VREDMAXU) acc_u = (u > acc_u) ? u : acc_u;
-        else if (op == OP_VREDMAX) acc_s = (s > acc_s) ? s : acc_s;
-    }
+// Broadcast / op / mask steps for one resolved (op, SEW)
+template<class CFG>
+auto GoldenModel_t<CFG>::apply(
+    const entry_t& e,
+    const vreg_t& vs1_data, const vreg_t& vs2_data, const vreg_t& vs3_data,
+    const vreg_t& vmask, bool vm, bool is_vx, uint32_t s
+) -> vreg_t {
+    // Operand B setup (Vector or Scalar broadcast)
+    vreg_t res = is_vx ? e.fn(vs2_data, e.bcast(s), vs3_data, s)
+                       : e.fn(vs2_data, vs1_data, vs3_data, s);
 
-    // Result
-    res = 0;
-    if (op == OP_VREDSUM || op == OP_VREDMIN || op == OP_VREDMAX) res(elem_width-1, 0) = (sc_uint<32>)(int32_t)acc_s;
-    else res(elem_width-1, 0) = acc_u;
+    // Apply Mask
+    if (e.mask && !vm) res = e.mask(res, vs3_data, vmask);
 
     return res;
 }
 
-sc_biguint<DLEN> GoldenModel::do_widening(vpu_op_e op, sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sc_biguint<DLEN> acc, sew_e sew) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/16 : (sew == SEW_16) ? DLEN/32 : DLEN/64;
-    int in_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-    int out_width = in_width * 2;
-
-    for (int i=0; i<num_elem; i++) {
-        int lo = i*in_width; int hi = lo+in_width-1;
-        sc_uint<32> u1 = vs2(hi, lo).to_uint();
-        sc_uint<32> u2 = vs1(hi, lo).to_uint();
-        int64_t s1 = (sew==SEW_8)?(int64_t)(int8_t)u1 : (sew==SEW_16)?(int64_t)(int16_t)u1 : (int64_t)(int32_t)u1;
-        int64_t s2 = (sew==SEW_8)?(int64_t)(int8_t)u2 : (sew==SEW_16)?(int64_t)(int16_t)u2 : (int64_t)(int32_t)u2;
-
-        uint64_t res_u = 0; int64_t res_s = 0;
-        bool is_signed = false;
-
-        if (op == OP_VWMUL) { res_s = s1 * s2; is_signed = true; }
-        else if (op == OP_VWMULU) { res_u = (uint64_t)u1 * (uint64_t)u2; }
-        else if (op == OP_VWMULSU) { res_s = s1 * (uint64_t)u2; is_signed = true; }
-        else if (op == OP_VWADD) { res_s = s1 + s2; is_signed = true; }
-        else if (op == OP_VWADDU) { res_u = (uint64_t)u1 + (uint64_t)u2; }
-        else if (op == OP_VWSUB) { res_s = s1 - s2; is_signed = true; }
-        else if (op == OP_VWSUBU) { res_u = (uint64_t)u1 - (uint64_t)u2; }
-        else if (op == OP_VWMACC) {
-             int acc_lo = i*out_width; int acc_hi = acc_lo+out_width-1;
-             int64_t old = (int64_t)(sc_int<64>)acc(acc_hi, acc_lo);
-             res_s = old + s1 * s2; is_signed = true;
-        }
-
-        int out_lo = i*out_width; int out_hi = out_lo+out_width-1;
-        if (is_signed) res(out_hi, out_lo) = (sc_uint<64>)res_s;
-        else           res(out_hi, out_lo) = (sc_uint<64>)res_u;
-    }
-    return res;
+// Compute: one table lookup, then the steps for that (op, SEW)
+template<class CFG>
+auto GoldenModel_t<CFG>::compute(
+    vpu_op_e op, sew_e sew,
+    const vreg_t& vs1_data, const vreg_t& vs2_data, const vreg_t& vs3_data,
+    const vreg_t& vmask, bool vm, bool is_vx, sc_uint<32> scalar
+) -> vreg_t {
+    return apply(lookup(op, sew), vs1_data, vs2_data, vs3_data, vmask, vm, is_vx, (uint32_t)scalar.to_uint());
 }
 
-sc_biguint<DLEN> GoldenModel::do_slide(vpu_op_e op, sc_biguint<DLEN> vs2, sc_biguint<DLEN> old_vd, sc_uint<32> scalar, sew_e sew) {
-    sc_biguint<DLEN> res = old_vd;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-    int offset = scalar.to_int();
-
-    for (int i=0; i<num_elem; i++) {
-        int src_idx = -1;
-        if (op == OP_VSLIDEUP) {
-            if (i >= offset) src_idx = i - offset;
-        } else if (op == OP_VSLIDEDN) {
-             if (i + offset < num_elem) src_idx = i + offset;
-        }
+// Chunks of a few thousand records keep the hand-off cost well below the work
+static const size_t GOLDEN_BATCH_CHUNK = 2048;
 
-        if (src_idx >= 0 && src_idx < num_elem) {
-             res((i+1)*elem_width-1, i*elem_width) = vs2((src_idx+1)*elem_width-1, src_idx*elem_width);
+template<class CFG>
+void GoldenModel_t<CFG>::compute_batch(const batch_req_t* req, vreg_t* out, size_t n, work_pool* pool) {
+    if (!pool) pool = &work_pool::shared();
+    pool->parallel_for(n, GOLDEN_BATCH_CHUNK, [req, out](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++) {
+            const batch_req_t& r = req[i];
+            out[i] = apply(lookup(r.op, r.sew), r.vs1, r.vs2, r.vs3, r.vmask, r.vm, r.is_vx, r.scalar);
         }
-    }
-    return res;
-}
-
-sc_biguint<DLEN> GoldenModel::do_gather(vpu_op_e op, sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sew_e sew) {
-    // Implement VRGATHER
-    return 0;
+    });
 }
 
-sc_biguint<DLEN> GoldenModel::apply_mask(sc_biguint<DLEN> res, sc_biguint<DLEN> old, sc_biguint<DLEN> mask, bool vm, sew_e sew) {
-    if (vm) return res;
-    sc_biguint<DLEN> out = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-    for (int i=0; i<num_elem; i++) {
-        int lo = i*elem_width, hi=lo+elem_width-1;
-        if (mask[i]) out(hi,lo) = res(hi,lo);
-        else         out(hi,lo) = old(hi,lo);
+template<class CFG>
+size_t GoldenModel_t<CFG>::check_batch(const batch_req_t* req, const vreg_t* actual, size_t n,
+                                       std::vector<size_t>* bad, work_pool* pool) {
+    if (!pool) pool = &work_pool::shared();
+    std::atomic<size_t> count(0);
+    std::mutex m;
+    std::vector<size_t> found; // Chunks finish in any order; sorted before appending
+    pool->parallel_for(n, GOLDEN_BATCH_CHUNK, [&](size_t b, size_t e) {
+        std::vector<size_t> local;
+        for (size_t i = b; i < e; i++) {
+            const batch_req_t& r = req[i];
+            vreg_t exp = apply(lookup(r.op, r.sew), r.vs1, r.vs2, r.vs3, r.vmask, r.vm, r.is_vx, r.scalar);
+            if (!(exp == actual[i])) local.push_back(i);
+        }
+        if (local.empty()) return;
+        count += local.size();
+        if (bad) {
+            std::lock_guard<std::mutex> lk(m);
+            found.insert(found.end(), local.begin(), local.end());
+        }
+    });
+    if (bad) {
+        std::sort(found.begin(), found.end());
+        bad->insert(bad->end(), found.begin(), found.end());
     }
-    return out;
+    return count.load();
 }
 
+template class GoldenModel_t<cfg_64>;
+template class GoldenModel_t<cfg_128>;
+template class GoldenModel_t<cfg_256>;
+template class GoldenModel_t<cfg_512>;
+
 } // namespace hp_vpu
@@ -3,44 +3,78 @@
 
 #include <systemc.h>
 #include "hp_vpu_pkg.h"
+#include "hp_vpu_vreg.h"
+#include "hp_vpu_pool.h"
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 namespace hp_vpu {
 
 // C++ Golden Model for Hyperplane VPU
 // Mirrors the logic of compute_golden_result in hp_vpu_tb.sv
-class GoldenModel {
+template<class CFG>
+class GoldenModel_t {
 public:
+    typedef vreg<CFG::DLEN> vreg_t;
+
     // Compute expected result for a given operation and inputs
-    static sc_biguint<DLEN> compute(
+    static vreg_t compute(
         vpu_op_e op,
         sew_e sew,
-        sc_biguint<DLEN> vs1_data,
-        sc_biguint<DLEN> vs2_data,
-        sc_biguint<DLEN> vs3_data, // old_vd/accumulator
-        sc_biguint<DLEN> vmask,
+        const vreg_t& vs1_data,
+        const vreg_t& vs2_data,
+        const vreg_t& vs3_data, // old_vd/accumulator
+        const vreg_t& vmask,
         bool vm,
         bool is_vx,
         sc_uint<32> scalar
     );
 
+    // One compute() call as a record (bulk checking)
+    struct batch_req_t {
+        vpu_op_e op;
+        sew_e    sew;
+        bool     vm;
+        bool     is_vx;
+        uint32_t scalar;
+        vreg_t   vs1, vs2, vs3, vmask;
+    };
+
+    // out[i] = compute(req[i]) for i < n, split over a work_pool (default:
+    // work_pool::shared()). Stateless, so any number of threads may call it
+    // at once; out must not alias req.
+    static void compute_batch(const batch_req_t* req, vreg_t* out, size_t n, work_pool* pool = nullptr);
+
+    // Compare actual[i] against compute(req[i]); returns the mismatch count
+    // and, if bad is given, appends the mismatching indices in ascending
+    // order (entries already in bad are left as they are)
+    static size_t check_batch(const batch_req_t* req, const vreg_t* actual, size_t n,
+                              std::vector<size_t>* bad = nullptr, work_pool* pool = nullptr);
+
+    // Per-(op, SEW) steps, all specialized on element width at compile time
+    // op:    a = vs2, b = operand B after broadcast, c = vs3/old_vd
+    // bcast: replicate a .vx scalar across SEW-wide elements
+    // mask:  merge res/old per mask bit (null for mask-producing ops and reductions)
+    typedef vreg_t (*op_fn)(const vreg_t& a, const vreg_t& b, const vreg_t& c, uint32_t scalar);
+    typedef vreg_t (*bcast_fn)(uint32_t scalar);
+    typedef vreg_t (*mask_fn)(const vreg_t& res, const vreg_t& old, const vreg_t& mask);
+
+    struct entry_t {
+        op_fn    fn;
+        bcast_fn bcast;
+        mask_fn  mask;
+    };
+
+    // Resolved once per process; SEW_64 maps to the 32-bit row (as sew_bits)
+    static const entry_t& lookup(vpu_op_e op, sew_e sew);
+
+    // False for opcodes without a reference implementation (result is zero)
+    static bool supports(vpu_op_e op);
+
 private:
-    // Helpers
-    static sc_biguint<DLEN> apply_mask(sc_biguint<DLEN> res, sc_biguint<DLEN> old, sc_biguint<DLEN> mask, bool vm, sew_e sew);
-
-    // ALU implementations
-    static sc_biguint<DLEN> do_add_sub(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, bool is_sub);
-    static sc_biguint<DLEN> do_mul(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, bool high, bool signed_a, bool signed_b);
-    static sc_biguint<DLEN> do_logic(sc_biguint<DLEN> a, sc_biguint<DLEN> b, vpu_op_e op);
-    static sc_biguint<DLEN> do_shift(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op);
-    static sc_biguint<DLEN> do_minmax(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op);
-    static sc_biguint<DLEN> do_cmp(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op);
-    static sc_biguint<DLEN> do_lut(vpu_op_e op, sc_biguint<DLEN> idx, sew_e sew);
-    static sc_biguint<DLEN> do_reduction(vpu_op_e op, sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sew_e sew);
-    static sc_biguint<DLEN> do_widening(vpu_op_e op, sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sc_biguint<DLEN> acc, sew_e sew);
-    static sc_biguint<DLEN> do_slide(vpu_op_e op, sc_biguint<DLEN> vs2, sc_biguint<DLEN> old_vd, sc_uint<32> scalar, sew_e sew);
-    static sc_biguint<DLEN> do_gather(vpu_op_e op, sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sew_e sew);
+    static vreg_t apply(const entry_t& e, const vreg_t& vs1, const vreg_t& vs2, const vreg_t& vs3,
+                        const vreg_t& vmask, bool vm, bool is_vx, uint32_t scalar);
 
     // LUT tables
     static const uint16_t exp_table[256];
@@ -49,6 +83,9 @@ private:
     static const uint16_t gelu_table[256];
 };
 
+// Member definitions in golden_model.cpp, instantiated there for every config
+typedef GoldenModel_t<cfg_default> GoldenModel;
+
 } // namespace hp_vpu
 
 #endif // GOLDEN_MODEL_H
@@ -0,0 +1,397 @@
+#ifndef HP_VPU_COSIM_H
+#define HP_VPU_COSIM_H
+
+#include <systemc.h>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include "hp_vpu_pkg.h"
+#include "hp_vpu_vreg.h"
+#include "hp_vpu_func.h"
+#include "hp_vpu_top.h"
+
+namespace hp_vpu {
+
+// Per-cycle RTL vs SystemC correlation (tb_cosim, `make cosim`)
+// - RTL is the Verilated cosim/hp_vpu_cosim_probe.sv (hp_vpu_top plus probe
+//   ports), stepped from this process: inputs copied from the SystemC pins
+//   and evaluated before each tb clk posedge, clock raised after sampling,
+//   lowered at the negedge
+// - At every posedge out of reset both models' pre-edge state is sampled
+//   into a frame_t and compared field by field; the first divergence prints
+//   the differing fields and the last `history` frames of both models
+// - Issue is elastic: RTL sees the SystemC pins while it keeps pace, and a
+//   queue of instructions SystemC accepted but RTL has not yet when it does
+//   not, so both run the whole stream at their own speed and report their
+//   own IPC even after the first divergence
+// - DMA goes to both models on the same cycle (full-register writes)
+// - RTL is the Verilator --cc class; only its port members are used, so
+//   this header needs no Verilator include
+// - The RTL has no RED_XL state or permute crossbar: the model must run
+//   the RTL timing (lane_timing_t all zero, see rtl_timing())
+template<class CFG, class RTL>
+struct hp_vpu_cosim_t : sc_module {
+    typedef vreg<CFG::DLEN> vreg_t;
+    typedef hp_vpu_top_t<CFG> top_t;
+
+    enum field_e {
+        CF_READY = 0, CF_D, CF_OF, CF_E1, CF_E1M, CF_E2, CF_E3, CF_RED, CF_WIDE, CF_R3, CF_W2,
+        CF_STALL_DEC, CF_MUL_STALL, CF_MC_BUSY, CF_WB, CF_WB_VD, CF_WB_ID, CF_WB_DATA,
+        CF_COUNT
+    };
+
+    static const char* field_name(int f) {
+        static const char* names[CF_COUNT] = {
+            "ready", "d", "of", "e1", "e1m", "e2", "e3", "red", "wide", "r3", "w2",
+            "stall_dec", "mul_stall", "mc_busy", "wb", "wb_vd", "wb_id", "wb_data"
+        };
+        return (f >= 0 && f < CF_COUNT) ? names[f] : "?";
+    }
+
+    // One model's pre-edge state (f[CF_WB_DATA] unused, see wb_data)
+    struct frame_t {
+        uint64_t cycle;
+        uint32_t f[CF_COUNT];
+        vreg_t wb_data;
+    };
+
+    // Throughput of one model over the stream
+    struct side_t {
+        uint64_t accepted;    // Issue handshakes
+        uint64_t writebacks;  // Lanes results (uops)
+        uint64_t first_issue; // Cycle of the first handshake
+        uint64_t last_wb;     // Cycle of the last writeback
+
+        uint64_t cycles() const { return accepted && last_wb >= first_issue ? last_wb - first_issue + 1 : 0; }
+        double ipc() const { return cycles() ? (double)accepted / cycles() : 0.0; }
+    };
+
+    sc_in<bool> clk;
+
+    top_t* top;
+    RTL* rtl;
+
+    uint32_t ignore;    // Bit per field_e not compared
+    int history;        // Frames of context printed at the first divergence
+    int max_reports;    // Divergent cycles printed after the first
+    uint64_t max_diffs; // sc_pause() after this many divergent cycles (0 = never)
+
+    // Results
+    uint64_t cycles;          // Compared cycles
+    uint64_t diff_cycles;     // Cycles with at least one differing field
+    uint64_t field_diffs[CF_COUNT];
+    uint64_t first_diff;      // Cycle of the first divergence (valid if diff_cycles)
+    uint64_t dma_not_ready;   // DMA writes RTL did not accept
+    bool halted;              // Stopped at max_diffs
+    side_t sc, rt;
+
+    // "wb_data,red": exclude fields from the comparison
+    bool set_ignore(const std::string& csv) {
+        size_t p = 0;
+        while (p <= csv.size()) {
+            size_t e = csv.find(',', p);
+            if (e == std::string::npos) e = csv.size();
+            std::string name = csv.substr(p, e - p);
+            if (!name.empty()) {
+                int f = 0;
+                while (f < CF_COUNT && name != field_name(f)) f++;
+                if (f == CF_COUNT) return false;
+                ignore |= 1u << f;
+            }
+            p = e + 1;
+        }
+        return true;
+    }
+
+    // RTL has taken every instruction SystemC has and drained
+    bool rtl_idle() const { return q.empty() && !ahead && !rtl->busy_o && !rtl->p_wb_valid_o; }
+
+    bool clean() const { return diff_cycles == 0 && dma_not_ready == 0; }
+
+    // Lanes timed as the RTL; the red/e2/e3/wb fields are meaningless otherwise
+    bool rtl_timing() const { return top->u_lanes->timing.red_level_lat == 0 && top->u_lanes->timing.xbar_lat == 0; }
+
+    // IPC difference relative to RTL (1.0 when RTL retired nothing)
+    double ipc_delta() const {
+        if (rt.ipc() > 0) return (sc.ipc() - rt.ipc()) / rt.ipc();
+        return sc.ipc() > 0 ? 1.0 : 0.0;
+    }
+
+    void report(std::ostream& os) const {
+        os << "[COSIM] " << cycles << " cycles compared, " << diff_cycles << " divergent";
+        if (diff_cycles) os << " (first at cycle " << first_diff << ")";
+        os << std::endl;
+        if (diff_cycles) {
+            os << "[COSIM] Divergent cycles per field:";
+            for (int f = 0; f < CF_COUNT; f++)
+                if (field_diffs[f]) os << " " << field_name(f) << "=" << field_diffs[f];
+            os << std::endl;
+        }
+        if (dma_not_ready) os << "[COSIM] DMA writes not accepted by RTL: " << dma_not_ready << std::endl;
+        side_line(os, "SC ", sc);
+        side_line(os, "RTL", rt);
+        os << "[COSIM] IPC delta (SC vs RTL): " << std::fixed << std::setprecision(2) << ipc_delta() * 100.0
+           << "%" << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+
+    void on_clk() {
+        if (!clk.read()) {
+            rtl->clk = 0;
+            rtl->rst_n = top->rst_n.read();
+            rtl->eval();
+            return;
+        }
+        drive();
+        rtl->eval();
+        if (top->rst_n.read() && !halted) sample();
+        rtl->clk = 1;
+        rtl->eval();
+    }
+
+    SC_HAS_PROCESS(hp_vpu_cosim_t);
+    hp_vpu_cosim_t(sc_module_name name, top_t* t, RTL* r) : sc_module(name) {
+        top = t;
+        rtl = r;
+        ignore = 0;
+        history = 16;
+        max_reports = 10;
+        max_diffs = 0;
+        cycles = diff_cycles = first_diff = dma_not_ready = 0;
+        for (int f = 0; f < CF_COUNT; f++) field_diffs[f] = 0;
+        halted = false;
+        std::memset(&sc, 0, sizeof(sc));
+        std::memset(&rt, 0, sizeof(rt));
+        ahead = false;
+        reports = 0;
+        rtl->clk = 0;
+        rtl->rst_n = 0;
+        rtl->x_issue_valid_i = 0;
+        rtl->dma_we_i = 0;
+        rtl->eval();
+        SC_METHOD(on_clk);
+        sensitive << clk;
+        dont_initialize();
+    }
+
+private:
+    std::deque<cvxif_issue_t> q; // Accepted by SystemC, not yet by RTL
+    bool ahead;                  // RTL took the instruction SystemC still presents
+    std::deque<frame_t> hist_sc, hist_rt;
+    int reports;
+
+    // Verilated ports: QData (an integer type, not always uint64_t) up to
+    // 64 bits, VlWide or WData[] (32-bit words) above. Every compiled-in
+    // CFG is instantiated against the one RTL width; only the low
+    // min(port, DLEN) bits are moved.
+    template<class W> static int words(const W& p) {
+        int n = (int)(sizeof(p) / sizeof(p[0]));
+        return n < CFG::DLEN / 32 ? n : CFG::DLEN / 32;
+    }
+    template<class W> static void put(W& p, const vreg_t& v) {
+        if constexpr (std::is_integral<W>::value) {
+            p = (W)v.w[0];
+        } else {
+            for (int i = 0; i < words(p); i++) p[i] = (uint32_t)(v.w[i >> 1] >> ((i & 1) * 32));
+        }
+    }
+    template<class W> static vreg_t get(const W& p) {
+        vreg_t v;
+        if constexpr (std::is_integral<W>::value) {
+            v.w[0] = (uint64_t)p;
+        } else {
+            for (int i = 0; i < words(p); i++) v.w[i >> 1] |= (uint64_t)(uint32_t)p[i] << ((i & 1) * 32);
+        }
+        return v;
+    }
+
+    // Pins for the coming edge; issue from the queue while RTL lags
+    void drive() {
+        const top_t& t = *top;
+        rtl->clk = 0;
+        rtl->rst_n = t.rst_n.read();
+        rtl->csr_vtype_i = t.csr_vtype_i.read().to_uint();
+        rtl->csr_vl_i = t.csr_vl_i.read().to_uint();
+        rtl->dma_we_i = t.dma_we_i.read();
+        rtl->dma_addr_i = t.dma_addr_i.read().to_uint();
+        put(rtl->dma_wdata_i, t.dma_wdata_i.read());
+        if (!q.empty()) {
+            present(true, q.front());
+        } else if (ahead) {
+            rtl->x_issue_valid_i = 0;
+        } else {
+            cvxif_issue_t p = pins();
+            present(t.x_issue_valid_i.read(), p);
+        }
+    }
+
+    void present(bool valid, const cvxif_issue_t& i) {
+        rtl->x_issue_valid_i = valid;
+        rtl->x_issue_instr_i = i.instr;
+        rtl->x_issue_id_i = i.id;
+        rtl->x_issue_rs1_i = i.rs1;
+        rtl->x_issue_rs2_i = i.rs2;
+    }
+
+    cvxif_issue_t pins() const {
+        cvxif_issue_t p;
+        p.instr = top->x_issue_instr_i.read().to_uint();
+        p.id = top->x_issue_id_i.read().to_uint();
+        p.rs1 = top->x_issue_rs1_i.read().to_uint();
+        p.rs2 = top->x_issue_rs2_i.read().to_uint();
+        return p;
+    }
+
+    void sample() {
+        const top_t& t = *top;
+        uint64_t c = cycles++;
+        frame_t s, r;
+        s.cycle = r.cycle = c;
+        s.f[CF_READY] = t.x_issue_ready_o.read();
+        s.f[CF_D] = t.dec_valid.read();
+        s.f[CF_OF] = t.of_valid.read();
+        s.f[CF_E1] = t.u_lanes->e1_valid.read();
+        s.f[CF_E1M] = t.u_lanes->e1m_valid.read();
+        s.f[CF_E2] = t.u_lanes->e2_valid.read();
+        s.f[CF_E3] = t.u_lanes->e3_valid.read();
+        s.f[CF_RED] = t.u_lanes->red_state.read();
+        s.f[CF_WIDE] = t.u_lanes->wide_state.read();
+        s.f[CF_R3] = t.u_lanes->r3_valid.read();
+        s.f[CF_W2] = t.u_lanes->w2_valid.read();
+        s.f[CF_STALL_DEC] = t.hazard_stall.read();
+        s.f[CF_MUL_STALL] = t.s_mul_stall.read();
+        s.f[CF_MC_BUSY] = t.s_multicycle_busy.read();
+        s.f[CF_WB] = t.s_valid_o.read();
+        s.f[CF_WB_VD] = t.s_vd_o.read().to_uint();
+        s.f[CF_WB_ID] = t.s_id_o.read().to_uint();
+        s.f[CF_WB_DATA] = 0;
+        s.wb_data = t.s_result_o.read();
+
+        const RTL& v = *rtl;
+        r.f[CF_READY] = v.x_issue_ready_o;
+        r.f[CF_D] = v.p_d_valid_o;
+        r.f[CF_OF] = v.p_of_valid_o;
+        r.f[CF_E1] = v.p_e1_valid_o;
+        r.f[CF_E1M] = v.p_e1m_valid_o;
+        r.f[CF_E2] = v.p_e2_valid_o;
+        r.f[CF_E3] = v.p_e3_valid_o;
+        r.f[CF_RED] = v.p_red_state_o;
+        r.f[CF_WIDE] = v.p_wide_state_o;
+        r.f[CF_R3] = v.p_r3_valid_o;
+        r.f[CF_W2] = v.p_w2_valid_o;
+        r.f[CF_STALL_DEC] = v.p_stall_dec_o;
+        r.f[CF_MUL_STALL] = v.p_mul_stall_o;
+        r.f[CF_MC_BUSY] = v.p_multicycle_busy_o;
+        r.f[CF_WB] = v.p_wb_valid_o;
+        r.f[CF_WB_VD] = v.p_wb_vd_o;
+        r.f[CF_WB_ID] = v.p_wb_id_o;
+        r.f[CF_WB_DATA] = 0;
+        r.wb_data = get(v.p_wb_data_o);
+
+        if (t.dma_we_i.read() && !v.dma_ready_o) dma_not_ready++;
+
+        // Throughput, then the elastic issue queue
+        bool sc_acc = t.x_issue_valid_i.read() && s.f[CF_READY];
+        bool rt_acc = v.x_issue_valid_i && r.f[CF_READY];
+        account(sc, sc_acc, s.f[CF_WB], c);
+        account(rt, rt_acc, r.f[CF_WB], c);
+        if (!q.empty()) {
+            if (rt_acc) q.pop_front();
+            if (sc_acc) q.push_back(pins());
+        } else if (ahead) {
+            if (sc_acc) ahead = false;
+        } else if (rt_acc && !sc_acc) {
+            ahead = true;
+        } else if (sc_acc && !rt_acc) {
+            q.push_back(pins());
+        }
+
+        keep(hist_sc, s);
+        keep(hist_rt, r);
+        uint32_t diff = compare(s, r);
+        if (!diff) return;
+        diff_cycles++;
+        for (int f = 0; f < CF_COUNT; f++)
+            if (diff & (1u << f)) field_diffs[f]++;
+        if (diff_cycles == 1) {
+            first_diff = c;
+            first_report(diff, s, r);
+        } else if (reports++ < max_reports) {
+            cout << "[COSIM] cycle " << c << " differs:";
+            for (int f = 0; f < CF_COUNT; f++)
+                if (diff & (1u << f)) cout << " " << field_name(f);
+            cout << endl;
+        }
+        if (max_diffs && diff_cycles >= max_diffs) {
+            halted = true;
+            cout << "[COSIM] Stopping after " << diff_cycles << " divergent cycles" << endl;
+            sc_pause();
+        }
+    }
+
+    static void account(side_t& m, bool accepted, bool wb, uint64_t c) {
+        if (accepted) {
+            if (!m.accepted) m.first_issue = c;
+            m.accepted++;
+        }
+        if (wb) {
+            m.writebacks++;
+            m.last_wb = c;
+        }
+    }
+
+    uint32_t compare(const frame_t& s, const frame_t& r) const {
+        uint32_t d = 0;
+        for (int f = 0; f < CF_WB_VD; f++)
+            if (s.f[f] != r.f[f]) d |= 1u << f;
+        // Result fields only mean something when both write back
+        if (s.f[CF_WB] && r.f[CF_WB]) {
+            if (s.f[CF_WB_VD] != r.f[CF_WB_VD]) d |= 1u << CF_WB_VD;
+            if (s.f[CF_WB_ID] != r.f[CF_WB_ID]) d |= 1u << CF_WB_ID;
+            if (!(s.wb_data == r.wb_data)) d |= 1u << CF_WB_DATA;
+        }
+        return d & ~ignore;
+    }
+
+    void keep(std::deque<frame_t>& h, const frame_t& f) {
+        h.push_back(f);
+        while ((int)h.size() > history + 1) h.pop_front();
+    }
+
+    void first_report(uint32_t diff, const frame_t& s, const frame_t& r) const {
+        cout << "[COSIM] First divergence at cycle " << s.cycle << " (" << sc_time_stamp() << "):" << endl;
+        for (int f = 0; f < CF_COUNT; f++) {
+            if (!(diff & (1u << f))) continue;
+            if (f == CF_WB_DATA) {
+                cout << "[COSIM]   wb_data SC  " << s.wb_data << endl;
+                cout << "[COSIM]   wb_data RTL " << r.wb_data << endl;
+            } else {
+                cout << "[COSIM]   " << field_name(f) << ": SC=" << s.f[f] << " RTL=" << r.f[f] << endl;
+            }
+        }
+        cout << "[COSIM] " << std::setw(8) << "cycle" << " model";
+        for (int f = 0; f < CF_WB_DATA; f++) cout << " " << field_name(f);
+        cout << endl;
+        for (size_t i = 0; i < hist_sc.size(); i++) {
+            row("SC ", hist_sc[i]);
+            row("RTL", hist_rt[i]);
+        }
+    }
+
+    static void row(const char* model, const frame_t& fr) {
+        cout << "[COSIM] " << std::setw(8) << fr.cycle << " " << model << "  ";
+        for (int f = 0; f < CF_WB_DATA; f++) cout << " " << std::setw(strlen(field_name(f))) << fr.f[f];
+        cout << endl;
+    }
+
+    static void side_line(std::ostream& os, const char* model, const side_t& m) {
+        os << "[COSIM] " << model << ": " << m.accepted << " issued, " << m.writebacks << " writebacks, "
+           << m.cycles() << " cycles, IPC " << m.ipc() << std::endl;
+    }
+};
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_COSIM_H
@@ -164,124 +164,116 @@ void hp_vpu_decode::decode_combinational(
     }
 }
 
+void decode_cache::fill(decoded_uop_t& e, uint32_t instr, uint32_t vtype) {
+    sc_uint<32> bits = instr;
+    hp_vpu_decode::decode_combinational(bits, e.op, e.vd, e.vs1, e.vs2, e.vm, e.is_vx, e.imm);
+    e.uclass = uop_class_of(e.op);
+    e.unit = exec_unit_of(e.op);
+    e.is_opivi = (bits(14, 12) == OPIVI);
+
+    // Register increments for the next uop, as the LMUL sequencer applies them
+    bool is_red = (e.uclass == UC_RED);
+    if (!is_red) bits(11, 7) = e.vd + 1;
+    bits(24, 20) = e.vs2 + 1;
+    if (!e.is_vx && !is_red) bits(19, 15) = e.vs1 + 1;
+    e.next_instr = bits.to_uint();
+
+    e.instr = instr;
+    e.vtype = vtype;
+    e.tag_valid = true;
+}
+
 void hp_vpu_decode::decode_pipeline() {
-    // Reset
-    d1_valid.write(false);
-    d1_instr.write(0);
-    d1_id.write(0);
-    d1_rs1.write(0);
-    d1_rs2.write(0);
-    current_sew.write(SEW_8);
-    current_lmul.write(0); // 0=LMUL1
-    uop_counter.write(0);
-    in_multicycle_seq.write(false);
-
-    wait();
-
-    while(true) {
-        // vtype shadow update (always happening from CSR)
-        sc_uint<32> vtype = csr_vtype_i.read();
-        sew_e sew = (sew_e)(int)vtype(5, 3);
-        int lmul = (int)vtype(2, 0); // 000=1, 001=2, 010=4, 011=8, etc.
-
-        current_sew.write((int)sew);
-        current_lmul.write(lmul);
-
-        // Pipeline stall handling
-        if (!stall_i.read()) {
-            if (in_multicycle_seq.read()) {
-                // Sequencer Active: Generate next micro-op
-                int cnt = uop_counter.read() + 1;
-                uop_counter.write(cnt);
-                int total = uop_total.read();
-
-                if (cnt >= total - 1) {
-                    in_multicycle_seq.write(false);
-                }
+    HP_VPU_PROF_SCOPE(PROF_DECODE_PIPELINE);
+    if (!rst_n.read()) {
+        // Reset
+        d1_valid.write(false);
+        d1_instr.write(0);
+        d1_id.write(0);
+        d1_rs1.write(0);
+        d1_rs2.write(0);
+        current_sew.write(SEW_8);
+        current_lmul.write(0); // 0=LMUL1
+        uop_counter.write(0);
+        in_multicycle_seq.write(false);
+        return;
+    }
 
-                // Generate new instruction bits based on current d1_instr
-                sc_uint<32> instr = d1_instr.read();
+    // vtype shadow update (always happening from CSR)
+    sc_uint<32> vtype = csr_vtype_i.read();
+    sew_e sew = (sew_e)(int)vtype(5, 3);
+    int lmul = (int)vtype(2, 0); // 000=1, 001=2, 010=4, 011=8, etc.
 
-                // Decode to check op type for increment logic
-                vpu_op_e op; sc_uint<5> vd, vs1, vs2; bool vm, is_vx; sc_uint<32> imm;
-                decode_combinational(instr, op, vd, vs1, vs2, vm, is_vx, imm);
+    current_sew.write((int)sew);
+    current_lmul.write(lmul);
 
-                bool is_red = (op >= OP_VREDSUM && op <= OP_VREDMAX);
+    // Pipeline stall handling
+    if (!stall_i.read()) {
+        if (in_multicycle_seq.read()) {
+            // Sequencer Active: Generate next micro-op
+            int cnt = uop_counter.read() + 1;
+            uop_counter.write(cnt);
+            int total = uop_total.read();
 
-                // Increment VD if not reduction
-                if (!is_red) {
-                    instr(11, 7) = vd + 1;
-                }
+            if (cnt >= total - 1) {
+                in_multicycle_seq.write(false);
+            }
 
-                // Increment VS2 (Accumulator or Source 2)
-                instr(24, 20) = vs2 + 1;
+            // Next uop word: VD +1 unless reduction, VS2 +1, VS1 +1 for
+            // .vv non-reductions (precomputed in the decode cache entry)
+            const decoded_uop_t& d = dcache.lookup(d1_instr.read().to_uint(), vtype_key());
 
-                // Increment VS1 if vector (.vv) and not reduction init
-                if (!is_vx && !is_red) {
-                    instr(19, 15) = vs1 + 1;
-                }
+            d1_instr.write(d.next_instr);
+            d1_valid.write(true);
 
-                d1_instr.write(instr);
+        } else {
+            // Idle: Accept new instruction
+            if (valid_i.read()) {
                 d1_valid.write(true);
-
-            } else {
-                // Idle: Accept new instruction
-                if (valid_i.read()) {
-                    d1_valid.write(true);
-                    d1_instr.write(instr_i.read());
-                    d1_id.write(id_i.read());
-                    d1_rs1.write(rs1_i.read());
-                    d1_rs2.write(rs2_i.read());
-
-                    // Initialize Sequencer
-                    int uops = 1 << lmul; // 1, 2, 4, 8
-                    uop_total.write(uops);
-                    uop_counter.write(0);
-
-                    if (uops > 1) {
-                        in_multicycle_seq.write(true);
-                    }
-                } else {
-                    d1_valid.write(false);
+                d1_instr.write(instr_i.read());
+                d1_id.write(id_i.read());
+                d1_rs1.write(rs1_i.read());
+                d1_rs2.write(rs2_i.read());
+
+                // Initialize Sequencer
+                int uops = 1 << lmul; // 1, 2, 4, 8
+                uop_total.write(uops);
+                uop_counter.write(0);
+
+                if (uops > 1) {
+                    in_multicycle_seq.write(true);
                 }
+            } else {
+                d1_valid.write(false);
             }
         }
-
-        wait();
     }
 }
 
 void hp_vpu_decode::output_logic() {
-    // D2 Combinational Decode logic using D1 registers
-    vpu_op_e op;
-    sc_uint<5> vd, vs1, vs2;
-    bool vm, is_vx;
-    sc_uint<32> imm;
-
-    decode_combinational(d1_instr.read(), op, vd, vs1, vs2, vm, is_vx, imm);
+    HP_VPU_PROF_SCOPE(PROF_DECODE_OUTPUT);
+    // D2 Combinational Decode logic using D1 registers (cached per word/vtype)
+    const decoded_uop_t& d = dcache.lookup(d1_instr.read().to_uint(), vtype_key());
 
     // Outputs
     valid_o.write(d1_valid.read());
-    op_o.write(op);
-    vd_o.write(vd);
-    vs1_o.write(vs1);
-    vs2_o.write(vs2);
+    op_o.write(d.op);
+    // Precomputed routing so the lanes never re-derive it from the opcode
+    uclass_o.write(d.uclass);
+    unit_o.write(d.unit);
+    vd_o.write(d.vd);
+    vs1_o.write(d.vs1);
+    vs2_o.write(d.vs2);
     // Accumulator handling (vs3):
     // For MAC ops, vs3 is the old vd. For mask/vmv ops, it might be old_vd too.
-    vs3_o.write(vd);
+    vs3_o.write(d.vd);
 
-    vm_o.write(vm);
-    is_vx_o.write(is_vx);
+    vm_o.write(d.vm);
+    is_vx_o.write(d.is_vx);
 
-    // Scalar mux: immediate vs rs1
-    if (is_vx) {
-        // Check if instruction uses immediate (OPIVI)
-        sc_uint<3> funct3 = d1_instr.read()(14, 12);
-        if (funct3 == 0b011) { // OPIVI
-            scalar_o.write(imm);
-        } else {
-            scalar_o.write(d1_rs1.read());
-        }
+    // Scalar mux: immediate (OPIVI) vs rs1
+    if (d.is_vx) {
+        scalar_o.write(d.is_opivi ? d.imm : d1_rs1.read());
     } else {
         scalar_o.write(0);
     }
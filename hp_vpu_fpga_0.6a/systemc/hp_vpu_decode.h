@@ -3,9 +3,78 @@
 
 #include <systemc.h>
 #include "hp_vpu_pkg.h"
+#include "hp_vpu_prof.h"
 
 namespace hp_vpu {
 
+// Pre-decoded instruction word (one decode_cache entry)
+struct decoded_uop_t {
+    uint32_t instr;      // Tag: instruction word
+    uint32_t vtype;      // Tag: vtype CSR value (sew/lmul)
+    bool tag_valid;
+
+    vpu_op_e op;
+    uop_class_e uclass;
+    exec_unit_e unit;
+    sc_uint<5> vd, vs1, vs2;
+    bool vm;
+    bool is_vx;
+    bool is_opivi;       // Scalar comes from imm, not rs1
+    sc_uint<32> imm;
+    uint32_t next_instr; // Next LMUL uop (register fields incremented)
+};
+
+// Direct-mapped decode cache keyed by (instruction word, vtype)
+// Kernels reuse a handful of instruction words, so after the first pass
+// decode is one hashed index and a tag compare.
+class decode_cache {
+public:
+    static const int BITS = 8;
+    static const int ENTRIES = 1 << BITS;
+
+    uint64_t hits;
+    uint64_t misses;
+
+    decode_cache() { clear(); }
+
+    void clear() {
+        for (int i = 0; i < ENTRIES; i++) lines[i].tag_valid = false;
+        hits = 0;
+        misses = 0;
+    }
+
+    const decoded_uop_t& lookup(uint32_t instr, uint32_t vtype) {
+        decoded_uop_t& e = lines[index(instr, vtype)];
+        if (e.tag_valid && e.instr == instr && e.vtype == vtype) {
+            hits++;
+            return e;
+        }
+        misses++;
+        fill(e, instr, vtype);
+        return e;
+    }
+
+    double hit_rate() const {
+        uint64_t n = hits + misses;
+        return n ? (double)hits / n : 0.0;
+    }
+
+private:
+    decoded_uop_t lines[ENTRIES];
+
+    // Register fields differ by small strides across a kernel's words, so
+    // mix before taking the top bits (a plain multiply aliases them)
+    static unsigned index(uint32_t instr, uint32_t vtype) {
+        uint32_t h = instr ^ (vtype * 0x85EBCA6Bu);
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h >> (32 - BITS);
+    }
+
+    static void fill(decoded_uop_t& e, uint32_t instr, uint32_t vtype); // hp_vpu_decode.cpp
+};
+
 // v0.10: Updated Decode with 2-stage pipeline (D1->D2)
 // D1: Pre-decode, vtype/vl handling, multicycle sequencer
 // D2: Operand Fetch setup, hazard check interface
@@ -32,6 +101,8 @@ SC_MODULE(hp_vpu_decode) {
     // D2 Outputs (to Hazard Unit & Lanes)
     sc_out<bool> valid_o;
     sc_out<int>  op_o; // vpu_op_e
+    sc_out<int>  uclass_o; // uop_class_e
+    sc_out<int>  unit_o; // exec_unit_e
     sc_out<int>  sew_o; // sew_e
     sc_out<int>  lmul_o;
     sc_out<sc_uint<5>> vd_o;
@@ -63,19 +134,26 @@ SC_MODULE(hp_vpu_decode) {
     sc_signal<int> uop_total;
     sc_signal<bool> in_multicycle_seq;
 
-    void decode_pipeline();
+    // Pre-decoded D1 words (D2 outputs and the LMUL sequencer)
+    decode_cache dcache;
+
+    // vtype tag for the current shadow (same bits as csr_vtype_i[5:0])
+    uint32_t vtype_key() const { return ((uint32_t)current_sew.read() << 3) | (uint32_t)(current_lmul.read() & 7); }
+
+    void decode_pipeline(); // Clocked: one call per posedge, synchronous reset
     void output_logic();
 
-    // Helper to decode raw instruction bits
-    void decode_combinational(
+    // Helper to decode raw instruction bits (static: also used by hp_vpu_func)
+    static void decode_combinational(
         sc_uint<32> instr,
         vpu_op_e& op,
         sc_uint<5>& vd, sc_uint<5>& vs1, sc_uint<5>& vs2, bool& vm, bool& is_vx, sc_uint<32>& imm
     );
 
     SC_CTOR(hp_vpu_decode) {
-        SC_CTHREAD(decode_pipeline, clk.pos());
-        reset_signal_is(rst_n, false);
+        SC_METHOD(decode_pipeline);
+        sensitive << clk.pos();
+        dont_initialize();
 
         SC_METHOD(output_logic);
         sensitive << d1_valid << d1_instr << d1_id << d1_rs1 << d1_rs2 << current_sew << current_lmul << stall_i;
@@ -0,0 +1,375 @@
+#ifndef HP_VPU_DRIVERS_H
+#define HP_VPU_DRIVERS_H
+
+#include <systemc.h>
+#include <functional>
+#include <vector>
+#include "hp_vpu_pkg.h"
+#include "hp_vpu_vreg.h"
+#include "hp_vpu_func.h"
+
+namespace hp_vpu {
+
+// Clocked stimulus drivers for the hp_vpu_top pins
+// The host queues work in bulk from sc_main, then a single sc_start() runs
+// it: the issue driver calls sc_pause() once its queue is empty and the
+// pipeline has drained, so the kernel is entered once per batch instead of
+// once per instruction.
+//
+// The handshake is sampled at the clk posedge and the next item is
+// presented at the negedge, so the pins are stable when the IQ/VRF sample
+// them. Queuing work notifies work_ev, which restarts an idle clock.
+
+// Queue state visible to another driver (issue waits for pending DMA)
+struct hp_vpu_drv_queue {
+    sc_event work_ev; // Notified when work is queued
+    virtual ~hp_vpu_drv_queue() {}
+    virtual uint64_t pending() const = 0;
+};
+
+// Clock source with idle skipping
+// Same waveform as sc_clock (high at t = 0, an edge every period / 2). At a
+// negedge where quiet_fn() holds and work_fn() does not, it holds clk high
+// and schedules nothing, so no process runs and the kernel advances
+// straight to the next event (or to the end of sc_start). Any wake_on event
+// restarts it on the original edge grid; the posedges not delivered are
+// passed to skip_fn, so cycle counts match a free-running clock. At least
+// one posedge is delivered after each wake-up.
+// Wake-ups mid-cycle: in the high half the next edge is the due negedge. In
+// the low half the due posedge is skipped as well when stimulus is queued
+// (the drivers present at the negedge after it, so it would be empty);
+// otherwise clk falls at once and rises on the grid.
+SC_MODULE(hp_vpu_clkgen) {
+    sc_out<bool> clk_o;
+
+    bool idle_skip;                         // Enable (default on)
+    std::function<bool()> quiet_fn;         // Nothing in flight, pins at rest
+    std::function<bool()> work_fn;          // Stimulus queued
+    std::function<void(uint64_t)> skip_fn;  // Credit n posedges not delivered
+    sc_event_or_list wake_on;
+
+    uint64_t posedges; // Delivered
+    uint64_t skipped;  // Credited through skip_fn
+    bool asleep() const { return sleeping; }
+
+    // Credit the posedges of an ongoing sleep, so counters read right
+    // mid-sleep. Call from sc_main between sc_start calls.
+    void sync_idle() {
+        if (!sleeping) return;
+        uint64_t k = grid_posedges(sc_time_stamp());
+        credit(k);
+        last_pos += period * (double)k;
+    }
+
+    void tick() {
+        sc_time now = sc_time_stamp();
+        if (sleeping) {
+            resume(now);
+            return;
+        }
+        bool c = !level;
+        if (!c && idle_skip && !fresh && quiet_fn && quiet_fn() && !(work_fn && work_fn())) {
+            sleeping = true;
+            next_trigger(wake_on);
+            return;
+        }
+        level = c;
+        clk_o.write(c);
+        if (c) {
+            posedges++;
+            last_pos = now;
+            fresh = false;
+        }
+        next_trigger(half);
+    }
+
+    SC_HAS_PROCESS(hp_vpu_clkgen);
+    hp_vpu_clkgen(sc_module_name name, const sc_time& clk_period)
+        : sc_module(name), period(clk_period), half(clk_period / 2.0) {
+        idle_skip = true;
+        posedges = skipped = 0;
+        level = false;
+        sleeping = false;
+        fresh = true;
+        SC_METHOD(tick); // Runs at t = 0: first posedge
+    }
+
+private:
+    sc_time period, half;
+    sc_time last_pos; // Last posedge on the grid, delivered or credited
+    bool level;
+    bool sleeping;
+    bool fresh;       // No posedge delivered since start or wake-up
+
+    // Grid posedges in (last_pos, t]
+    uint64_t grid_posedges(const sc_time& t) const {
+        return (uint64_t)((t - last_pos) / period + 1e-9);
+    }
+
+    void credit(uint64_t n) {
+        if (!n) return;
+        skipped += n;
+        if (skip_fn) skip_fn(n);
+    }
+
+    void resume(const sc_time& now) {
+        sleeping = false;
+        fresh = true;
+        uint64_t k = grid_posedges(now);
+        sc_time p = last_pos + period * (double)k; // Latest grid posedge <= now
+        if (now - p < half) {
+            // High half: clk already reads high, fall on the grid
+            credit(k);
+            last_pos = p;
+            next_trigger(p + half - now);
+        } else if (work_fn && work_fn()) {
+            credit(k + 1);
+            last_pos = p + period;
+            next_trigger(p + period + half - now);
+        } else {
+            credit(k);
+            last_pos = p;
+            level = false;
+            clk_o.write(false);
+            next_trigger(p + period - now);
+        }
+    }
+};
+
+// CV-X-IF issue driver
+// - push(): owned queue; load(): external array (e.g. a vtrace_map), no copy
+// - One instruction per cycle while x_issue_ready_o allows
+// - Holds issue while `after` has pending entries (register preload first)
+// - pause_when_done: sc_pause() once the queue is empty and idle_fn (if set)
+//   reports an idle pipeline; gives up after timeout_cycles posedges
+SC_MODULE(hp_vpu_issue_drv), hp_vpu_drv_queue {
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+
+    sc_out<bool> valid_o;
+    sc_out<sc_uint<32>> instr_o;
+    sc_out<sc_uint<CVXIF_ID_W>> id_o;
+    sc_out<sc_uint<32>> rs1_o;
+    sc_out<sc_uint<32>> rs2_o;
+    sc_in<bool> ready_i;
+
+    bool pause_when_done;
+    std::function<bool()> idle_fn;
+    std::function<void()> mark_fn; // Called when t_mark is taken
+    const hp_vpu_drv_queue* after;
+    uint64_t timeout_cycles; // Drain bound (0 = none)
+    sc_event done_ev;
+
+    // Statistics (reset by clear_stats)
+    uint64_t issued;       // Accepted instructions
+    uint64_t stall_cycles; // Posedges with valid high and ready low
+    sc_time t_first;       // First instruction of the batch presented
+    sc_time t_mark;        // Instruction `mark` presented (see mark())
+    bool timed_out;
+
+    void push(const cvxif_issue_t* r, size_t n) {
+        if (head == count) {
+            buf.clear();
+            ext = nullptr;
+            head = count = 0;
+        } else if (ext) {
+            buf.assign(ext + head, ext + count); // Detach from the external array
+            ext = nullptr;
+            count -= head;
+            head = 0;
+        }
+        buf.insert(buf.end(), r, r + n);
+        count = buf.size();
+        arm();
+    }
+    void push(const cvxif_issue_t& r) { push(&r, 1); }
+    void push(const std::vector<cvxif_issue_t>& v) { push(v.data(), v.size()); }
+
+    // Replace the queue with an external array; must outlive the run
+    void load(const cvxif_issue_t* r, uint64_t n) {
+        buf.clear();
+        ext = r;
+        head = 0;
+        count = n;
+        arm();
+    }
+
+    // Time-stamp the k-th queued instruction (from the current head) when it
+    // is first presented: start of a measured window (t_mark)
+    void mark(uint64_t k) { mark_idx = head + k; }
+
+    uint64_t pending() const { return count - head; }
+    bool busy() const { return armed; } // Queued work or drain not yet seen
+
+    void clear_stats() {
+        issued = 0;
+        stall_cycles = 0;
+        t_first = t_mark = SC_ZERO_TIME;
+        timed_out = false;
+    }
+
+    void drive() {
+        if (clk.read()) {
+            if (!rst_n.read()) return;
+            // Posedge: did the IQ take the presented instruction?
+            if (presenting) {
+                if (ready_i.read()) {
+                    head++;
+                    issued++;
+                    presenting = false;
+                } else {
+                    stall_cycles++;
+                }
+            }
+            if (armed && head == count && pause_when_done) {
+                if (!idle_fn || idle_fn()) {
+                    finish();
+                } else if (timeout_cycles && ++drain_cycles > timeout_cycles) {
+                    timed_out = true;
+                    finish();
+                }
+            }
+            return;
+        }
+
+        // Negedge: present the head (held until accepted)
+        bool hold = after && after->pending() > 0;
+        bool v = rst_n.read() && head < count && !hold;
+        valid_o.write(v);
+        if (!v) {
+            presenting = false;
+            return;
+        }
+        const cvxif_issue_t& r = ext ? ext[head] : buf[head];
+        instr_o.write(r.instr);
+        id_o.write(r.id);
+        rs1_o.write(r.rs1);
+        rs2_o.write(r.rs2);
+        if (!presenting) {
+            if (!started) { t_first = sc_time_stamp(); started = true; }
+            if (head == mark_idx) {
+                t_mark = sc_time_stamp();
+                if (mark_fn) mark_fn();
+            }
+        }
+        presenting = true;
+    }
+
+    SC_CTOR(hp_vpu_issue_drv) {
+        pause_when_done = true;
+        after = nullptr;
+        timeout_cycles = 100000;
+        ext = nullptr;
+        head = count = 0;
+        mark_idx = 0;
+        presenting = false;
+        armed = false;
+        started = false;
+        drain_cycles = 0;
+        clear_stats();
+        SC_METHOD(drive);
+        sensitive << clk;
+        dont_initialize();
+    }
+
+private:
+    std::vector<cvxif_issue_t> buf;
+    const cvxif_issue_t* ext;
+    uint64_t head, count;
+    uint64_t mark_idx;
+    bool presenting;
+    bool armed;
+    bool started;
+    uint64_t drain_cycles;
+
+    void arm() {
+        work_ev.notify(SC_ZERO_TIME);
+        armed = true;
+        started = false;
+        drain_cycles = 0;
+        timed_out = false;
+    }
+
+    void finish() {
+        armed = false;
+        done_ev.notify(SC_ZERO_TIME);
+        sc_pause();
+    }
+};
+
+// DMA (VRF backdoor port) driver: queued register writes, one per cycle.
+// DMA has priority on the VRF write port, so queue it while the pipeline
+// is idle (the issue driver's `after` hook orders preloads before issue).
+template<class CFG>
+struct hp_vpu_dma_drv_t : sc_module, hp_vpu_drv_queue {
+    typedef vreg<CFG::DLEN> vreg_t;
+
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+
+    sc_out<bool> we_o;
+    sc_out<sc_uint<5>> addr_o;
+    sc_out<vreg_t> wdata_o;
+
+    bool pause_when_done; // Off by default: the issue driver ends the batch
+    uint64_t written;
+
+    struct item_t {
+        int reg;
+        vreg_t data;
+    };
+
+    void write(int reg, const vreg_t& data) {
+        if (head == q.size()) {
+            q.clear();
+            head = 0;
+        }
+        item_t it = { reg & 31, data };
+        q.push_back(it);
+        work_ev.notify(SC_ZERO_TIME);
+    }
+
+    uint64_t pending() const { return q.size() - head; }
+
+    void drive() {
+        if (clk.read()) {
+            if (!rst_n.read() || !presenting) return;
+            // Posedge: the VRF takes the presented write on this edge
+            head++;
+            written++;
+            presenting = false;
+            if (head == q.size() && pause_when_done) sc_pause();
+            return;
+        }
+
+        // Negedge: present the next write
+        bool v = rst_n.read() && head < q.size();
+        we_o.write(v);
+        if (!v) return;
+        addr_o.write(q[head].reg);
+        wdata_o.write(q[head].data);
+        presenting = true;
+    }
+
+    SC_HAS_PROCESS(hp_vpu_dma_drv_t);
+    hp_vpu_dma_drv_t(sc_module_name name) : sc_module(name) {
+        pause_when_done = false;
+        written = 0;
+        head = 0;
+        presenting = false;
+        SC_METHOD(drive);
+        sensitive << clk;
+        dont_initialize();
+    }
+
+private:
+    std::vector<item_t> q;
+    size_t head;
+    bool presenting;
+};
+
+typedef hp_vpu_dma_drv_t<cfg_default> hp_vpu_dma_drv;
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_DRIVERS_H
@@ -0,0 +1,296 @@
+#ifndef HP_VPU_FLIGHTREC_H
+#define HP_VPU_FLIGHTREC_H
+
+#include <systemc.h>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+#include "hp_vpu_pkg.h"
+#include "hp_vpu_vreg.h"
+#include "hp_vpu_top.h"
+
+namespace hp_vpu {
+
+// Flight recorder: ring buffer of the last `depth` cycles of pipeline state,
+// written out as a window only when a trigger fires
+// - Host triggers: trigger(why) from sc_main (golden mismatch, timeout)
+// - Predicate: called on every recorded cycle; a rising edge dumps after
+//   `post` more cycles (edge-triggered, at most max_dumps files per run)
+// - Samples at each delivered clk posedge (state of the cycle just ended);
+//   cycles skipped by the clock source are not recorded but the cycle numbers
+//   account for them
+// - Disabled (depth 0, the default) the process parks on an event, so it
+//   costs nothing per cycle
+// - Output: <prefix>_<n>.vcd (one VCD time step per cycle) or <prefix>_<n>.frec
+
+// Bits of frame_t::valid
+enum frec_stage_e {
+    FR_DEC = 0, FR_OF, FR_E1, FR_E1M, FR_E2, FR_E3, FR_R2A, FR_R2B, FR_W2, FR_WB,
+    FR_NSTAGE
+};
+enum frec_flag_e {
+    FR_ISSUE_VALID = FR_NSTAGE, // x_issue_valid_i
+    FR_ISSUE_READY,             // x_issue_ready_o
+    FR_IQ_POP,                  // IQ head presented to D
+    FR_DMA_WE,
+    FR_MUL_STALL,
+    FR_MULTICYCLE_BUSY,
+    FR_NFLAG
+};
+
+enum frec_format_e { FREC_VCD = 0, FREC_BIN };
+
+// Binary window (.frec), host byte order: header, then count frames
+// (frame_t of the recorded DLEN) oldest first
+struct frec_header_t {
+    char     magic[8]; // "HPVFLREC"
+    uint32_t version;
+    uint32_t dlen;
+    uint32_t frame_size;
+    uint32_t reserved;
+    uint64_t count;
+    char     reason[64];
+};
+
+static_assert(sizeof(frec_header_t) == 96, "frec header layout");
+
+const char FREC_MAGIC[8] = { 'H', 'P', 'V', 'F', 'L', 'R', 'E', 'C' };
+const uint32_t FREC_VERSION = 1;
+
+template<class CFG>
+struct hp_vpu_flightrec_t : sc_module {
+    static const int DLEN = CFG::DLEN;
+    typedef vreg<DLEN> vreg_t;
+    typedef hp_vpu_top_t<CFG> top_t;
+
+    // One recorded cycle
+    struct frame_t {
+        uint64_t cycle;
+        uint64_t t_ps;
+        uint32_t instr;         // IQ head (D input)
+        uint16_t valid;         // (1 << frec_stage_e) | (1 << frec_flag_e)
+        uint8_t  stall;         // stall_reason_e at D
+        uint8_t  iq_count;
+        uint8_t  dec_op, of_op; // vpu_op_e
+        uint8_t  vd[FR_NSTAGE];
+        vreg_t   wb_data;
+    };
+
+    top_t* top;
+    std::string prefix;
+    frec_format_e format;
+    std::function<bool(const frame_t&)> predicate;
+    int post;       // Cycles recorded after a predicate fires
+    int max_dumps;
+    int dumps;      // Files written so far
+
+    // depth 0 disables; may be called between sc_start calls
+    void enable(size_t depth, const std::string& file_prefix, frec_format_e fmt = FREC_VCD) {
+        ring.assign(depth, frame_t());
+        head = 0;
+        count = 0;
+        prefix = file_prefix;
+        format = fmt;
+        pred_level = false;
+        post_left = -1;
+        if (depth && parked) arm_ev.notify(SC_ZERO_TIME);
+    }
+
+    bool enabled() const { return !ring.empty(); }
+
+    // Dump the current window now. Returns the file written ("" if none).
+    std::string trigger(const std::string& why) {
+        if (ring.empty() || count == 0 || dumps >= max_dumps) return "";
+        std::string path = prefix + "_" + std::to_string(dumps) + (format == FREC_VCD ? ".vcd" : ".frec");
+        bool ok = (format == FREC_VCD) ? write_vcd(path, why) : write_bin(path, why);
+        if (!ok) {
+            SC_REPORT_WARNING("hp_vpu_flightrec", ("cannot write " + path).c_str());
+            return "";
+        }
+        dumps++;
+        cout << "[FREC] " << why << ": " << count << " cycles -> " << path << endl;
+        return path;
+    }
+
+    void sample() {
+        if (ring.empty()) {
+            parked = true;
+            next_trigger(arm_ev);
+            return;
+        }
+        if (parked) {
+            parked = false;
+            next_trigger(); // Back to the static sensitivity (clk posedge)
+            return;
+        }
+
+        frame_t& f = ring[head];
+        capture(f);
+        head = (head + 1 == ring.size()) ? 0 : head + 1;
+        if (count < ring.size()) count++;
+
+        if (predicate) {
+            bool level = predicate(f);
+            if (level && !pred_level && post_left < 0) post_left = post;
+            pred_level = level;
+        }
+        if (post_left >= 0 && post_left-- == 0) trigger("predicate at cycle " + std::to_string(f.cycle - post));
+    }
+
+    SC_HAS_PROCESS(hp_vpu_flightrec_t);
+    hp_vpu_flightrec_t(sc_module_name name, top_t* t) : sc_module(name) {
+        top = t;
+        format = FREC_VCD;
+        post = 0;
+        max_dumps = 8;
+        dumps = 0;
+        head = 0;
+        count = 0;
+        parked = false;
+        pred_level = false;
+        post_left = -1;
+        SC_METHOD(sample);
+        sensitive << top->clk.pos();
+        dont_initialize();
+    }
+
+private:
+    std::vector<frame_t> ring;
+    size_t head;
+    size_t count;
+    bool parked;
+    bool pred_level;
+    int post_left; // Cycles until the pending predicate dump (-1 = none)
+    sc_event arm_ev;
+
+    void capture(frame_t& f) {
+        const top_t& t = *top;
+        f.cycle = t.cycle_count();
+        f.t_ps = (uint64_t)(sc_time_stamp().to_seconds() * 1e12 + 0.5);
+        f.instr = t.iq_pop_instr.read().to_uint();
+        f.stall = (uint8_t)t.hazard_reason.read();
+        f.iq_count = (uint8_t)t.u_iq->count.read();
+        f.dec_op = (uint8_t)t.dec_op.read();
+        f.of_op = (uint8_t)t.of_op.read();
+
+        bool v[FR_NFLAG] = {
+            t.dec_valid.read(), t.of_valid.read(), t.h_e1_valid.read(), t.h_e1m_valid.read(),
+            t.h_e2_valid.read(), t.h_e3_valid.read(), t.h_r2a_valid.read(), t.h_r2b_valid.read(),
+            t.h_w2_valid.read(), t.s_valid_o.read(),
+            t.x_issue_valid_i.read(), t.x_issue_ready_o.read(), t.iq_pop_valid.read(), t.dma_we_i.read(),
+            t.s_mul_stall.read(), t.s_multicycle_busy.read()
+        };
+        f.valid = 0;
+        for (int i = 0; i < FR_NFLAG; i++) f.valid |= (uint16_t)v[i] << i;
+
+        f.vd[FR_DEC] = t.dec_vd.read().to_uint();
+        f.vd[FR_OF]  = t.of_vd.read().to_uint();
+        f.vd[FR_E1]  = t.h_e1_vd.read().to_uint();
+        f.vd[FR_E1M] = t.h_e1m_vd.read().to_uint();
+        f.vd[FR_E2]  = t.h_e2_vd.read().to_uint();
+        f.vd[FR_E3]  = t.h_e3_vd.read().to_uint();
+        f.vd[FR_R2A] = t.h_r2a_vd.read().to_uint();
+        f.vd[FR_R2B] = t.h_r2b_vd.read().to_uint();
+        f.vd[FR_W2]  = t.h_w2_vd.read().to_uint();
+        f.vd[FR_WB]  = t.s_vd_o.read().to_uint();
+        f.wb_data = t.s_result_o.read();
+    }
+
+    // Window frames, oldest first
+    const frame_t& at(size_t i) const {
+        size_t first = (count < ring.size()) ? 0 : head;
+        return ring[(first + i) % ring.size()];
+    }
+
+    bool write_bin(const std::string& path, const std::string& why) const {
+        FILE* fp = fopen(path.c_str(), "wb");
+        if (!fp) return false;
+        frec_header_t h = {};
+        memcpy(h.magic, FREC_MAGIC, sizeof(h.magic));
+        h.version = FREC_VERSION;
+        h.dlen = DLEN;
+        h.frame_size = sizeof(frame_t);
+        h.count = count;
+        strncpy(h.reason, why.c_str(), sizeof(h.reason) - 1);
+        bool ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+        for (size_t i = 0; ok && i < count; i++) ok = fwrite(&at(i), sizeof(frame_t), 1, fp) == 1;
+        return (fclose(fp) == 0) && ok;
+    }
+
+    // VCD with one time step per recorded cycle (time in ps); only changed
+    // values are written
+    bool write_vcd(const std::string& path, const std::string& why) const {
+        static const char* stage[FR_NSTAGE] = { "dec", "of", "e1", "e1m", "e2", "e3", "r2a", "r2b", "w2", "wb" };
+        static const char* flag[FR_NFLAG - FR_NSTAGE] = { "issue_valid", "issue_ready", "iq_pop_valid",
+                                                          "dma_we", "mul_stall", "multicycle_busy" };
+        FILE* fp = fopen(path.c_str(), "w");
+        if (!fp) return false;
+
+        struct var_t { std::string name; int width; };
+        std::vector<var_t> vars;
+        vars.push_back({ "cycle", 64 });
+        vars.push_back({ "instr", 32 });
+        vars.push_back({ "iq_count", 8 });
+        vars.push_back({ "stall_reason", 8 });
+        vars.push_back({ "dec_op", 8 });
+        vars.push_back({ "of_op", 8 });
+        for (int i = 0; i < FR_NSTAGE; i++) vars.push_back({ std::string(stage[i]) + "_valid", 1 });
+        for (int i = 0; i < FR_NFLAG - FR_NSTAGE; i++) vars.push_back({ flag[i], 1 });
+        for (int i = 0; i < FR_NSTAGE; i++) vars.push_back({ std::string(stage[i]) + "_vd", 5 });
+        vars.push_back({ "wb_data", DLEN });
+
+        fprintf(fp, "$comment hp_vpu flight recorder: %s $end\n", why.c_str());
+        fprintf(fp, "$timescale 1ps $end\n$scope module vpu $end\n");
+        for (size_t k = 0; k < vars.size(); k++)
+            fprintf(fp, "$var wire %d %s %s $end\n", vars[k].width, vcd_id(k).c_str(), vars[k].name.c_str());
+        fprintf(fp, "$upscope $end\n$enddefinitions $end\n");
+
+        std::vector<std::string> last(vars.size());
+        std::string val;
+        for (size_t i = 0; i < count; i++) {
+            const frame_t& f = at(i);
+            fprintf(fp, "#%llu\n", (unsigned long long)f.t_ps);
+            size_t k = 0;
+            auto emit = [&](const std::string& v) {
+                if (v != last[k]) {
+                    if (vars[k].width == 1) fprintf(fp, "%s%s\n", v.c_str(), vcd_id(k).c_str());
+                    else fprintf(fp, "b%s %s\n", v.c_str(), vcd_id(k).c_str());
+                    last[k] = v;
+                }
+                k++;
+            };
+            emit(bits(f.cycle, 64));
+            emit(bits(f.instr, 32));
+            emit(bits(f.iq_count, 8));
+            emit(bits(f.stall, 8));
+            emit(bits(f.dec_op, 8));
+            emit(bits(f.of_op, 8));
+            for (int b = 0; b < FR_NFLAG; b++) emit(((f.valid >> b) & 1) ? "1" : "0");
+            for (int s = 0; s < FR_NSTAGE; s++) emit(bits(f.vd[s], 5));
+            val.clear();
+            for (int w = vreg_t::NWORDS - 1; w >= 0; w--) val += bits(f.wb_data.w[w], DLEN - w * 64 < 64 ? DLEN - w * 64 : 64);
+            emit(val);
+        }
+        return fclose(fp) == 0;
+    }
+
+    static std::string vcd_id(size_t k) {
+        std::string s;
+        do { s += (char)('!' + k % 94); k /= 94; } while (k);
+        return s;
+    }
+
+    static std::string bits(uint64_t v, int n) {
+        std::string s(n, '0');
+        for (int i = 0; i < n; i++) if ((v >> i) & 1) s[n - 1 - i] = '1';
+        return s;
+    }
+};
+
+typedef hp_vpu_flightrec_t<cfg_default> hp_vpu_flightrec;
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_FLIGHTREC_H
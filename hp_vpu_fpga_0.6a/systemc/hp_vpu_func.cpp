@@ -0,0 +1,119 @@
+#include "hp_vpu_func.h"
+#include "hp_vpu_decode.h"
+#include "hp_vpu_lanes.h"
+#include <cstring>
+
+namespace hp_vpu {
+
+template<class CFG>
+void hp_vpu_func_t<CFG>::execute(const cvxif_issue_t& req) {
+    sc_uint<32> vt = vtype;
+    sew_e sew = (sew_e)(int)vt(5, 3);
+    int lmul = (int)vt(2, 0);
+    int total = 1 << lmul; // Same uop count as the decode sequencer
+
+    // Next uop: same register increments as hp_vpu_decode::decode_pipeline
+    uint32_t instr = req.instr;
+    uint32_t vt_key = vtype & 0x3F;
+    for (int u = 0; u < total; u++) {
+        const decoded_uop_t& d = dcache.lookup(instr, vt_key);
+        execute_uop(d, req.rs1, sew);
+        instr = d.next_instr;
+    }
+    instret++;
+}
+
+template<class CFG>
+void hp_vpu_func_t<CFG>::execute_uop(const decoded_uop_t& d, sc_uint<32> rs1, sew_e sew) {
+    vpu_op_e op = d.op;
+    sc_uint<5> vd = d.vd, vs1 = d.vs1, vs2 = d.vs2;
+    bool vm = d.vm, is_vx = d.is_vx;
+
+    // Scalar mux: immediate (OPIVI) vs rs1, as in decode output_logic
+    sc_uint<32> scalar = 0;
+    if (is_vx) scalar = d.is_opivi ? d.imm : rs1;
+
+    // Operands: vs3 is the old vd, mask is always v0
+    const vreg_t& v1 = vrf->peek(vs1);
+    const vreg_t& v2 = vrf->peek(vs2);
+    const vreg_t& v3 = vrf->peek(vd);
+    const vreg_t& vmask = vrf->peek(0);
+
+    typedef hp_vpu_lanes_t<CFG> lanes;
+    uop_class_e uc = d.uclass;
+    vreg_t res;
+
+    if (uc == UC_RED) {
+        res = lanes::exec_reduction(op, sew, v2, v1);
+    } else if (uc == UC_WIDE) {
+        vreg_t src2;
+        if (is_vx) src2.broadcast(8, scalar);
+        else src2 = v1;
+        res = lanes::exec_widening(op, sew, v2, src2);
+    } else {
+        vreg_t op_b;
+        if (is_vx) op_b.broadcast(sew_bits(sew), scalar);
+        else op_b = v1;
+
+        if (uc == UC_MUL) {
+            vreg_t prod = lanes::exec_mul(op, sew, v2, op_b, v3);
+            res = lanes::exec_mac(op, sew, prod, v2, v3);
+        } else {
+            res = lanes::exec_alu(d.unit, op, sew, v2, op_b, scalar);
+            if (uc != UC_MASK) res = lanes::apply_mask(res, v3, vmask, vm, sew);
+        }
+    }
+
+    vrf->poke(vd, res);
+    uops++;
+}
+
+template<class CFG>
+void hp_vpu_func_t<CFG>::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+    if (!enabled || vrf == nullptr) {
+        trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
+        return;
+    }
+    if (trans.get_byte_enable_ptr() != nullptr) {
+        trans.set_response_status(tlm::TLM_BYTE_ENABLE_ERROR_RESPONSE);
+        return;
+    }
+
+    uint64_t addr = trans.get_address();
+    unsigned char* ptr = trans.get_data_ptr();
+    unsigned int len = trans.get_data_length();
+    bool is_write = (trans.get_command() == tlm::TLM_WRITE_COMMAND);
+
+    if (addr == FUNC_ADDR_ISSUE) {
+        if (!is_write || len != sizeof(cvxif_issue_t)) {
+            trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
+            return;
+        }
+        cvxif_issue_t req;
+        std::memcpy(&req, ptr, sizeof(req));
+
+        uint64_t uops_before = uops;
+        execute(req);
+        delay += cycle_time * (double)(uops - uops_before);
+    } else if (addr == FUNC_ADDR_VTYPE || addr == FUNC_ADDR_VL) {
+        if (len != 4) {
+            trans.set_response_status(tlm::TLM_BURST_ERROR_RESPONSE);
+            return;
+        }
+        uint32_t& csr = (addr == FUNC_ADDR_VTYPE) ? vtype : vl;
+        if (is_write) std::memcpy(&csr, ptr, 4);
+        else std::memcpy(ptr, &csr, 4);
+    } else {
+        trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+        return;
+    }
+
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+}
+
+template struct hp_vpu_func_t<cfg_64>;
+template struct hp_vpu_func_t<cfg_128>;
+template struct hp_vpu_func_t<cfg_256>;
+template struct hp_vpu_func_t<cfg_512>;
+
+} // namespace hp_vpu
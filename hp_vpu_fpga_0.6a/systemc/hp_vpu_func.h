@@ -0,0 +1,83 @@
+#ifndef HP_VPU_FUNC_H
+#define HP_VPU_FUNC_H
+
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_target_socket.h>
+#include "hp_vpu_pkg.h"
+#include "hp_vpu_vreg.h"
+#include "hp_vpu_vrf.h"
+#include "hp_vpu_decode.h"
+
+namespace hp_vpu {
+
+// CV-X-IF issue request carried in the TLM payload (FUNC_ADDR_ISSUE)
+struct cvxif_issue_t {
+    uint32_t instr;
+    uint32_t id;
+    uint32_t rs1;
+    uint32_t rs2;
+};
+
+// Target socket address map
+const uint64_t FUNC_ADDR_ISSUE = 0x00; // Write: cvxif_issue_t
+const uint64_t FUNC_ADDR_VTYPE = 0x10; // Write/Read: 32-bit vtype shadow
+const uint64_t FUNC_ADDR_VL    = 0x14; // Write/Read: 32-bit vl shadow
+
+// Loosely-timed functional model (instruction accurate, no pipeline)
+// - Executes issue transactions straight against the VRF shared with hp_vpu_top
+// - Same decode, LMUL sequencing and lanes datapath functions as the
+//   cycle-accurate pipeline, so results match bit for bit
+// - Each uop annotates one cycle_time on the b_transport delay
+// - Only accepts transactions while enabled (hp_vpu_top::set_mode)
+template<class CFG>
+struct hp_vpu_func_t : sc_module {
+    typedef vreg<CFG::DLEN> vreg_t;
+    typedef hp_vpu_vrf_t<CFG> vrf_t;
+
+    tlm_utils::simple_target_socket<hp_vpu_func_t> issue_tsock;
+
+    // CSR shadow (seeded from the pins on a mode switch)
+    uint32_t vtype;
+    uint32_t vl;
+
+    sc_time cycle_time; // LT annotation per uop
+    bool enabled;
+
+    // Statistics
+    uint64_t instret;
+    uint64_t uops;
+
+    decode_cache dcache; // Per-uop decode (same entries as hp_vpu_decode's)
+
+    void bind_vrf(vrf_t* v) { vrf = v; }
+
+    // Execute one issued instruction (all LMUL uops); usable without the socket
+    void execute(const cvxif_issue_t& req);
+
+    void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay);
+
+    SC_HAS_PROCESS(hp_vpu_func_t);
+    hp_vpu_func_t(sc_module_name name) : sc_module(name), issue_tsock("issue_tsock") {
+        vtype = 0;
+        vl = 0;
+        cycle_time = sc_time(2, SC_NS);
+        enabled = false;
+        instret = 0;
+        uops = 0;
+        vrf = nullptr;
+        issue_tsock.register_b_transport(this, &hp_vpu_func_t::b_transport);
+    }
+
+private:
+    vrf_t* vrf;
+
+    void execute_uop(const decoded_uop_t& d, sc_uint<32> rs1, sew_e sew);
+};
+
+// Member definitions in hp_vpu_func.cpp, instantiated there for every config
+typedef hp_vpu_func_t<cfg_default> hp_vpu_func;
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_FUNC_H
@@ -2,94 +2,238 @@
 #define HP_VPU_HAZARD_H
 
 #include <systemc.h>
+#include <ostream>
 #include "hp_vpu_pkg.h"
+#include "hp_vpu_prof.h"
 
 namespace hp_vpu {
 
+// Scoreboard hazard unit
+// - pending: one bit per vector register with a write in flight, set when
+//   an instruction moves D -> OF (issue) and cleared when its result is
+//   written back. Stall check is (pending & sources) != 0.
+// - ready_cycle: nominal writeback cycle of the last producer of each
+//   register (issue + class latency), replaced by the actual cycle at
+//   writeback. Used to tell dependence latency from structural delay.
+// - v0 is tracked like any other register: the RTL compares the raw
+//   5-bit fields, so a vmacc chain on v0 waits for each result.
+// - The vs1 field is compared even for .vx/.vi, where it holds rs1 or an
+//   immediate (as hp_vpu_hazard.sv). Such stalls are counted apart from
+//   the per-register RAW statistics, which only name registers read.
+// - OF hold (lanes not accepting) is a structural stall.
 SC_MODULE(hp_vpu_hazard) {
+    // Clock/Reset
+    sc_in<bool> clk;
+    sc_in<bool> rst_n;
+
     // Inputs: Decode (Destination/Sources)
     sc_in<bool> d_valid_i;
+    sc_in<int>  d_uclass_i; // uop_class_e
     sc_in<sc_uint<5>> d_vd_i;
     sc_in<sc_uint<5>> d_vs1_i;
+    sc_in<bool>       d_is_vx_i; // vs1 field is rs1/imm
     sc_in<sc_uint<5>> d_vs2_i;
     sc_in<sc_uint<5>> d_vs3_i;
 
-    // Pipeline Stages (for RAW hazard detection)
-    // OF: Operand Fetch (1 cycle after Decode)
-    sc_in<bool> of_valid_i; sc_in<sc_uint<5>> of_vd_i;
-
-    // E1, E1m, E2, E3 (Execution)
-    sc_in<bool> e1_valid_i; sc_in<sc_uint<5>> e1_vd_i;
-    sc_in<bool> e1m_valid_i; sc_in<sc_uint<5>> e1m_vd_i;
-    sc_in<bool> e2_valid_i; sc_in<sc_uint<5>> e2_vd_i;
-    sc_in<bool> e3_valid_i; sc_in<sc_uint<5>> e3_vd_i;
-
-    // Reduction/Widening
-    sc_in<bool> r2a_valid_i; sc_in<sc_uint<5>> r2a_vd_i;
-    sc_in<bool> r2b_valid_i; sc_in<sc_uint<5>> r2b_vd_i;
-    sc_in<bool> w2_valid_i;  sc_in<sc_uint<5>> w2_vd_i;
+    // OF stage and lanes acceptance (structural)
+    sc_in<bool> of_valid_i;
+    sc_in<bool> lanes_ready_i;
+    sc_in<bool> drain_stall_i; // Reason attribution only
 
     // Writeback (WB)
     sc_in<bool> wb_valid_i; sc_in<sc_uint<5>> wb_vd_i;
 
-    // Multicycle Control
-    sc_in<bool> multicycle_busy_i;
-    sc_in<bool> drain_stall_i; // Request to drain before complex op
-
     // Outputs
     sc_out<bool> stall_dec_o; // Stalls Decode and IQ
+    sc_out<int>  stall_reason_o; // stall_reason_e
+
+    // Scoreboard state
+    sc_signal<sc_uint<32>> pending;
+    uint64_t ready_cycle[32];
+    uop_class_e producer[32];
+    uint64_t cycle;
+    uint64_t stats_cycle; // cycle at the last clear_stats()
+
+    // Stall statistics (cycles)
+    uint64_t stall_cycles[STALL_COUNT]; // [STALL_NONE] = cycles without stall
+    uint64_t stall_by_class[UC_COUNT];  // RAW/WAW, by class of the producer
+    uint64_t stall_by_reg[32];          // RAW/WAW, by blocking register
+    uint64_t stall_overdue;             // RAW/WAW past the producer's nominal ready cycle
+    uint64_t stall_vx_field;            // RAW on the rs1/imm field of a .vx/.vi op only
+
+    // Nominal issue-to-writeback cycles per class (OF -> ... -> VRF write)
+    static int latency(uop_class_e c) {
+        switch (c) {
+            case UC_MUL:  return 5; // E1, E1m, E2, E3, WB
+            case UC_RED:  return 5; // R1, R2A, R2B, R3, WB
+            case UC_WIDE: return 3; // W1, W2, WB
+            default:      return 4; // E1, E2, E3, WB
+        }
+    }
+
+    // Register masks read/written by the instruction in D.
+    // src_mask() is what the stall compares, vec_src_mask() what is read.
+    uint32_t vec_src_mask() const {
+        uint32_t m = 1u << d_vs2_i.read().to_uint();
+        if (!d_is_vx_i.read()) m |= 1u << d_vs1_i.read().to_uint();
+        return m;
+    }
+    uint32_t src_mask() const {
+        return vec_src_mask() | (1u << d_vs1_i.read().to_uint());
+    }
+    uint32_t dst_mask() const {
+        return (1u << d_vd_i.read().to_uint()) | (1u << d_vs3_i.read().to_uint());
+    }
+
+    // Register blocking D for a RAW/WAW reason (lowest pending one, a
+    // register read before the vs1 field of a .vx/.vi op), else -1
+    int blocking_reg(stall_reason_e why) const {
+        if (why != STALL_RAW && why != STALL_WAW) return -1;
+        uint32_t p = pending.read().to_uint();
+        uint32_t hit = p & (why == STALL_RAW ? vec_src_mask() : dst_mask());
+        if (!hit && why == STALL_RAW) hit = p & src_mask();
+        return hit ? __builtin_ctz(hit) : -1;
+    }
+
+    // RAW held only by the rs1/imm field compare
+    bool vx_field_stall(stall_reason_e why) const {
+        return why == STALL_RAW && !(pending.read().to_uint() & vec_src_mask());
+    }
 
     void hazard_logic() {
-        bool hazard = false;
+        HP_VPU_PROF_SCOPE(PROF_HAZARD_LOGIC);
+        stall_reason_e why = STALL_NONE;
+
+        // 1. Structural: OF cannot hand its instruction to the lanes
+        if (of_valid_i.read() && !lanes_ready_i.read()) {
+            why = drain_stall_i.read() ? STALL_DRAIN : STALL_BUSY;
+        }
+        // 2. Data: single AND against the scoreboard
+        else if (d_valid_i.read()) {
+            uint32_t p = pending.read().to_uint();
+            if (p & src_mask()) why = STALL_RAW;
+            else if (p & dst_mask()) why = STALL_WAW;
+        }
+
+        stall_dec_o.write(why != STALL_NONE);
+        stall_reason_o.write(why);
+    }
 
-        // 1. Structural/Protocol Stalls
-        if (multicycle_busy_i.read() || drain_stall_i.read()) {
-            stall_dec_o.write(true);
+    // Clocked: one call per posedge, synchronous reset
+    void scoreboard_update() {
+        HP_VPU_PROF_SCOPE(PROF_SCOREBOARD);
+        if (!rst_n.read()) {
+            pending.write(0);
+            cycle = stats_cycle = 0;
             return;
         }
 
-        // 2. RAW Hazard Detection
-        if (d_valid_i.read()) {
-            sc_uint<5> s1 = d_vs1_i.read();
-            sc_uint<5> s2 = d_vs2_i.read();
-            sc_uint<5> s3 = d_vs3_i.read();
-
-            auto check_stage = [&](bool valid, sc_uint<5> vd) {
-                if (!valid) return false;
-                if (vd == 0) return false; // x0/v0 never hazards? v0 is mask, so it might.
-                // Assuming v0 is hazardable.
-                return (vd == s1 || vd == s2 || vd == s3);
-            };
-
-            if (check_stage(of_valid_i.read(), of_vd_i.read())) hazard = true;
-            if (check_stage(e1_valid_i.read(), e1_vd_i.read())) hazard = true;
-            if (check_stage(e1m_valid_i.read(), e1m_vd_i.read())) hazard = true;
-            if (check_stage(e2_valid_i.read(), e2_vd_i.read())) hazard = true;
-            if (check_stage(e3_valid_i.read(), e3_vd_i.read())) hazard = true;
-
-            if (check_stage(r2a_valid_i.read(), r2a_vd_i.read())) hazard = true;
-            if (check_stage(r2b_valid_i.read(), r2b_vd_i.read())) hazard = true;
-            if (check_stage(w2_valid_i.read(), w2_vd_i.read())) hazard = true;
-
-            if (check_stage(wb_valid_i.read(), wb_vd_i.read())) hazard = true;
+        cycle++;
+        uint32_t p = pending.read().to_uint();
+
+        // Statistics for the cycle that just ended
+        stall_reason_e why = (stall_reason_e)stall_reason_o.read();
+        stall_cycles[why]++;
+        int b = blocking_reg(why);
+        if (b >= 0 && vx_field_stall(why)) {
+            stall_vx_field++;
+        } else if (b >= 0) {
+            stall_by_class[producer[b]]++;
+            stall_by_reg[b]++;
+            if (cycle > ready_cycle[b]) stall_overdue++;
+        }
+
+        // Writeback clears, issue sets (never the same register: vd is checked)
+        if (wb_valid_i.read()) {
+            int r = wb_vd_i.read().to_uint();
+            p &= ~(1u << r);
+            ready_cycle[r] = cycle;
         }
+        if (d_valid_i.read() && !stall_dec_o.read()) {
+            int r = d_vd_i.read().to_uint();
+            uop_class_e c = (uop_class_e)d_uclass_i.read();
+            p |= 1u << r;
+            producer[r] = c;
+            ready_cycle[r] = cycle + latency(c);
+        }
+        pending.write(p);
+    }
+
+    // Account for n posedges the clock source did not deliver (idle skip).
+    // Nothing is pending or in D/OF while idle, so they are stall-free.
+    void skip(uint64_t n) {
+        cycle += n;
+        stall_cycles[STALL_NONE] += n;
+    }
+
+    // Zero the statistics (not the scoreboard), e.g. after a warm-up window
+    void clear_stats() {
+        stats_cycle = cycle;
+        stall_overdue = 0;
+        stall_vx_field = 0;
+        for (int i = 0; i < STALL_COUNT; i++) stall_cycles[i] = 0;
+        for (int i = 0; i < UC_COUNT; i++) stall_by_class[i] = 0;
+        for (int i = 0; i < 32; i++) stall_by_reg[i] = 0;
+    }
 
-        stall_dec_o.write(hazard);
+    uint64_t stalled_cycles() const {
+        uint64_t n = 0;
+        for (int i = STALL_RAW; i < STALL_COUNT; i++) n += stall_cycles[i];
+        return n;
+    }
+
+    void report(std::ostream& os) const {
+        static const char* why[STALL_COUNT] = { "none", "raw", "waw", "busy", "drain" };
+        static const char* cls[UC_COUNT] = { "alu", "mul", "red", "wide", "perm", "lut", "mask" };
+        os << "[HZ] Stall cycles: " << stalled_cycles() << " of " << cycle - stats_cycle;
+        for (int i = STALL_RAW; i < STALL_COUNT; i++) os << " " << why[i] << "=" << stall_cycles[i];
+        os << " overdue=" << stall_overdue << std::endl;
+        os << "[HZ] By producer:";
+        for (int i = 0; i < UC_COUNT; i++) if (stall_by_class[i]) os << " " << cls[i] << "=" << stall_by_class[i];
+        os << std::endl << "[HZ] By register:";
+        for (int i = 0; i < 32; i++) if (stall_by_reg[i]) os << " v" << i << "=" << stall_by_reg[i];
+        os << std::endl;
+        if (stall_vx_field) os << "[HZ] RAW on a .vx/.vi rs1/imm field: " << stall_vx_field << std::endl;
+    }
+
+    // Same counters as report(), as a JSON object
+    void report_json(std::ostream& os) const {
+        static const char* why[STALL_COUNT] = { "none", "raw", "waw", "busy", "drain" };
+        static const char* cls[UC_COUNT] = { "alu", "mul", "red", "wide", "perm", "lut", "mask" };
+        os << "{\"cycles\": " << cycle - stats_cycle << ", \"stall_cycles\": {";
+        for (int i = STALL_RAW; i < STALL_COUNT; i++) os << (i > STALL_RAW ? ", " : "") << "\"" << why[i] << "\": " << stall_cycles[i];
+        os << "}, \"overdue\": " << stall_overdue << ", \"by_producer\": {";
+        const char* sep = "";
+        for (int i = 0; i < UC_COUNT; i++) {
+            if (!stall_by_class[i]) continue;
+            os << sep << "\"" << cls[i] << "\": " << stall_by_class[i];
+            sep = ", ";
+        }
+        os << "}, \"by_register\": {";
+        sep = "";
+        for (int i = 0; i < 32; i++) {
+            if (!stall_by_reg[i]) continue;
+            os << sep << "\"v" << i << "\": " << stall_by_reg[i];
+            sep = ", ";
+        }
+        os << "}, \"vx_field\": " << stall_vx_field << "}";
     }
 
     SC_CTOR(hp_vpu_hazard) {
+        cycle = 0;
+        for (int i = 0; i < 32; i++) {
+            ready_cycle[i] = 0;
+            producer[i] = UC_ALU;
+        }
+        clear_stats();
+
         SC_METHOD(hazard_logic);
-        sensitive << d_valid_i << d_vs1_i << d_vs2_i << d_vs3_i
-                  << of_valid_i << of_vd_i
-                  << e1_valid_i << e1_vd_i
-                  << e1m_valid_i << e1m_vd_i
-                  << e2_valid_i << e2_vd_i
-                  << e3_valid_i << e3_vd_i
-                  << r2a_valid_i << r2a_vd_i
-                  << r2b_valid_i << r2b_vd_i
-                  << w2_valid_i << w2_vd_i
-                  << wb_valid_i << wb_vd_i
-                  << multicycle_busy_i << drain_stall_i;
+        sensitive << d_valid_i << d_vd_i << d_vs1_i << d_is_vx_i << d_vs2_i << d_vs3_i
+                  << of_valid_i << lanes_ready_i << drain_stall_i << pending;
+
+        SC_METHOD(scoreboard_update);
+        sensitive << clk.pos();
+        dont_initialize();
     }
 };
 
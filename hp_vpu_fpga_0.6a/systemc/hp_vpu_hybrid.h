@@ -0,0 +1,175 @@
+#ifndef HP_VPU_HYBRID_H
+#define HP_VPU_HYBRID_H
+
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <chrono>
+#include <vector>
+#include "hp_vpu_pkg.h"
+#include "hp_vpu_top.h"
+#include "hp_vpu_drivers.h"
+#include "hp_vpu_scoreboard.h"
+
+namespace hp_vpu {
+
+// Testbench signals bound to the hp_vpu_top CSR pins
+struct csr_pins_t {
+    sc_signal<sc_uint<32>>* vtype;
+    sc_signal<sc_uint<32>>* vl;
+};
+
+struct hybrid_cfg_t {
+    uint64_t ff_insns;     // Functional fast-forward (TLM, no timing)
+    uint64_t warmup_insns; // Cycle-accurate, excluded from statistics
+    uint64_t detail_insns; // Cycle-accurate, measured (0 = rest of the program)
+};
+
+struct hybrid_stats_t {
+    uint64_t ff_insns;
+    uint64_t ff_cycles; // b_transport delay of the fast-forward (one cycle per uop)
+    double   ff_host_sec;
+    uint64_t warmup_insns;
+    uint64_t insns;  // Measured window
+    uint64_t cycles; // Measured window, including the final drain
+
+    double ipc() const { return cycles ? (double)insns / cycles : 0.0; }
+    double ff_mips() const { return ff_host_sec > 0 ? ff_insns / ff_host_sec / 1e6 : 0.0; }
+};
+
+// Fast-forward then cycle-accurate runner
+// 1. First ff_insns instructions go through u_func over TLM
+// 2. Architectural state moves to the pipeline: VRF is shared, vtype/vl go
+//    back onto the CSR pins, and the IQ is preloaded with the next entries
+//    (as a core issuing back-to-back would have left it); an enabled
+//    scoreboard resyncs its shadow VRF and is told about those entries
+// 3. Remaining instructions are queued on the issue driver, warm-up window
+//    first, and run with a single sc_start() (issue + drain); the slot,
+//    hazard and lanes statistics are cleared when the measured window starts
+// Must be called from sc_main after reset, between sc_start calls.
+template<class CFG>
+struct hp_vpu_hybrid_t : sc_module {
+    typedef hp_vpu_top_t<CFG> top_t;
+
+    tlm_utils::simple_initiator_socket<hp_vpu_hybrid_t> isock;
+
+    top_t* top;
+    hp_vpu_issue_drv* drv;
+    csr_pins_t pins;
+    sc_time period;
+    hp_vpu_scoreboard_t<CFG>* scb; // Optional
+
+    void bind(top_t* t, hp_vpu_issue_drv* d, const csr_pins_t& p, const sc_time& clk_period) {
+        top = t;
+        drv = d;
+        pins = p;
+        period = clk_period;
+        isock.bind(top->u_func->issue_tsock);
+    }
+
+    hybrid_stats_t run(const std::vector<cvxif_issue_t>& prog, const hybrid_cfg_t& cfg) {
+        hybrid_stats_t st = {};
+        uint64_t n = prog.size();
+        uint64_t pc = 0;
+
+        // --- Phase 1: functional fast-forward ---
+        uint64_t ff = (cfg.ff_insns < n) ? cfg.ff_insns : n;
+        if (ff > 0) {
+            drain();
+            top->set_mode(top_t::MODE_FUNCTIONAL);
+
+            auto t0 = std::chrono::steady_clock::now();
+            tlm::tlm_generic_payload trans;
+            sc_time delay = SC_ZERO_TIME;
+            for (; pc < ff; pc++) {
+                cvxif_issue_t req = prog[pc];
+                trans.set_command(tlm::TLM_WRITE_COMMAND);
+                trans.set_address(FUNC_ADDR_ISSUE);
+                trans.set_data_ptr(reinterpret_cast<unsigned char*>(&req));
+                trans.set_data_length(sizeof(req));
+                trans.set_streaming_width(sizeof(req));
+                trans.set_byte_enable_ptr(nullptr);
+                trans.set_dmi_allowed(false);
+                trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+                isock->b_transport(trans, delay);
+                if (trans.is_response_error()) {
+                    SC_REPORT_ERROR("hp_vpu_hybrid", "functional issue rejected");
+                    return st;
+                }
+            }
+            st.ff_host_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            st.ff_insns = ff;
+            st.ff_cycles = (uint64_t)(delay / period + 0.5);
+
+            // --- State transfer ---
+            pins.vtype->write(top->u_func->vtype);
+            pins.vl->write(top->u_func->vl);
+            top->set_mode(top_t::MODE_CYCLE);
+
+            iq_entry_t q[hp_vpu_iq::DEPTH];
+            int k = 0;
+            for (; k < hp_vpu_iq::DEPTH && pc + k < n; k++) {
+                q[k].instr = prog[pc + k].instr;
+                q[k].id    = prog[pc + k].id;
+                q[k].rs1   = prog[pc + k].rs1;
+                q[k].rs2   = prog[pc + k].rs2;
+            }
+            int pre = top->u_iq->preload(q, k);
+            if (scb && scb->enabled()) {
+                scb->sync();
+                for (int i = 0; i < pre; i++) scb->expect(prog[pc + i], top->u_func->vtype);
+            }
+            pc += pre;
+        }
+
+        // --- Phase 2: cycle-accurate (warm-up, then measured window) ---
+        uint64_t warm_end = ff + cfg.warmup_insns;
+        if (warm_end > n) warm_end = n;
+        uint64_t detail_end = cfg.detail_insns ? warm_end + cfg.detail_insns : n;
+        if (detail_end > n) detail_end = n;
+
+        uint64_t pc_start = (warm_end > pc) ? warm_end : pc;
+        if (pc_start > detail_end) pc_start = detail_end;
+        sc_time t_start;
+
+        if (pc < detail_end) {
+            drv->clear_stats();
+            drv->push(&prog[pc], detail_end - pc);
+            drv->mark(pc_start - pc);
+            if (pc_start > pc) drv->mark_fn = [this]() { top->clear_stats(); };
+            sc_start(); // Paused by the driver once drained
+            drv->mark_fn = nullptr;
+            t_start = (pc_start < detail_end) ? drv->t_mark : sc_time_stamp();
+            if (pc_start > pc && pc_start == detail_end) top->clear_stats(); // All warm-up
+            pc = detail_end;
+        } else {
+            drain(); // Preloaded IQ entries only
+            t_start = sc_time_stamp();
+        }
+
+        st.warmup_insns = (pc_start > ff) ? pc_start - ff : 0;
+        st.insns = pc - pc_start;
+        st.cycles = (uint64_t)((sc_time_stamp() - t_start) / period + 0.5);
+        return st;
+    }
+
+    // Clock until nothing is in flight (bounded)
+    void drain() {
+        for (int i = 0; i < 100000 && !top->pipeline_idle(); i++) sc_start(period);
+    }
+
+    SC_HAS_PROCESS(hp_vpu_hybrid_t);
+    hp_vpu_hybrid_t(sc_module_name name) : sc_module(name), isock("isock") {
+        top = nullptr;
+        drv = nullptr;
+        pins = csr_pins_t();
+        scb = nullptr;
+        period = sc_time(2, SC_NS);
+    }
+};
+
+typedef hp_vpu_hybrid_t<cfg_default> hp_vpu_hybrid;
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_HYBRID_H
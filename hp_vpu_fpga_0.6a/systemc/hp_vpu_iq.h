@@ -3,6 +3,7 @@
 
 #include <systemc.h>
 #include "hp_vpu_pkg.h"
+#include "hp_vpu_prof.h"
 
 namespace hp_vpu {
 
@@ -59,7 +60,9 @@ SC_MODULE(hp_vpu_iq) {
     sc_signal<int> rd_ptr;
     sc_signal<int> count;
 
+    // Clocked: one call per posedge, synchronous reset
     void iq_logic() {
+        HP_VPU_PROF_SCOPE(PROF_IQ_LOGIC);
         if (!rst_n.read() || flush_i.read()) {
             wr_ptr.write(0);
             rd_ptr.write(0);
@@ -105,6 +108,7 @@ SC_MODULE(hp_vpu_iq) {
     }
 
     void output_logic() {
+        HP_VPU_PROF_SCOPE(PROF_IQ_OUTPUT);
         int cnt = count.read();
         int rd = rd_ptr.read();
         bool push = push_valid_i.read();
@@ -138,9 +142,21 @@ SC_MODULE(hp_vpu_iq) {
         push_ready_o.write(cnt < DEPTH);
     }
 
+    // Backdoor fill of an empty queue (hybrid mode switch), takes effect at
+    // the next delta. Returns the number of entries taken (at most DEPTH).
+    int preload(const iq_entry_t* e, int n) {
+        int k = (n < DEPTH) ? n : DEPTH;
+        for (int i = 0; i < k; i++) fifo[i] = e[i];
+        rd_ptr.write(0);
+        wr_ptr.write(k % DEPTH);
+        count.write(k);
+        return k;
+    }
+
     SC_CTOR(hp_vpu_iq) {
-        SC_CTHREAD(iq_logic, clk.pos());
-        reset_signal_is(rst_n, false);
+        SC_METHOD(iq_logic);
+        sensitive << clk.pos();
+        dont_initialize();
 
         SC_METHOD(output_logic);
         sensitive << count << rd_ptr << push_valid_i << push_instr_i << push_id_i << push_rs1_i << push_rs2_i;
@@ -0,0 +1,177 @@
+#ifndef HP_VPU_JSON_H
+#define HP_VPU_JSON_H
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hp_vpu {
+
+// Minimal JSON reader for the config/*.json files (sweep grids, VPU configs).
+// No escapes beyond \" \\ \/ \n \t \r \b \f, no \u; numbers as double.
+struct json_value {
+    enum type_e { J_NULL = 0, J_BOOL, J_NUMBER, J_STRING, J_ARRAY, J_OBJECT };
+    type_e type;
+    bool b;
+    double num;
+    std::string str;
+    std::vector<json_value> arr;
+    std::vector<std::pair<std::string, json_value>> obj; // File order kept
+
+    json_value() : type(J_NULL), b(false), num(0) {}
+
+    bool is_null() const { return type == J_NULL; }
+    bool is_array() const { return type == J_ARRAY; }
+    bool is_object() const { return type == J_OBJECT; }
+
+    // Object member, or a null value if absent / not an object
+    const json_value& operator[](const std::string& key) const {
+        static const json_value null_value;
+        if (type == J_OBJECT)
+            for (const auto& kv : obj) if (kv.first == key) return kv.second;
+        return null_value;
+    }
+
+    double as_number(double def = 0) const { return type == J_NUMBER ? num : def; }
+    long as_int(long def = 0) const { return type == J_NUMBER ? (long)num : def; }
+    bool as_bool(bool def = false) const { return type == J_BOOL ? b : def; }
+    std::string as_string(const std::string& def = "") const {
+        if (type == J_STRING) return str;
+        if (type == J_NUMBER) return to_text();
+        return def;
+    }
+
+    // Scalar as text (numbers without a trailing .0 when integral)
+    std::string to_text() const {
+        std::ostringstream os;
+        switch (type) {
+            case J_BOOL:   os << (b ? "true" : "false"); break;
+            case J_NUMBER: if (num == (double)(long long)num) os << (long long)num; else os << num; break;
+            case J_STRING: os << str; break;
+            default: break;
+        }
+        return os.str();
+    }
+};
+
+class json_parser {
+public:
+    explicit json_parser(const std::string& text) : s(text), i(0) {}
+
+    bool parse(json_value& out, std::string* err) {
+        bool ok = value(out) && (ws(), i == s.size());
+        if (!ok && err) {
+            std::ostringstream os;
+            os << "JSON parse error at offset " << i;
+            *err = os.str();
+        }
+        return ok;
+    }
+
+private:
+    const std::string& s;
+    size_t i;
+
+    void ws() { while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r')) i++; }
+
+    bool lit(const char* w) {
+        size_t n = std::char_traits<char>::length(w);
+        if (s.compare(i, n, w) != 0) return false;
+        i += n;
+        return true;
+    }
+
+    bool string(std::string& out) {
+        if (s[i] != '"') return false;
+        i++;
+        while (i < s.size() && s[i] != '"') {
+            char c = s[i++];
+            if (c == '\\') {
+                if (i >= s.size()) return false;
+                char e = s[i++];
+                switch (e) {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case '"': case '\\': case '/': c = e; break;
+                    default: return false;
+                }
+            }
+            out += c;
+        }
+        if (i >= s.size()) return false;
+        i++;
+        return true;
+    }
+
+    bool value(json_value& v) {
+        ws();
+        if (i >= s.size()) return false;
+        char c = s[i];
+        if (c == '{') {
+            v.type = json_value::J_OBJECT;
+            i++; ws();
+            if (i < s.size() && s[i] == '}') { i++; return true; }
+            for (;;) {
+                ws();
+                std::string key;
+                if (i >= s.size() || !string(key)) return false;
+                ws();
+                if (i >= s.size() || s[i] != ':') return false;
+                i++;
+                v.obj.push_back(std::make_pair(key, json_value()));
+                if (!value(v.obj.back().second)) return false;
+                ws();
+                if (i < s.size() && s[i] == ',') { i++; continue; }
+                if (i < s.size() && s[i] == '}') { i++; return true; }
+                return false;
+            }
+        }
+        if (c == '[') {
+            v.type = json_value::J_ARRAY;
+            i++; ws();
+            if (i < s.size() && s[i] == ']') { i++; return true; }
+            for (;;) {
+                v.arr.push_back(json_value());
+                if (!value(v.arr.back())) return false;
+                ws();
+                if (i < s.size() && s[i] == ',') { i++; continue; }
+                if (i < s.size() && s[i] == ']') { i++; return true; }
+                return false;
+            }
+        }
+        if (c == '"') { v.type = json_value::J_STRING; return string(v.str); }
+        if (lit("true"))  { v.type = json_value::J_BOOL; v.b = true; return true; }
+        if (lit("false")) { v.type = json_value::J_BOOL; v.b = false; return true; }
+        if (lit("null"))  { v.type = json_value::J_NULL; return true; }
+
+        const char* start = s.c_str() + i;
+        char* end = nullptr;
+        v.num = std::strtod(start, &end);
+        if (end == start) return false;
+        v.type = json_value::J_NUMBER;
+        i += end - start;
+        return true;
+    }
+};
+
+inline bool json_load(const std::string& path, json_value& out, std::string* err) {
+    std::ifstream f(path);
+    if (!f) {
+        if (err) *err = "cannot open " + path;
+        return false;
+    }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    std::string text = ss.str();
+    return json_parser(text).parse(out, err);
+}
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_JSON_H
@@ -0,0 +1,266 @@
+#ifndef HP_VPU_KERNELS_H
+#define HP_VPU_KERNELS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "hp_vpu_pkg.h"
+#include "hp_vpu_func.h"
+
+namespace hp_vpu {
+
+// OP-V instruction word: opcode 1010111, vm=1 unless given
+inline uint32_t encode_opv(int funct6, int funct3, int vd, int vs1_rs1_imm, int vs2, bool vm = true) {
+    return (uint32_t)(0x57 | ((vd & 31) << 7) | ((funct3 & 7) << 12) | ((vs1_rs1_imm & 31) << 15) |
+                      ((vs2 & 31) << 20) | ((vm ? 1u : 0u) << 25) | ((uint32_t)(funct6 & 63) << 26));
+}
+
+// vtype CSR value (vsew in [5:3], vlmul in [2:0])
+inline uint32_t encode_vtype(sew_e sew, int lmul = LMUL_1) {
+    return ((uint32_t)sew << 3) | (uint32_t)(lmul & 7);
+}
+
+// funct6 values used by the kernel programs
+const int F6_VADD    = 0b000000; // OPIVV/OPIVX/OPIVI
+const int F6_VSUB    = 0b000010;
+const int F6_VMIN    = 0b000101;
+const int F6_VMAX    = 0b000111;
+const int F6_VRGATHER = 0b001100;
+const int F6_VSLIDEDOWN = 0b001111; // OPIVX/OPIVI; vslide1down in OPMVX
+const int F6_VSLIDE1UP = 0b001110;  // OPMVX
+const int F6_VSRL    = 0b101000;
+const int F6_VSRA    = 0b101001;
+const int F6_VSSRA   = 0b101011;
+const int F6_VREDSUM = 0b000000; // OPMVV
+const int F6_VREDMAX = 0b000111;
+const int F6_VLUT    = 0b010010; // vs1 selects the table (LUT_*)
+const int F6_VMUL    = 0b100101;
+const int F6_VMULH   = 0b100111;
+const int F6_VMADD   = 0b101001;
+const int F6_VMACC   = 0b101101;
+
+enum lut_sel_e { LUT_EXP = 0, LUT_RECIP = 1, LUT_RSQRT = 2, LUT_GELU = 3 };
+
+// Benchmark kernel: instruction stream and the work it stands for
+struct bench_kernel_t {
+    std::vector<cvxif_issue_t> prog;
+    uint64_t vec_macs; // vmacc/vmadd instructions (one vector of MACs each); plain multiplies are ops
+};
+
+// Appends instructions with rolling CV-X-IF ids
+struct kernel_builder {
+    bench_kernel_t k;
+
+    kernel_builder() { k.vec_macs = 0; }
+
+    void op(uint32_t instr, uint32_t rs1 = 0) {
+        cvxif_issue_t req = { instr, (uint32_t)(k.prog.size() & ((1 << CVXIF_ID_W) - 1)), rs1, 0 };
+        k.prog.push_back(req);
+    }
+    void mac(uint32_t instr, uint32_t rs1 = 0) {
+        op(instr, rs1);
+        k.vec_macs++;
+    }
+    size_t size() const { return k.prog.size(); }
+};
+
+inline int clamp_acc(int n_acc, int max) {
+    return n_acc < 1 ? 1 : n_acc > max ? max : n_acc;
+}
+
+// Output-stationary GEMV inner loop (run_long_gemv in the RTL testbench):
+// vmacc.vx v[i % n_acc], x10, v[16 + i % n_acc], rs1 carries the
+// activation. Accumulators v0..v15, weights v16..v31.
+inline std::vector<cvxif_issue_t> gemv_program(int n_acc, int count, uint32_t rs1 = 0) {
+    n_acc = clamp_acc(n_acc, 16);
+    std::vector<cvxif_issue_t> prog;
+    prog.reserve(count);
+    for (int i = 0; i < count; i++) {
+        int k = i % n_acc;
+        cvxif_issue_t req = { encode_opv(F6_VMACC, OPMVX, k, 10, 16 + k),
+                              (uint32_t)(i & ((1 << CVXIF_ID_W) - 1)), rs1, 0 };
+        prog.push_back(req);
+    }
+    return prog;
+}
+
+// Same loop with vector activations: vmacc.vv v[k], v[16 + k], v[24 + k % 8]
+inline std::vector<cvxif_issue_t> gemv_vv_program(int n_acc, int count) {
+    n_acc = clamp_acc(n_acc, 16);
+    std::vector<cvxif_issue_t> prog;
+    prog.reserve(count);
+    for (int i = 0; i < count; i++) {
+        int k = i % n_acc;
+        cvxif_issue_t req = { encode_opv(F6_VMACC, OPMVV, k, 24 + k % 8, 16 + k),
+                              (uint32_t)(i & ((1 << CVXIF_ID_W) - 1)), 0, 0 };
+        prog.push_back(req);
+    }
+    return prog;
+}
+
+// The LLM kernels below repeat one tile until at least `count` instructions
+// are queued. Tiles are issued stage-major over n_acc independent rows or
+// columns, so n_acc is the number of dependency chains in flight.
+// Registers: rows/weights v16..v23 (v16..v31 for GEMM), temporaries
+// v0..v15, gather indices v28 (built in v27/v28), beta v29, gamma v30,
+// zero v31.
+
+const int GEMM_K = 16; // Reduction depth per tile (K=16 as in the RTL benchmark)
+
+// GEMM tile as rank-1 updates: acc[j] += W[k] * a[k][j] for n_acc output
+// columns, each weight register reused across the columns
+// vmacc.vx v[j], x10, v[16 + k]
+inline bench_kernel_t gemm_kernel(int n_acc, int count) {
+    n_acc = clamp_acc(n_acc, 16);
+    kernel_builder b;
+    while ((int)b.size() < count)
+        for (int k = 0; k < GEMM_K; k++)
+            for (int j = 0; j < n_acc; j++)
+                b.mac(encode_opv(F6_VMACC, OPMVX, j, 10, 16 + k), (uint32_t)(k * 16 + j));
+    return b.k;
+}
+
+// GEMV tile (K steps over n_acc output rows) followed by an epilogue on each
+// accumulator
+enum gemv_epilogue_e { EPI_NONE, EPI_REQUANT, EPI_GELU };
+
+inline bench_kernel_t gemv_epilogue_kernel(int n_acc, int count, gemv_epilogue_e epi) {
+    n_acc = clamp_acc(n_acc, 16);
+    kernel_builder b;
+    while ((int)b.size() < count) {
+        for (int k = 0; k < GEMM_K; k++)
+            for (int j = 0; j < n_acc; j++)
+                b.mac(encode_opv(F6_VMACC, OPMVX, j, 10, 16 + j), (uint32_t)k);
+        if (epi == EPI_REQUANT) {
+            // y = clamp(roundoff(mulh(acc, M), 3) + zp, -128, 127)
+            for (int j = 0; j < n_acc; j++) b.op(encode_opv(F6_VMULH, OPMVX, j, 11, j), 0x5A5A5A5Au);
+            for (int j = 0; j < n_acc; j++) b.op(encode_opv(F6_VSSRA, OPIVI, j, 3, j));
+            for (int j = 0; j < n_acc; j++) b.op(encode_opv(F6_VADD, OPIVX, j, 12, j), 0);
+            for (int j = 0; j < n_acc; j++) b.op(encode_opv(F6_VMAX, OPIVX, j, 13, j), (uint32_t)-128);
+            for (int j = 0; j < n_acc; j++) b.op(encode_opv(F6_VMIN, OPIVX, j, 14, j), 127);
+        } else if (epi == EPI_GELU) {
+            for (int j = 0; j < n_acc; j++) b.op(encode_opv(F6_VLUT, OPMVV, j, LUT_GELU, j));
+        }
+    }
+    return b.k;
+}
+
+// Row-wise softmax over n_acc rows X = v16 + r (temporaries A, B):
+// max, broadcast, x - max, exp, sum, broadcast, 1/sum, scale
+inline bench_kernel_t softmax_kernel(int n_acc, int count) {
+    int rows = clamp_acc(n_acc, 8);
+    kernel_builder b;
+    while ((int)b.size() < count) {
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VREDMAX, OPMVV, 2 * r, 16 + r, 16 + r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VRGATHER, OPIVI, 2 * r + 1, 0, 2 * r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VSUB, OPIVV, 2 * r, 2 * r + 1, 16 + r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VLUT, OPMVV, 16 + r, LUT_EXP, 2 * r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VREDSUM, OPMVV, 2 * r, 31, 16 + r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VRGATHER, OPIVI, 2 * r + 1, 0, 2 * r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VLUT, OPMVV, 2 * r, LUT_RECIP, 2 * r + 1));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VMUL, OPMVV, 16 + r, 2 * r, 16 + r));
+    }
+    return b.k;
+}
+
+// RMSNorm: y = x * rsqrt(sum(x^2) >> log2(n)) * gamma
+// LayerNorm: x -= mean, then as RMSNorm with y = x * r * gamma + beta
+inline bench_kernel_t norm_kernel(int n_acc, int count, bool layer) {
+    int rows = clamp_acc(n_acc, 8);
+    const int log2n = 4;
+    kernel_builder b;
+    while ((int)b.size() < count) {
+        if (layer) {
+            for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VREDSUM, OPMVV, 2 * r, 31, 16 + r));
+            for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VRGATHER, OPIVI, 2 * r + 1, 0, 2 * r));
+            for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VSRA, OPIVI, 2 * r + 1, log2n, 2 * r + 1));
+            for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VSUB, OPIVV, 16 + r, 2 * r + 1, 16 + r));
+        }
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VMUL, OPMVV, 2 * r, 16 + r, 16 + r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VREDSUM, OPMVV, 2 * r + 1, 31, 2 * r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VRGATHER, OPIVI, 2 * r, 0, 2 * r + 1));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VSRL, OPIVI, 2 * r, log2n, 2 * r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VLUT, OPMVV, 2 * r + 1, LUT_RSQRT, 2 * r));
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VMUL, OPMVV, 16 + r, 2 * r + 1, 16 + r));
+        if (layer) {
+            for (int r = 0; r < rows; r++) b.mac(encode_opv(F6_VMADD, OPMVV, 16 + r, 30, 29));
+        } else {
+            for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VMUL, OPMVV, 16 + r, 30, 16 + r));
+        }
+    }
+    return b.k;
+}
+
+// 1-D convolution (FIR) over n_acc rows X = v16 + r: tap t slides the row
+// down t elements and MACs it into acc v[2r]
+// vslidedown.vi v[2r + 1], v[16 + r], t; vmacc.vx v[2r], x10, v[2r + 1]
+const int CONV_TAPS = 4;
+
+inline bench_kernel_t conv1d_kernel(int n_acc, int count) {
+    int rows = clamp_acc(n_acc, 8);
+    kernel_builder b;
+    while ((int)b.size() < count) {
+        for (int r = 0; r < rows; r++) b.mac(encode_opv(F6_VMACC, OPMVX, 2 * r, 10, 16 + r), 3);
+        for (int t = 1; t < CONV_TAPS; t++) {
+            for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VSLIDEDOWN, OPIVI, 2 * r + 1, t, 16 + r));
+            for (int r = 0; r < rows; r++) b.mac(encode_opv(F6_VMACC, OPMVX, 2 * r, 10, 2 * r + 1), (uint32_t)(3 - t));
+        }
+    }
+    return b.k;
+}
+
+// General gather (upsample / interleave): X[r] += c * X[r][i / 2] through
+// vrgather.vv with the index vector v28. The indices are shifted in once by
+// vslide1up.vx (GATHER_ELEMS of them, last one lands in element 0), so
+// element i holds i / 2 for any element count up to GATHER_ELEMS.
+const int GATHER_ELEMS = 64; // DLEN 512 at SEW 8
+
+inline bench_kernel_t gather_kernel(int n_acc, int count) {
+    int rows = clamp_acc(n_acc, 8);
+    kernel_builder b;
+    for (int k = 0; k < GATHER_ELEMS; k++) {
+        // vd may not overlap vs2: ping-pong, ending in v28
+        int dst = (k & 1) ? 28 : 27, src = (k & 1) ? 27 : 28;
+        b.op(encode_opv(F6_VSLIDE1UP, OPMVX, dst, 10, src), (uint32_t)((GATHER_ELEMS - 1 - k) / 2));
+    }
+    while ((int)b.size() < count) {
+        for (int r = 0; r < rows; r++) b.op(encode_opv(F6_VRGATHER, OPIVV, 2 * r, 28, 16 + r));
+        for (int r = 0; r < rows; r++) b.mac(encode_opv(F6_VMACC, OPMVX, 16 + r, 10, 2 * r), 3);
+    }
+    return b.k;
+}
+
+// Kernel names accepted by kernel_build (sweep grids, tb_bench)
+inline const std::vector<std::string>& kernel_names() {
+    static const std::vector<std::string> names = {
+        "gemv", "gemv_vv", "gemm", "gemv_requant", "gemv_gelu", "softmax", "rmsnorm", "layernorm",
+        "conv1d", "gather"
+    };
+    return names;
+}
+
+// Kernel by name; empty program for an unknown name
+inline bench_kernel_t kernel_build(const std::string& name, int n_acc, int count) {
+    bench_kernel_t k;
+    k.vec_macs = 0;
+    if (name == "gemv" || name == "gemv_vv") {
+        k.prog = (name == "gemv") ? gemv_program(n_acc, count) : gemv_vv_program(n_acc, count);
+        k.vec_macs = k.prog.size();
+    } else if (name == "gemm")         k = gemm_kernel(n_acc, count);
+    else if (name == "gemv_requant") k = gemv_epilogue_kernel(n_acc, count, EPI_REQUANT);
+    else if (name == "gemv_gelu")    k = gemv_epilogue_kernel(n_acc, count, EPI_GELU);
+    else if (name == "softmax")      k = softmax_kernel(n_acc, count);
+    else if (name == "rmsnorm")      k = norm_kernel(n_acc, count, false);
+    else if (name == "layernorm")    k = norm_kernel(n_acc, count, true);
+    else if (name == "conv1d")       k = conv1d_kernel(n_acc, count);
+    else if (name == "gather")       k = gather_kernel(n_acc, count);
+    return k;
+}
+
+inline std::vector<cvxif_issue_t> kernel_program(const std::string& name, int n_acc, int count) {
+    return kernel_build(name, n_acc, count).prog;
+}
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_KERNELS_H
@@ -1,585 +1,580 @@
 #include "hp_vpu_lanes.h"
+#include "hp_vpu_simd.h"
+#include <algorithm>
 
 namespace hp_vpu {
 
-bool hp_vpu_lanes::is_reduction(vpu_op_e op) {
-    return (op >= OP_VREDSUM && op <= OP_VREDMAX);
-}
-
-bool hp_vpu_lanes::is_widening(vpu_op_e op) {
-    return (op >= OP_VWMUL && op <= OP_VWSUBU);
-}
-
 // ----------------------------------------------------------------------
 // ALU Implementation
 // ----------------------------------------------------------------------
 
 // Add/Sub
-sc_biguint<DLEN> hp_vpu_lanes::alu_add(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, bool is_sub) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width;
-        int hi = lo + elem_width - 1;
-        if (is_sub) res(hi, lo) = a(hi, lo) - b(hi, lo);
-        else        res(hi, lo) = a(hi, lo) + b(hi, lo);
-    }
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_add(const vreg_t& a, const vreg_t& b, sew_e sew, bool is_sub) -> vreg_t {
+    vreg_t res;
+    simd::kernel(is_sub ? simd::K_SUB : simd::K_ADD, sew)(res.w, a.w, b.w, vreg_t::NWORDS);
     return res;
 }
 
 // Multiply
-sc_biguint<DLEN> hp_vpu_lanes::alu_mul(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, bool high, bool signed_a, bool signed_b) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width; int hi = lo + elem_width - 1;
-        sc_uint<32> ua = a(hi, lo).to_uint();
-        sc_uint<32> ub = b(hi, lo).to_uint();
-
-        int64_t sa = (sew==SEW_8)?(int64_t)(int8_t)ua : (sew==SEW_16)?(int64_t)(int16_t)ua : (int64_t)(int32_t)ua;
-        int64_t sb = (sew==SEW_8)?(int64_t)(int8_t)ub : (sew==SEW_16)?(int64_t)(int16_t)ub : (int64_t)(int32_t)ub;
-
-        uint64_t prod_u = (uint64_t)ua * (uint64_t)ub;
-        int64_t prod_s = sa * sb;
-        int64_t prod_su = sa * (int64_t)(uint64_t)ub;
-
-        sc_uint<64> final_prod;
-        if (signed_a && signed_b) final_prod = (uint64_t)prod_s;
-        else if (!signed_a && !signed_b) final_prod = prod_u;
-        else final_prod = (uint64_t)prod_su;
-
-        if (high) res(hi, lo) = (final_prod >> elem_width);
-        else      res(hi, lo) = final_prod;
-    }
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_mul(const vreg_t& a, const vreg_t& b, sew_e sew, bool high, bool signed_a, bool signed_b) -> vreg_t {
+    vreg_t res;
+    simd::kop_e k = !high ? simd::K_MUL :                       // Low half is sign-agnostic
+                    (signed_a && signed_b) ? simd::K_MULH :
+                    (!signed_a && !signed_b) ? simd::K_MULHU : simd::K_MULHSU;
+    simd::kernel(k, sew)(res.w, a.w, b.w, vreg_t::NWORDS);
     return res;
 }
 
 // Logic
-sc_biguint<DLEN> hp_vpu_lanes::alu_logic(sc_biguint<DLEN> a, sc_biguint<DLEN> b, vpu_op_e op) {
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_logic(const vreg_t& a, const vreg_t& b, vpu_op_e op) -> vreg_t {
     if (op == OP_VAND) return a & b;
     if (op == OP_VOR)  return a | b;
     if (op == OP_VXOR) return a ^ b;
-    return 0;
+    return vreg_t();
 }
 
 // Shift
-sc_biguint<DLEN> hp_vpu_lanes::alu_shift(sc_biguint<DLEN> val, sc_biguint<DLEN> shamt, sew_e sew, vpu_op_e op) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_shift(const vreg_t& val, const vreg_t& shamt, sew_e sew, vpu_op_e op) -> vreg_t {
+    vreg_t res;
+    int elem_width = sew_bits(sew);
+    int num_elem = DLEN / elem_width;
 
     for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width; int hi = lo + elem_width - 1;
-        sc_uint<32> d = val(hi, lo).to_uint();
-        sc_uint<5>  s = shamt(lo + 4, lo).to_uint();
-
-        if (op == OP_VSLL)      res(hi, lo) = d << s;
-        else if (op == OP_VSRL) res(hi, lo) = d >> s;
-        else if (op == OP_VSRA) {
-             sc_int<32> ds;
-             if (sew == SEW_8) ds = (sc_int<8>)d;
-             else if (sew == SEW_16) ds = (sc_int<16>)d;
-             else ds = (sc_int<32>)d;
-             res(hi, lo) = ds >> s;
-        }
-        else if (op == OP_VSSRL) res(hi, lo) = d >> s;
-        else if (op == OP_VSSRA) {
-             sc_int<32> ds;
-             if (sew == SEW_8) ds = (sc_int<8>)d;
-             else if (sew == SEW_16) ds = (sc_int<16>)d;
-             else ds = (sc_int<32>)d;
-             res(hi, lo) = ds >> s;
-        }
+        uint64_t d = val.elem(i, elem_width);
+        int s = (int)(shamt.elem(i, elem_width) & 0x1F); // 5-bit shamt (as RTL)
+
+        if (op == OP_VSLL)      res.set_elem(i, elem_width, d << s);
+        else if (op == OP_VSRL) res.set_elem(i, elem_width, d >> s);
+        else if (op == OP_VSRA) res.set_elem(i, elem_width, (uint64_t)(sext(d, elem_width) >> s));
+        else if (op == OP_VSSRL) res.set_elem(i, elem_width, d >> s);
+        else if (op == OP_VSSRA) res.set_elem(i, elem_width, (uint64_t)(sext(d, elem_width) >> s));
     }
     return res;
 }
 
 // Saturating Arithmetic
-sc_biguint<DLEN> hp_vpu_lanes::alu_sat(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    sc_uint<32> umax = (1ULL << elem_width) - 1;
-    sc_int<32>  smax = (1ULL << (elem_width - 1)) - 1;
-    sc_int<32>  smin = -(1ULL << (elem_width - 1));
-
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width; int hi = lo + elem_width - 1;
-        sc_uint<32> ua = a(hi, lo).to_uint();
-        sc_uint<32> ub = b(hi, lo).to_uint();
-        sc_int<32> sa = (sew==SEW_8)?(sc_int<32>)(sc_int<8>)ua : (sew==SEW_16)?(sc_int<32>)(sc_int<16>)ua : (sc_int<32>)ua;
-        sc_int<32> sb = (sew==SEW_8)?(sc_int<32>)(sc_int<8>)ub : (sew==SEW_16)?(sc_int<32>)(sc_int<16>)ub : (sc_int<32>)ub;
-
-        if (op == OP_VSADDU) {
-            sc_uint<33> sum = (sc_uint<33>)ua + ub;
-            if (sum > umax) res(hi, lo) = umax; else res(hi, lo) = sum;
-        } else if (op == OP_VSADD) {
-            sc_int<33> sum = (sc_int<33>)sa + sb;
-            if (sum > smax) res(hi, lo) = smax; else if (sum < smin) res(hi, lo) = smin; else res(hi, lo) = sum;
-        } else if (op == OP_VSSUBU) {
-            sc_int<33> diff = (sc_int<33>)ua - ub;
-            if (diff < 0) res(hi, lo) = 0; else res(hi, lo) = diff;
-        } else if (op == OP_VSSUB) {
-            sc_int<33> diff = (sc_int<33>)sa - sb;
-            if (diff > smax) res(hi, lo) = smax; else if (diff < smin) res(hi, lo) = smin; else res(hi, lo) = diff;
-        }
-    }
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_sat(const vreg_t& a, const vreg_t& b, sew_e sew, vpu_op_e op) -> vreg_t {
+    vreg_t res;
+    if (op < OP_VSADDU || op > OP_VSSUB) return res;
+    simd::kernel((simd::kop_e)(simd::K_SADDU + (op - OP_VSADDU)), sew)(res.w, a.w, b.w, vreg_t::NWORDS);
     return res;
 }
 
 // Permutation
-sc_biguint<DLEN> hp_vpu_lanes::alu_permute(sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sc_uint<32> scalar, sew_e sew, vpu_op_e op) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_permute(const vreg_t& vs2, const vreg_t& vs1, sc_uint<32> scalar, sew_e sew, vpu_op_e op) -> vreg_t {
+    vreg_t res;
+    int elem_width = sew_bits(sew);
+    int num_elem = DLEN / elem_width;
 
     if (op == OP_VSLIDEUP || op == OP_VSLIDE1UP) {
-        int offset = (op == OP_VSLIDE1UP) ? 1 : scalar.to_int();
+        // Offsets are unsigned: a negative rs1/imm is a huge slide (zeros)
+        int64_t offset = (op == OP_VSLIDE1UP) ? 1 : (int64_t)scalar.to_uint();
         for (int i=0; i<num_elem; i++) {
-            if (i >= offset) {
-                 int src_idx = i - offset;
-                 res((i+1)*elem_width-1, i*elem_width) = vs2((src_idx+1)*elem_width-1, src_idx*elem_width);
-            }
+            if (i >= offset) res.set_elem(i, elem_width, vs2.elem((int)(i - offset), elem_width));
         }
+        if (op == OP_VSLIDE1UP) res.set_elem(0, elem_width, scalar.to_uint()); // rs1 into vd[0]
     } else if (op == OP_VSLIDEDN || op == OP_VSLIDE1DN) {
-        int offset = (op == OP_VSLIDE1DN) ? 1 : scalar.to_int();
-         for (int i=0; i<num_elem; i++) {
-            if (i + offset < num_elem) {
-                 int src_idx = i + offset;
-                 res((i+1)*elem_width-1, i*elem_width) = vs2((src_idx+1)*elem_width-1, src_idx*elem_width);
-            }
+        int64_t offset = (op == OP_VSLIDE1DN) ? 1 : (int64_t)scalar.to_uint();
+        for (int i=0; i<num_elem; i++) {
+            if (i + offset < num_elem) res.set_elem(i, elem_width, vs2.elem((int)(i + offset), elem_width));
         }
+        if (op == OP_VSLIDE1DN) res.set_elem(num_elem - 1, elem_width, scalar.to_uint()); // rs1 into vd[VLMAX-1]
     } else if (op == OP_VRGATHER) {
         // vs1 holds indices (vector)
         for (int i=0; i<num_elem; i++) {
-            int idx_lo = i*elem_width; int idx_hi = idx_lo+elem_width-1;
-            sc_uint<32> idx = vs1(idx_hi, idx_lo).to_uint();
-            if (idx < num_elem) {
-                int src_idx = idx;
-                res((i+1)*elem_width-1, i*elem_width) = vs2((src_idx+1)*elem_width-1, src_idx*elem_width);
-            } else {
-                res((i+1)*elem_width-1, i*elem_width) = 0;
-            }
+            uint64_t idx = vs1.elem(i, elem_width);
+            res.set_elem(i, elem_width, (idx < (uint64_t)num_elem) ? vs2.elem((int)idx, elem_width) : 0);
         }
     }
     return res;
 }
 
 // Narrowing
-sc_biguint<DLEN> hp_vpu_lanes::alu_narrowing(sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sew_e sew, vpu_op_e op) {
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_narrowing(const vreg_t& vs2, const vreg_t& /*vs1*/, sew_e sew, vpu_op_e /*op*/) -> vreg_t {
     // VNCLIP logic: vs2 is double width source (handled as single here for simplicity or assume packed)
     // Simplified: truncating vs2 to half width.
-    sc_biguint<DLEN> res = 0;
-    // Assume source is packed 2*SEW.
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    // Input elements are double width
-    int in_width = (sew == SEW_8) ? 16 : (sew == SEW_16) ? 32 : 64;
-    int out_width = in_width / 2;
-
     // Note: vs2 in this model is DLEN wide. Can't fit double width elements fully.
-    // Assuming vs2 holds lower half, vs1 holds shift amount?
     // Standard vnclip: vd[i] = clip(vs2[i] >> vs1[i])
-    // If source is double width, it implies input data is wider.
     // For this model, we'll implement simple shifting and truncation.
+    vreg_t res;
+    int out_width = sew_bits(sew);
+    int num_elem = DLEN / out_width;
 
     for (int i=0; i<num_elem; i++) {
         // Mock implementation
-        res((i+1)*out_width-1, i*out_width) = vs2((i+1)*out_width-1, i*out_width);
+        res.set_elem(i, out_width, vs2.elem(i, out_width));
     }
     return res;
 }
 
 // Min/Max
-sc_biguint<DLEN> hp_vpu_lanes::alu_minmax(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width; int hi = lo + elem_width - 1;
-        sc_uint<32> ua = a(hi, lo).to_uint();
-        sc_uint<32> ub = b(hi, lo).to_uint();
-        sc_int<32> sa = (sew==SEW_8)?(sc_int<32>)(sc_int<8>)ua : (sew==SEW_16)?(sc_int<32>)(sc_int<16>)ua : (sc_int<32>)ua;
-        sc_int<32> sb = (sew==SEW_8)?(sc_int<32>)(sc_int<8>)ub : (sew==SEW_16)?(sc_int<32>)(sc_int<16>)ub : (sc_int<32>)ub;
-
-        bool less_u = (ua < ub);
-        bool less_s = (sa < sb);
-
-        if (op == OP_VMINU) res(hi, lo) = less_u ? ua : ub;
-        else if (op == OP_VMIN) res(hi, lo) = less_s ? ua : ub;
-        else if (op == OP_VMAXU) res(hi, lo) = (!less_u) ? ua : ub;
-        else if (op == OP_VMAX) res(hi, lo) = (!less_s) ? ua : ub;
-    }
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_minmax(const vreg_t& a, const vreg_t& b, sew_e sew, vpu_op_e op) -> vreg_t {
+    vreg_t res;
+    if (op < OP_VMINU || op > OP_VMAX) return res;
+    simd::kernel((simd::kop_e)(simd::K_MINU + (op - OP_VMINU)), sew)(res.w, a.w, b.w, vreg_t::NWORDS);
     return res;
 }
 
 // Comparison (Packed Output)
-sc_biguint<DLEN> hp_vpu_lanes::alu_cmp(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
-
-    for (int i = 0; i < num_elem; ++i) {
-        int lo = i * elem_width; int hi = lo + elem_width - 1;
-        sc_uint<32> ua = a(hi, lo).to_uint();
-        sc_uint<32> ub = b(hi, lo).to_uint();
-        sc_int<32> sa = (sew==SEW_8)?(sc_int<32>)(sc_int<8>)ua : (sew==SEW_16)?(sc_int<32>)(sc_int<16>)ua : (sc_int<32>)ua;
-        sc_int<32> sb = (sew==SEW_8)?(sc_int<32>)(sc_int<8>)ub : (sew==SEW_16)?(sc_int<32>)(sc_int<16>)ub : (sc_int<32>)ub;
-
-        bool bit = false;
-        if (op == OP_VMSEQ) bit = (ua == ub);
-        else if (op == OP_VMSNE) bit = (ua != ub);
-        else if (op == OP_VMSLTU) bit = (ua < ub);
-        else if (op == OP_VMSLT) bit = (sa < sb);
-        else if (op == OP_VMSLEU) bit = (ua <= ub);
-        else if (op == OP_VMSLE) bit = (sa <= sb);
-        else if (op == OP_VMSGTU) bit = (ua > ub);
-        else if (op == OP_VMSGT) bit = (sa > sb);
-
-        res[i] = bit; // Packed LSB
-    }
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_cmp(const vreg_t& a, const vreg_t& b, sew_e sew, vpu_op_e op) -> vreg_t {
+    vreg_t res;
+    if (op < OP_VMSEQ || op > OP_VMSGT) return res;
+    simd::kernel((simd::kop_e)(simd::K_MSEQ + (op - OP_VMSEQ)), sew)(res.w, a.w, b.w, vreg_t::NWORDS); // Packed LSB
     return res;
 }
 
 // LUT implementation
-sc_biguint<DLEN> hp_vpu_lanes::alu_lut(vpu_op_e op, sc_biguint<DLEN> idx, sew_e sew) {
-    sc_biguint<DLEN> res = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int idx_stride = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_lut(vpu_op_e op, const vreg_t& idx, sew_e sew) -> vreg_t {
+    vreg_t res;
+    int elem_width = sew_bits(sew);
+    int num_elem = DLEN / elem_width;
 
     for (int i = 0; i < num_elem; ++i) {
-        int idx_lo = i * idx_stride; int idx_hi = idx_lo + 7;
-        sc_uint<8> index = idx(idx_hi, idx_lo).to_uint();
-        sc_uint<16> val = 0;
+        uint32_t index = (uint32_t)(idx.elem(i, elem_width) & 0xFF); // Index is low byte
+        uint32_t val = 0;
 
         if (op == OP_VEXP) val = index + 1;
         else if (op == OP_VRECIP) val = (index == 0) ? 0xFFFF : (32768 / index);
         else if (op == OP_VRSQRT) val = (index == 0) ? 0xFFFF : (16384 / (int)sqrt(index));
         else if (op == OP_VGELU) val = index;
 
-        int res_lo = i * ((sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32);
-        int res_hi = res_lo + ((sew == SEW_8) ? 7 : (sew == SEW_16) ? 15 : 31);
-
-        if (sew == SEW_8) res(res_hi, res_lo) = val(7, 0);
-        else res(res_hi, res_lo) = val;
+        res.set_elem(i, elem_width, val & 0xFFFF); // 16-bit LUT entry, truncated at SEW=8
     }
     return res;
 }
 
-sc_biguint<DLEN> hp_vpu_lanes::alu_int4(sc_biguint<DLEN> val, vpu_op_e op) {
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::alu_int4(const vreg_t& val, vpu_op_e /*op*/) -> vreg_t {
     return val;
 }
 
-sc_biguint<DLEN> hp_vpu_lanes::apply_mask(sc_biguint<DLEN> res, sc_biguint<DLEN> old_vd, sc_biguint<DLEN> mask, bool vm, sew_e sew) {
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::apply_mask(const vreg_t& res, const vreg_t& old_vd, const vreg_t& mask, bool vm, sew_e sew) -> vreg_t {
     if (vm) return res;
-    sc_biguint<DLEN> out = 0;
-    int num_elem = (sew == SEW_8) ? DLEN/8 : (sew == SEW_16) ? DLEN/16 : DLEN/32;
-    int elem_width = (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
+    vreg_t out;
+    int elem_width = sew_bits(sew);
+    int num_elem = DLEN / elem_width;
     for (int i=0; i<num_elem; i++) {
-        int lo = i*elem_width, hi=lo+elem_width-1;
-        if (mask[i]) out(hi,lo) = res(hi,lo);
-        else         out(hi,lo) = old_vd(hi,lo);
+        out.set_elem(i, elem_width, mask.bit(i) ? res.elem(i, elem_width) : old_vd.elem(i, elem_width));
     }
     return out;
 }
 
 
-void hp_vpu_lanes::logic_thread() {
-    e1_valid.write(false);
-    e1m_valid.write(false);
-    e2_valid.write(false);
-    e3_valid.write(false);
+// ----------------------------------------------------------------------
+// Stage datapaths (static, shared with the functional model hp_vpu_func)
+// ----------------------------------------------------------------------
 
-    red_state.write(RED_IDLE);
-    wide_state.write(WIDE_IDLE);
-    r3_valid.write(false);
-    w2_valid.write(false);
+// E2 single-cycle ALU, unit selected at decode
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::exec_alu(exec_unit_e unit, vpu_op_e op, sew_e sew, const vreg_t& a, const vreg_t& b, sc_uint<32> scalar) -> vreg_t {
+    switch (unit) {
+        case EU_ADD:    return alu_add(a, b, sew, false);
+        case EU_SUB:    return alu_add(a, b, sew, true);
+        case EU_LOGIC:  return alu_logic(a, b, op);
+        case EU_SHIFT:  return alu_shift(a, b, sew, op);
+        case EU_MINMAX: return alu_minmax(a, b, sew, op);
+        case EU_SAT:    return alu_sat(a, b, sew, op);
+        case EU_CMP:    return alu_cmp(a, b, sew, op);
+        case EU_PERM:   return alu_permute(a, b, scalar, sew, op);
+        case EU_NARROW: return alu_narrowing(a, b, sew, op);
+        case EU_LUT:    return alu_lut(op, a, sew);
+        case EU_INT4:   return alu_int4(a, op);
+        case EU_MOVE:   return b;
+        default:        return vreg_t();
+    }
+}
+
+// E1m product (VMADD/VNMSUB multiply vs1 by old vd)
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::exec_mul(vpu_op_e op, sew_e sew, const vreg_t& a, const vreg_t& b, const vreg_t& c) -> vreg_t {
+    bool high = (op == OP_VMULH || op == OP_VMULHU || op == OP_VMULHSU);
+    bool sa = (op == OP_VMULH || op == OP_VMULHSU || op == OP_VMUL);
+    bool sb = (op == OP_VMULH || op == OP_VMUL);
+    if (op == OP_VMULHU) { sa = false; sb = false; }
+    if (op == OP_VMULHSU) { sa = true; sb = false; }
+
+    if (op == OP_VMADD || op == OP_VNMSUB) return alu_mul(b, c, sew, high, sa, sb);
+    return alu_mul(a, b, sew, high, sa, sb);
+}
 
-    wait();
+// E2 accumulate for MAC ops (plain multiplies pass the product through)
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::exec_mac(vpu_op_e op, sew_e sew, const vreg_t& prod, const vreg_t& a, const vreg_t& c) -> vreg_t {
+    if (op == OP_VMACC) return alu_add(prod, c, sew, false);
+    if (op == OP_VNMSAC) return alu_add(c, prod, sew, true);
+    if (op == OP_VMADD) return alu_add(prod, a, sew, false);
+    if (op == OP_VNMSUB) return alu_add(a, prod, sew, true);
+    return prod;
+}
 
-    while (true) {
-        if (stall_i.read()) {
-            wait();
-            continue;
-        }
+// One reduction step (all reduction ops are associative and commutative)
+template<class CFG>
+uint64_t hp_vpu_lanes_t<CFG>::red_combine(vpu_op_e op, uint64_t a, uint64_t b, int width) {
+    bool less_u = (a < b);
+    bool less_s = (sext(a, width) < sext(b, width));
+
+    if (op == OP_VREDSUM) a = a + b;
+    else if (op == OP_VREDMINU) a = less_u ? a : b;
+    else if (op == OP_VREDMIN)  a = less_s ? a : b;
+    else if (op == OP_VREDMAXU) a = (!less_u) ? a : b;
+    else if (op == OP_VREDMAX)  a = (!less_s) ? a : b;
+    else if (op == OP_VREDAND)  a = a & b;
+    else if (op == OP_VREDOR)   a = a | b;
+    else if (op == OP_VREDXOR)  a = a ^ b;
+    else a = 0;
+    return a & vreg_t::width_mask(width);
+}
+
+// R2B: each lane folds its own slice, a log2(NLANES) tree combines the lane
+// partials, then vs1[0]. Upper elements of vs1 pass through.
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::exec_reduction(vpu_op_e op, sew_e sew, const vreg_t& src, const vreg_t& init) -> vreg_t {
+    vreg_t acc = init;
+    int elem_width = sew_bits(sew);
+    int per_lane = 64 / elem_width;
+
+    uint64_t part[NLANES];
+    for (int l = 0; l < NLANES; l++) {
+        part[l] = src.elem(l * per_lane, elem_width);
+        for (int i = 1; i < per_lane; i++)
+            part[l] = red_combine(op, part[l], src.elem(l * per_lane + i, elem_width), elem_width);
+    }
+    for (int stride = 1; stride < NLANES; stride *= 2)
+        for (int l = 0; l + stride < NLANES; l += 2 * stride)
+            part[l] = red_combine(op, part[l], part[l + stride], elem_width);
+
+    acc.set_elem(0, elem_width, red_combine(op, acc.elem(0, elem_width), part[0], elem_width));
+    return acc;
+}
 
-        // --- E3 (WB) Stage ---
-        // Capture E2 output
-        bool e2_v = e2_valid.read();
-        e3_valid.write(e2_v);
-        if (e2_v) {
-            e3_result = e2_result;
-            e3_vd = e2_vd;
-            e3_id = e2_id;
-            e3_is_last_uop = e2_is_last_uop;
+template<class CFG>
+int hp_vpu_lanes_t<CFG>::xbar_route(const vreg_t& vs1, sc_uint<32> scalar, sew_e sew, vpu_op_e op, uint64_t* xlane) {
+    int elem_width = sew_bits(sew);
+    int num_elem = DLEN / elem_width;
+    int per_lane = 64 / elem_width;
+    int64_t offset = 0;
+    if (op == OP_VSLIDEUP) offset = -(int64_t)scalar.to_uint();
+    else if (op == OP_VSLIDE1UP) offset = -1;
+    else if (op == OP_VSLIDEDN) offset = scalar.to_uint();
+    else if (op == OP_VSLIDE1DN) offset = 1;
+
+    uint32_t sources[NLANES] = {}; // Source lane set per destination lane
+    int packed = 0;                // VCOMPRESS: active elements so far
+    for (int i = 0; i < num_elem; i++) {
+        int64_t d = i, j = i; // Destination element d reads source element j
+        if (op == OP_VRGATHER) j = (int64_t)vs1.elem(i, elem_width);
+        else if (op == OP_VRGATHEREI16) j = (int64_t)vs1.elem(elem_width == 8 ? i / 2 : i, 16); // SEW=8 pairs share an index (RTL)
+        else if (op == OP_VCOMPRESS) {
+            if (!vs1.bit(i)) continue; // Inactive: nothing routed
+            d = packed++;              // Active: packed at the prefix count
         }
+        else if (op == OP_VSLIDEUP || op == OP_VSLIDE1UP || op == OP_VSLIDEDN || op == OP_VSLIDE1DN) j = i + offset;
+        if (j < 0 || j >= num_elem) continue; // Zero fill, nothing routed
+        int dst = (int)(d / per_lane), s = (int)(j / per_lane);
+        sources[dst] |= 1u << s;
+        if (s != dst) (*xlane)++;
+    }
+    int passes = 1;
+    for (int l = 0; l < NLANES; l++) passes = std::max(passes, __builtin_popcount(sources[l]));
+    return passes;
+}
 
-        // --- E2 Stage (ALU / Handoff from E1m) ---
-        // Priority: E1m (Multicycle) > E1 (Single cycle)
-
-        bool e1_is_mul = (e1_op == OP_VMUL || e1_op == OP_VMACC || e1_op == OP_VMADD ||
-                          e1_op == OP_VNMSAC || e1_op == OP_VNMSUB ||
-                          e1_op == OP_VMULH || e1_op == OP_VMULHU || e1_op == OP_VMULHSU);
-
-        bool e1m_v = e1m_valid.read();
-        bool e1_v = e1_valid.read();
-
-        if (e1m_v) {
-            e2_valid.write(true);
-            e2_op = e1m_op;
-            e2_sew = e1m_sew;
-            e2_vd = e1m_vd;
-            e2_id = e1m_id;
-            e2_is_last_uop = e1m_is_last_uop;
-
-            sc_biguint<DLEN> raw_res;
-            if (e1m_op == OP_VMACC) raw_res = alu_add(e1m_mul_res, e1m_c, e1m_sew, false);
-            else if (e1m_op == OP_VNMSAC) raw_res = alu_add(e1m_c, e1m_mul_res, e1m_sew, true);
-            else if (e1m_op == OP_VMADD) raw_res = alu_add(e1m_mul_res, e1m_a, e1m_sew, false);
-            else if (e1m_op == OP_VNMSUB) raw_res = alu_add(e1m_a, e1m_mul_res, e1m_sew, true);
-            else raw_res = e1m_mul_res;
-
-            e2_result = raw_res;
-            e1m_valid.write(false);
+// W1: 2*SEW results from the low elements of both sources
+template<class CFG>
+auto hp_vpu_lanes_t<CFG>::exec_widening(vpu_op_e op, sew_e sew, const vreg_t& s1, const vreg_t& s2) -> vreg_t {
+    vreg_t res;
+    int in_width = sew_bits(sew);
+    int out_width = in_width * 2;
+    int num_elem = DLEN / out_width;
+
+    for(int i=0; i<num_elem; i++) {
+        uint64_t s1_u = s1.elem(i, in_width);
+        uint64_t s2_u = s2.elem(i, in_width);
+        int64_t s1_s = sext(s1_u, in_width);
+        int64_t s2_s = sext(s2_u, in_width);
+
+        uint64_t elem_res = 0;
+        if (op == OP_VWMUL) {
+            elem_res = (uint64_t)(s1_s * s2_s);
+        } else if (op == OP_VWMULU) {
+            elem_res = s1_u * s2_u;
+        } else if (op == OP_VWADD) {
+            elem_res = (uint64_t)(s1_s + s2_s);
         }
-        else if (e1_v && !e1_is_mul) {
-            e2_valid.write(true);
-            e2_op = e1_op;
-            e2_sew = e1_sew;
-            e2_vd = e1_vd;
-            e2_id = e1_id;
-            e2_is_last_uop = e1_is_last_uop;
-
-            sc_biguint<DLEN> raw_res;
-
-            // Dispatch to ALU
-            if (e1_op == OP_VADD) raw_res = alu_add(e1_a, e1_b, e1_sew, false);
-            else if (e1_op == OP_VSUB || e1_op == OP_VRSUB) raw_res = alu_add(e1_a, e1_b, e1_sew, true);
-            else if (e1_op == OP_VAND || e1_op == OP_VOR || e1_op == OP_VXOR)
-                 raw_res = alu_logic(e1_a, e1_b, e1_op);
-            else if (e1_op == OP_VSLL || e1_op == OP_VSRL || e1_op == OP_VSRA || e1_op == OP_VSSRL || e1_op == OP_VSSRA)
-                 raw_res = alu_shift(e1_a, e1_b, e1_sew, e1_op);
-            else if (e1_op >= OP_VMINU && e1_op <= OP_VMAX)
-                 raw_res = alu_minmax(e1_a, e1_b, e1_sew, e1_op);
-            else if (e1_op >= OP_VSADDU && e1_op <= OP_VSSUB)
-                raw_res = alu_sat(e1_a, e1_b, e1_sew, e1_op);
-            else if (e1_op >= OP_VMSEQ && e1_op <= OP_VMSGT)
-                raw_res = alu_cmp(e1_a, e1_b, e1_sew, e1_op);
-            else if (e1_op >= OP_VSLIDEUP && e1_op <= OP_VRGATHEREI16)
-                raw_res = alu_permute(e1_a, e1_b, scalar_i.read(), e1_sew, e1_op);
-            else if (e1_op >= OP_VNSRL && e1_op <= OP_VNCLIP)
-                raw_res = alu_narrowing(e1_a, e1_b, e1_sew, e1_op);
-            else if (e1_op >= OP_VEXP && e1_op <= OP_VGELU)
-                raw_res = alu_lut(e1_op, e1_a, e1_sew);
-            else if (e1_op == OP_VPACK4 || e1_op == OP_VUNPACK4)
-                raw_res = alu_int4(e1_a, e1_op);
-            else if (e1_op == OP_VMV || e1_op == OP_VMERGE)
-                raw_res = e1_b;
-            else raw_res = 0;
-
-            // Apply Masking here or at E3? Spec says "RTL applies masking at E2->E3".
-            // We'll calculate masked result here and store in e2_result.
-            bool is_cmp = (e1_op >= OP_VMSEQ && e1_op <= OP_VMSGT);
-            if (!is_cmp) {
-                // We need the mask. E1 should have captured it.
-                // Assuming vmask_i is valid for the op in E1?
-                // No, vmask_i comes from decode. We need to pipeline mask through E1.
-                // For this model update, we'll assume e1_c holds old_vd and we access global input mask (not cycle accurate for pipelining but functional).
-                // Ideally e1_mask should exist.
-                e2_result = apply_mask(raw_res, e1_c, vmask_i.read(), vm_i.read(), e1_sew);
-            } else {
-                e2_result = raw_res; // Packed mask bits
-            }
 
-            e1_valid.write(false);
+        res.set_elem(i, out_width, elem_res);
+    }
+    return res;
+}
+
+template<class CFG>
+bool hp_vpu_lanes_t<CFG>::can_accept(uop_class_e cls) const {
+    // FSM results share the writeback port with E3: nothing enters
+    // while a reduction, widening or crossbar permute is in flight
+    if (red_state.read() != RED_IDLE || wide_state.read() != WIDE_IDLE || perm_state.read() != PERM_IDLE) return false;
+
+    bool e1_v = e1_valid.read();
+    bool e1m_v = e1m_valid.read();
+    if (cls == UC_RED || cls == UC_WIDE || uses_xbar(cls)) return !e1_v && !e1m_v && !e2_valid.read();
+
+    // E1 empties this edge unless a single-cycle op waits behind E1m
+    return !e1_v || e1_class == UC_MUL || !e1m_v;
+}
+
+template<class CFG>
+void hp_vpu_lanes_t<CFG>::pipeline_logic() {
+    HP_VPU_PROF_SCOPE(PROF_LANES_PIPELINE);
+    if (!rst_n.read()) {
+        e1_valid.write(false);
+        e1m_valid.write(false);
+        e2_valid.write(false);
+        e3_valid.write(false);
+
+        red_state.write(RED_IDLE);
+        wide_state.write(WIDE_IDLE);
+        perm_state.write(PERM_IDLE);
+        r3_valid.write(false);
+        w2_valid.write(false);
+        xw_valid.write(false);
+        return;
+    }
+
+    if (stall_i.read()) return;
+
+    // Decided on the pre-edge state, before any stage below moves
+    uop_class_e class_in = (uop_class_e)uclass_i.read();
+    bool accept = valid_i.read() && can_accept(class_in);
+
+    // --- E3 (WB) Stage ---
+    // Capture E2 output
+    bool e2_v = e2_valid.read();
+    e3_valid.write(e2_v);
+    if (e2_v) {
+        e3_result = e2_result;
+        e3_vd = e2_vd;
+        e3_id = e2_id;
+        e3_is_last_uop = e2_is_last_uop;
+    }
+
+    // --- E2 Stage (ALU / Handoff from E1m) ---
+    // Priority: E1m (Multicycle) > E1 (Single cycle)
+
+    bool e1_is_mul = (e1_class == UC_MUL);
+
+    bool e1m_v = e1m_valid.read();
+    bool e1_v = e1_valid.read();
+
+    if (e1m_v) {
+        e2_valid.write(true);
+        e2_op = e1m_op;
+        e2_sew = e1m_sew;
+        e2_vd = e1m_vd;
+        e2_id = e1m_id;
+        e2_is_last_uop = e1m_is_last_uop;
+
+        e2_result = apply_mask(exec_mac(e1m_op, e1m_sew, e1m_mul_res, e1m_a, e1m_c), e1m_c, e1m_mask, e1m_vm, e1m_sew);
+        e1m_valid.write(false);
+    }
+    else if (e1_v && !e1_is_mul) {
+        e2_valid.write(true);
+        e2_op = e1_op;
+        e2_sew = e1_sew;
+        e2_vd = e1_vd;
+        e2_id = e1_id;
+        e2_is_last_uop = e1_is_last_uop;
+
+        // Dispatch to ALU (unit selected at decode)
+        vreg_t raw_res = exec_alu(e1_unit, e1_op, e1_sew, e1_a, e1_b, e1_scalar);
+
+        // Masking at E2 with the mask, vm and old vd (e1_c) captured in E1:
+        // the vm_i/vmask_i/scalar_i inputs already belong to the next op
+        if (e1_class != UC_MASK) {
+            e2_result = apply_mask(raw_res, e1_c, e1_mask, e1_vm, e1_sew);
         } else {
-            e2_valid.write(false);
+            e2_result = raw_res; // Packed mask bits
         }
 
-        // --- E1m Stage (Multiply) ---
-        if (e1_v && e1_is_mul) {
-            e1m_valid.write(true);
-            e1m_op = e1_op;
-            e1m_sew = e1_sew;
-            e1m_vd = e1_vd;
-            e1m_id = e1_id;
-            e1m_is_last_uop = e1_is_last_uop;
-            e1m_c = e1_c;
-            e1m_a = e1_a;
-
-            bool high = (e1_op == OP_VMULH || e1_op == OP_VMULHU || e1_op == OP_VMULHSU);
-            bool sa = (e1_op == OP_VMULH || e1_op == OP_VMULHSU || e1_op == OP_VMUL);
-            bool sb = (e1_op == OP_VMULH || e1_op == OP_VMUL);
-            if (e1_op == OP_VMULHU) { sa = false; sb = false; }
-            if (e1_op == OP_VMULHSU) { sa = true; sb = false; }
-
-            if (e1_op == OP_VMADD || e1_op == OP_VNMSUB) {
-                 e1m_mul_res = alu_mul(e1_b, e1_c, e1_sew, high, sa, sb);
-            } else {
-                 e1m_mul_res = alu_mul(e1_a, e1_b, e1_sew, high, sa, sb);
-            }
+        e1_valid.write(false);
+    } else {
+        e2_valid.write(false);
+    }
 
-            e1_valid.write(false);
-        }
+    // --- E1m Stage (Multiply) ---
+    if (e1_v && e1_is_mul) {
+        e1m_valid.write(true);
+        e1m_op = e1_op;
+        e1m_sew = e1_sew;
+        e1m_vd = e1_vd;
+        e1m_id = e1_id;
+        e1m_is_last_uop = e1_is_last_uop;
+        e1m_c = e1_c;
+        e1m_a = e1_a;
+        e1m_mask = e1_mask;
+        e1m_vm = e1_vm;
+
+        e1m_mul_res = exec_mul(e1_op, e1_sew, e1_a, e1_b, e1_c);
+
+        e1_valid.write(false);
+    }
 
-        // --- E1 Stage (Input Capture) ---
-        bool input_valid = valid_i.read();
-        vpu_op_e op_in = (vpu_op_e)op_i.read();
-        bool is_red = is_reduction(op_in);
-        bool is_wide = is_widening(op_in);
-
-        bool pipeline_drained = !e1_v && !e1m_v && !e2_v; // Use local read vars
-
-        if (input_valid) {
-            if (is_red && red_state.read() == RED_IDLE && pipeline_drained) {
-                red_state.write(RED_R1);
-                r3_vd = vd_i.read();
-                r3_id = id_i.read();
-                r_op = op_in;
-                r_sew = (sew_e)sew_i.read();
-                r_src = vs2_i.read();
-                r_init = vs1_i.read();
-            }
-            else if (is_wide && wide_state.read() == WIDE_IDLE && pipeline_drained) {
-                wide_state.write(WIDE_W1);
-                w2_vd = vd_i.read();
-                w2_id = id_i.read();
-                w_op = op_in;
-                w_sew = (sew_e)sew_i.read();
-                w_src1 = vs2_i.read();
-                if (is_vx_i.read()) {
-                     sc_uint<32> s = scalar_i.read();
-                     for (int k=0; k<DLEN/8; k++) w_src2(k*8+7, k*8) = s(7,0);
-                } else {
-                     w_src2 = vs1_i.read();
-                }
-            }
-            else if (!is_red && !is_wide && !e1_v) {
-               e1_valid.write(true);
-               e1_op = op_in;
-               e1_sew = (sew_e)sew_i.read();
-               e1_vd = vd_i.read();
-               e1_id = id_i.read();
-               e1_is_last_uop = is_last_uop_i.read();
-
-               sc_biguint<DLEN> op_a = vs2_i.read();
-               sc_biguint<DLEN> op_b;
-               if (is_vx_i.read()) {
-                   sc_uint<32> s = scalar_i.read();
-                   for (int k=0; k<DLEN/8; k++) {
-                       if (sew_i.read() == SEW_8)  op_b(k*8+7, k*8) = s(7,0);
-                       else if (sew_i.read() == SEW_16) op_b(k*8+7, k*8) = s((k%2)*8+7, (k%2)*8);
-                       else op_b(k*8+7, k*8) = s((k%4)*8+7, (k%4)*8);
-                   }
-               } else {
-                   op_b = vs1_i.read();
-               }
-               e1_a = op_a;
-               e1_b = op_b;
-               e1_c = vs3_i.read();
+    // --- E1 Stage (Input Capture) ---
+    vpu_op_e op_in = (vpu_op_e)op_i.read();
+
+    if (accept) {
+        if (class_in == UC_RED) {
+            red_state.write(RED_R1);
+            r3_vd = vd_i.read();
+            r3_id = id_i.read();
+            r_op = op_in;
+            r_sew = (sew_e)sew_i.read();
+            r_src = vs2_i.read();
+            r_init = vs1_i.read();
+        }
+        else if (class_in == UC_WIDE) {
+            wide_state.write(WIDE_W1);
+            w2_vd = vd_i.read();
+            w2_id = id_i.read();
+            w_op = op_in;
+            w_sew = (sew_e)sew_i.read();
+            w_src1 = vs2_i.read();
+            if (is_vx_i.read()) {
+                 w_src2.broadcast(8, scalar_i.read());
+            } else {
+                 w_src2 = vs1_i.read();
             }
         }
-
-        // --- Reduction Pipeline ---
-        switch (red_state.read()) {
-            case RED_R1:  red_state.write(RED_R2A); break;
-            case RED_R2A: red_state.write(RED_R2B); break;
-            case RED_R2B:
-                red_state.write(RED_R3);
-                r3_valid = true;
-                {
-                    sc_biguint<DLEN> acc = r_init;
-                    int num_elem = (r_sew == SEW_8) ? DLEN/8 : (r_sew == SEW_16) ? DLEN/16 : DLEN/32;
-                    int elem_width = (r_sew == SEW_8) ? 8 : (r_sew == SEW_16) ? 16 : 32;
-
-                    for(int i=0; i<num_elem; i++) {
-                        int lo = i*elem_width, hi = lo+elem_width-1;
-                        sc_biguint<DLEN> op1 = 0; op1(elem_width-1, 0) = acc(elem_width-1, 0);
-                        sc_biguint<DLEN> op2 = 0; op2(elem_width-1, 0) = r_src(hi, lo);
-                        sc_biguint<DLEN> res = 0;
-
-                        if (r_op == OP_VREDSUM) {
-                            res = alu_add(op1, op2, r_sew, false);
-                        } else if (r_op >= OP_VREDMINU && r_op <= OP_VREDMAX) {
-                            vpu_op_e minmax_op = (r_op == OP_VREDMAX) ? OP_VMAX : (r_op == OP_VREDMAXU) ? OP_VMAXU : (r_op == OP_VREDMIN) ? OP_VMIN : OP_VMINU;
-                            res = alu_minmax(op1, op2, r_sew, minmax_op);
-                        } else if (r_op >= OP_VREDAND && r_op <= OP_VREDXOR) {
-                            vpu_op_e log_op = (r_op == OP_VREDAND) ? OP_VAND : (r_op == OP_VREDOR) ? OP_VOR : OP_VXOR;
-                            res = alu_logic(op1, op2, log_op);
-                        }
-                        acc(elem_width-1, 0) = res(elem_width-1, 0);
-                    }
-                    r3_result = acc;
-                }
-                break;
-            case RED_R3:
-                red_state.write(RED_IDLE);
-                r3_valid.write(false);
-                break;
-            default: break;
+        else if (uses_xbar(class_in)) {
+            perm_state.write(PERM_X);
+            xw_vd = vd_i.read();
+            xw_id = id_i.read();
+            xw_is_last_uop = is_last_uop_i.read();
+            x_op = op_in;
+            x_unit = (exec_unit_e)unit_i.read();
+            x_sew = (sew_e)sew_i.read();
+            x_a = vs2_i.read();
+            if (is_vx_i.read()) x_b.broadcast(sew_bits(sew_i.read()), scalar_i.read());
+            else x_b = vs1_i.read();
+            x_c = vs3_i.read();
+            x_mask = vmask_i.read();
+            x_vm = vm_i.read();
+            x_scalar = scalar_i.read();
+
+            int passes = xbar_route(x_b, x_scalar, x_sew, x_op, &xbar_xlane_elems);
+            x_left = timing.xbar_lat + passes;
+            xbar_ops++;
+            xbar_passes += passes;
         }
+        else {
+           e1_valid.write(true);
+           e1_op = op_in;
+           e1_class = class_in;
+           e1_unit = (exec_unit_e)unit_i.read();
+           e1_sew = (sew_e)sew_i.read();
+           e1_vd = vd_i.read();
+           e1_id = id_i.read();
+           e1_is_last_uop = is_last_uop_i.read();
+
+           vreg_t op_a = vs2_i.read();
+           vreg_t op_b;
+           if (is_vx_i.read()) {
+               op_b.broadcast(sew_bits(sew_i.read()), scalar_i.read());
+           } else {
+               op_b = vs1_i.read();
+           }
+           e1_a = op_a;
+           e1_b = op_b;
+           e1_c = vs3_i.read();
+           e1_mask = vmask_i.read();
+           e1_vm = vm_i.read();
+           e1_scalar = scalar_i.read();
+        }
+    }
 
-        // --- Widening Pipeline ---
-        switch (wide_state.read()) {
-            case WIDE_W1:
-                wide_state.write(WIDE_W2);
-                w2_valid = true;
-                {
-                    sc_biguint<DLEN> res = 0;
-                    int num_elem = (w_sew == SEW_8) ? DLEN/16 : (w_sew == SEW_16) ? DLEN/32 : DLEN/64;
-                    int in_width = (w_sew == SEW_8) ? 8 : (w_sew == SEW_16) ? 16 : 32;
-                    int out_width = in_width * 2;
-
-                    for(int i=0; i<num_elem; i++) {
-                        int lo = i*in_width; int hi = lo+in_width-1;
-                        sc_int<64> s1_s; sc_uint<64> s1_u;
-                        sc_int<64> s2_s; sc_uint<64> s2_u;
-
-                        if (w_sew==SEW_8) { s1_s = (sc_int<8>)w_src1(hi,lo).to_uint(); s2_s = (sc_int<8>)w_src2(hi,lo).to_uint(); }
-                        else if (w_sew==SEW_16) { s1_s = (sc_int<16>)w_src1(hi,lo).to_uint(); s2_s = (sc_int<16>)w_src2(hi,lo).to_uint(); }
-                        else { s1_s = (sc_int<32>)w_src1(hi,lo).to_uint(); s2_s = (sc_int<32>)w_src2(hi,lo).to_uint(); }
-
-                        s1_u = w_src1(hi,lo).to_uint(); s2_u = w_src2(hi,lo).to_uint();
-
-                        sc_biguint<64> elem_res = 0;
-                        if (w_op == OP_VWMUL) {
-                            elem_res = (sc_int<64>)s1_s * (sc_int<64>)s2_s;
-                        } else if (w_op == OP_VWMULU) {
-                            elem_res = (sc_uint<64>)s1_u * (sc_uint<64>)s2_u;
-                        } else if (w_op == OP_VWADD) {
-                            elem_res = (sc_int<64>)s1_s + (sc_int<64>)s2_s;
-                        }
-
-                        int out_lo = i*out_width;
-                        int out_hi = out_lo+out_width-1;
-                        res(out_hi, out_lo) = elem_res(out_width-1, 0);
-                    }
-                    w2_result = res;
-                }
-                break;
-            case WIDE_W2:
-                wide_state.write(WIDE_IDLE);
-                w2_valid.write(false);
+    // --- Reduction Pipeline ---
+    switch (red_state.read()) {
+        case RED_R1:  red_state.write(RED_R2A); break;
+        case RED_R2A: red_state.write(RED_R2B); break;
+        case RED_R2B:
+            // Lane partials go through the cross-lane tree when it is timed
+            r_xl_left = CFG::RED_TREE_LEVELS * timing.red_level_lat;
+            if (r_xl_left > 0) {
+                red_state.write(RED_XL);
                 break;
-             default: break;
-        }
+            }
+            red_state.write(RED_R3);
+            r3_valid = true;
+            r3_result = exec_reduction(r_op, r_sew, r_src, r_init);
+            break;
+        case RED_XL:
+            red_tree_cycles++;
+            if (--r_xl_left > 0) break;
+            red_state.write(RED_R3);
+            r3_valid = true;
+            r3_result = exec_reduction(r_op, r_sew, r_src, r_init);
+            break;
+        case RED_R3:
+            red_state.write(RED_IDLE);
+            r3_valid.write(false);
+            break;
+        default: break;
+    }
 
-        wait();
+    // --- Widening Pipeline ---
+    switch (wide_state.read()) {
+        case WIDE_W1:
+            wide_state.write(WIDE_W2);
+            w2_valid = true;
+            w2_result = exec_widening(w_op, w_sew, w_src1, w_src2);
+            break;
+        case WIDE_W2:
+            wide_state.write(WIDE_IDLE);
+            w2_valid.write(false);
+            break;
+         default: break;
+    }
+
+    // --- Permute Crossbar ---
+    switch (perm_state.read()) {
+        case PERM_X:
+            if (--x_left > 0) break;
+            perm_state.write(PERM_XW);
+            xw_valid = true;
+            xw_result = apply_mask(exec_alu(x_unit, x_op, x_sew, x_a, x_b, x_scalar), x_c, x_mask, x_vm, x_sew);
+            break;
+        case PERM_XW:
+            perm_state.write(PERM_IDLE);
+            xw_valid.write(false);
+            break;
+        default: break;
     }
 }
 
-void hp_vpu_lanes::outputs_method() {
+template<class CFG>
+void hp_vpu_lanes_t<CFG>::outputs_method() {
+    HP_VPU_PROF_SCOPE(PROF_LANES_OUTPUT);
     if (w2_valid.read()) {
         valid_o.write(true);
         result_o.write(w2_result);
         vd_o.write(w2_vd);
         id_o.write(w2_id);
         is_last_uop_o.write(true);
+    } else if (xw_valid.read()) {
+        valid_o.write(true);
+        result_o.write(xw_result);
+        vd_o.write(xw_vd);
+        id_o.write(xw_id);
+        is_last_uop_o.write(xw_is_last_uop);
     } else if (r3_valid.read()) {
         valid_o.write(true);
         result_o.write(r3_result);
@@ -609,20 +604,27 @@ void hp_vpu_lanes::outputs_method() {
 
     bool red_busy = (red_state.read() != RED_IDLE);
     bool wide_busy = (wide_state.read() != WIDE_IDLE);
+    bool perm_busy = (perm_state.read() != PERM_IDLE);
     bool mul_stall = (e1_valid.read() && e1m_valid.read());
 
     mul_stall_o.write(mul_stall);
     mac_stall_o.write(false);
-    multicycle_busy_o.write(red_busy || wide_busy || mul_stall);
+    multicycle_busy_o.write(red_busy || wide_busy || perm_busy || mul_stall);
 
     // Drain Stall Logic
     bool input_valid = valid_i.read();
-    vpu_op_e op_in = (vpu_op_e)op_i.read();
-    bool is_red = is_reduction(op_in);
-    bool is_wide = is_widening(op_in);
+    uop_class_e class_in = (uop_class_e)uclass_i.read();
+    bool is_red = (class_in == UC_RED);
+    bool is_wide = (class_in == UC_WIDE);
     bool pipeline_drained = !e1_valid.read() && !e1m_valid.read() && !e2_valid.read();
-    bool waiting_for_drain = input_valid && (is_red || is_wide) && !pipeline_drained;
+    bool waiting_for_drain = input_valid && (is_red || is_wide || uses_xbar(class_in)) && !pipeline_drained;
     drain_stall_o.write(waiting_for_drain);
+    ready_o.write(can_accept(class_in));
 }
 
+template struct hp_vpu_lanes_t<cfg_64>;
+template struct hp_vpu_lanes_t<cfg_128>;
+template struct hp_vpu_lanes_t<cfg_256>;
+template struct hp_vpu_lanes_t<cfg_512>;
+
 } // namespace hp_vpu
@@ -3,10 +3,17 @@
 
 #include <systemc.h>
 #include "hp_vpu_pkg.h"
+#include "hp_vpu_prof.h"
+#include "hp_vpu_vreg.h"
 
 namespace hp_vpu {
 
-SC_MODULE(hp_vpu_lanes) {
+template<class CFG>
+struct hp_vpu_lanes_t : sc_module {
+    static const int DLEN = CFG::DLEN;
+    static const int NLANES = CFG::NLANES; // 64-bit execution slices
+    typedef vreg<DLEN> vreg_t;
+
     // Clock/Reset
     sc_in<bool> clk;
     sc_in<bool> rst_n;
@@ -15,10 +22,12 @@ SC_MODULE(hp_vpu_lanes) {
     // Inputs (from Decode)
     sc_in<bool> valid_i;
     sc_in<int>  op_i; // vpu_op_e
-    sc_in<sc_biguint<DLEN>> vs1_i;
-    sc_in<sc_biguint<DLEN>> vs2_i;
-    sc_in<sc_biguint<DLEN>> vs3_i; // old_vd
-    sc_in<sc_biguint<DLEN>> vmask_i;
+    sc_in<int>  uclass_i; // uop_class_e (from decode)
+    sc_in<int>  unit_i; // exec_unit_e (from decode)
+    sc_in<vreg_t> vs1_i;
+    sc_in<vreg_t> vs2_i;
+    sc_in<vreg_t> vs3_i; // old_vd
+    sc_in<vreg_t> vmask_i;
     sc_in<bool> vm_i;
     sc_in<sc_uint<32>> scalar_i;
     sc_in<bool> is_vx_i;
@@ -29,7 +38,7 @@ SC_MODULE(hp_vpu_lanes) {
 
     // Outputs
     sc_out<bool> valid_o;
-    sc_out<sc_biguint<DLEN>> result_o;
+    sc_out<vreg_t> result_o;
     sc_out<sc_uint<5>> vd_o;
     sc_out<sc_uint<CVXIF_ID_W>> id_o;
     sc_out<bool> is_last_uop_o;
@@ -38,6 +47,7 @@ SC_MODULE(hp_vpu_lanes) {
     sc_out<bool> mul_stall_o;
     sc_out<bool> multicycle_busy_o;
     sc_out<bool> drain_stall_o;
+    sc_out<bool> ready_o; // valid_i is taken at the next posedge
 
     // Hazard tracking outputs
     sc_out<bool> e1_valid_o; sc_out<sc_uint<5>> e1_vd_o;
@@ -52,7 +62,12 @@ SC_MODULE(hp_vpu_lanes) {
     // E1 Stage
     sc_signal<bool> e1_valid;
     vpu_op_e e1_op;
-    sc_biguint<DLEN> e1_a, e1_b, e1_c;
+    uop_class_e e1_class;
+    exec_unit_e e1_unit;
+    vreg_t e1_a, e1_b, e1_c;
+    vreg_t e1_mask;        // v0 as read with the op (applied in E2)
+    bool e1_vm;
+    sc_uint<32> e1_scalar; // Shift amount / slide offset for exec_alu
     sc_uint<5> e1_vd;
     sc_uint<CVXIF_ID_W> e1_id;
     sew_e e1_sew;
@@ -61,18 +76,20 @@ SC_MODULE(hp_vpu_lanes) {
     // E1m Stage
     sc_signal<bool> e1m_valid;
     vpu_op_e e1m_op;
-    sc_biguint<DLEN> e1m_mul_res;
+    vreg_t e1m_mul_res;
     sc_uint<5> e1m_vd;
     sc_uint<CVXIF_ID_W> e1m_id;
     sew_e e1m_sew;
-    sc_biguint<DLEN> e1m_a; // Added for VMADD
-    sc_biguint<DLEN> e1m_c;
+    vreg_t e1m_a; // Added for VMADD
+    vreg_t e1m_c;
+    vreg_t e1m_mask;       // v0 and vm of the op, applied in E2 as on the ALU path
+    bool e1m_vm;
     bool e1m_is_last_uop;
 
     // E2 Stage
     sc_signal<bool> e2_valid;
     vpu_op_e e2_op;
-    sc_biguint<DLEN> e2_result;
+    vreg_t e2_result;
     sc_uint<5> e2_vd;
     sc_uint<CVXIF_ID_W> e2_id;
     sew_e e2_sew;
@@ -80,13 +97,16 @@ SC_MODULE(hp_vpu_lanes) {
 
     // E3 Stage
     sc_signal<bool> e3_valid;
-    sc_biguint<DLEN> e3_result;
+    vreg_t e3_result;
     sc_uint<5> e3_vd;
     sc_uint<CVXIF_ID_W> e3_id;
     bool e3_is_last_uop;
 
     // Reduction Pipeline State
-    enum red_state_e { RED_IDLE, RED_R1, RED_R2A, RED_R2B, RED_R3 };
+    // R1/R2A/R2B fold each lane slice; RED_XL (R2B -> XL -> R3, encoded
+    // last to keep the RTL values) is the cross-lane tree, only entered
+    // with timing.red_level_lat > 0
+    enum red_state_e { RED_IDLE, RED_R1, RED_R2A, RED_R2B, RED_R3, RED_XL };
     sc_signal<int> red_state; // red_state_e
 
     // Widening Pipeline State
@@ -95,54 +115,110 @@ SC_MODULE(hp_vpu_lanes) {
 
     // Reduction Registers (simplified representation)
     sc_signal<bool> r3_valid;
-    sc_biguint<DLEN> r3_result;
+    vreg_t r3_result;
     sc_uint<5> r3_vd;
     sc_uint<CVXIF_ID_W> r3_id;
     // Added storage for Reduction operands
-    sc_biguint<DLEN> r_src; // vs2
-    sc_biguint<DLEN> r_init; // vs1 (init val)
+    vreg_t r_src; // vs2
+    vreg_t r_init; // vs1 (init val)
     vpu_op_e r_op;
     sew_e r_sew;
+    int r_xl_left; // RED_XL cycles still to go
 
     // Widening Registers
     sc_signal<bool> w2_valid;
-    sc_biguint<DLEN> w2_result;
+    vreg_t w2_result;
     sc_uint<5> w2_vd;
     sc_uint<CVXIF_ID_W> w2_id;
     // Added storage for Widening operands
-    sc_biguint<DLEN> w_src1; // vs2
-    sc_biguint<DLEN> w_src2; // vs1
+    vreg_t w_src1; // vs2
+    vreg_t w_src2; // vs1
     vpu_op_e w_op;
     sew_e w_sew;
 
-    void logic_thread();
+    // Permute Crossbar State (timing.xbar_lat > 0, NLANES > 1)
+    // X: xbar_lat + passes cycles, one pass per source lane the busiest
+    // destination lane reads (xbar_route); XW: result on the writeback port
+    enum perm_state_e { PERM_IDLE, PERM_X, PERM_XW };
+    sc_signal<int> perm_state; // perm_state_e
+    int x_left;
+    sc_signal<bool> xw_valid;
+    vreg_t xw_result;
+    sc_uint<5> xw_vd;
+    sc_uint<CVXIF_ID_W> xw_id;
+    bool xw_is_last_uop;
+    vpu_op_e x_op;
+    exec_unit_e x_unit;
+    sew_e x_sew;
+    vreg_t x_a, x_b, x_c, x_mask;
+    bool x_vm;
+    sc_uint<32> x_scalar;
+
+    // Cross-lane timing (see lane_timing_t) and its statistics
+    lane_timing_t timing;
+    uint64_t xbar_ops;         // Permutes through the crossbar
+    uint64_t xbar_passes;      // Crossbar passes, summed over those permutes
+    uint64_t xbar_xlane_elems; // Elements moved to another lane
+    uint64_t red_tree_cycles;  // Cycles spent in RED_XL
+
+    void clear_stats() { xbar_ops = xbar_passes = xbar_xlane_elems = red_tree_cycles = 0; }
+
+    void pipeline_logic(); // Clocked: one call per posedge, synchronous reset
     void outputs_method();
 
-    SC_CTOR(hp_vpu_lanes) {
-        SC_CTHREAD(logic_thread, clk.pos());
-        reset_signal_is(rst_n, false);
+    // Whether an input of this class is captured at the next posedge.
+    // Same expression drives ready_o and the E1/R1/W1 capture, so OF and
+    // the hazard scoreboard see exactly one acceptance per instruction.
+    bool can_accept(uop_class_e cls) const;
+
+    // Permutes take the crossbar FSM instead of E1/E2
+    bool uses_xbar(uop_class_e cls) const { return NLANES > 1 && timing.xbar_lat > 0 && cls == UC_PERM; }
+
+    SC_HAS_PROCESS(hp_vpu_lanes_t);
+    hp_vpu_lanes_t(sc_module_name name) : sc_module(name) {
+        timing.red_level_lat = 0;
+        timing.xbar_lat = 0;
+        clear_stats();
+        r_xl_left = x_left = 0;
+        SC_METHOD(pipeline_logic);
+        sensitive << clk.pos();
+        dont_initialize();
         SC_METHOD(outputs_method);
-        sensitive << clk;
+        sensitive << clk << valid_i << uclass_i;
     }
 
-    // ALU functions
-    sc_biguint<DLEN> alu_add(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, bool is_sub);
-    sc_biguint<DLEN> alu_mul(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, bool high, bool signed_a, bool signed_b);
-    sc_biguint<DLEN> alu_logic(sc_biguint<DLEN> a, sc_biguint<DLEN> b, vpu_op_e op);
-    sc_biguint<DLEN> alu_shift(sc_biguint<DLEN> val, sc_biguint<DLEN> shamt, sew_e sew, vpu_op_e op);
-    sc_biguint<DLEN> alu_minmax(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op);
-    sc_biguint<DLEN> alu_cmp(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op);
-    sc_biguint<DLEN> alu_sat(sc_biguint<DLEN> a, sc_biguint<DLEN> b, sew_e sew, vpu_op_e op);
-    sc_biguint<DLEN> alu_permute(sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sc_uint<32> scalar, sew_e sew, vpu_op_e op);
-    sc_biguint<DLEN> alu_narrowing(sc_biguint<DLEN> vs2, sc_biguint<DLEN> vs1, sew_e sew, vpu_op_e op);
-    sc_biguint<DLEN> alu_lut(vpu_op_e op, sc_biguint<DLEN> idx, sew_e sew);
-    sc_biguint<DLEN> alu_int4(sc_biguint<DLEN> val, vpu_op_e op);
-    sc_biguint<DLEN> apply_mask(sc_biguint<DLEN> res, sc_biguint<DLEN> old_vd, sc_biguint<DLEN> mask, bool vm, sew_e sew);
-
-    bool is_reduction(vpu_op_e op);
-    bool is_widening(vpu_op_e op);
+    // ALU functions (native-word datapath, see hp_vpu_vreg.h)
+    // Static: no pipeline state, also used by the functional model (hp_vpu_func)
+    static vreg_t alu_add(const vreg_t& a, const vreg_t& b, sew_e sew, bool is_sub);
+    static vreg_t alu_mul(const vreg_t& a, const vreg_t& b, sew_e sew, bool high, bool signed_a, bool signed_b);
+    static vreg_t alu_logic(const vreg_t& a, const vreg_t& b, vpu_op_e op);
+    static vreg_t alu_shift(const vreg_t& val, const vreg_t& shamt, sew_e sew, vpu_op_e op);
+    static vreg_t alu_minmax(const vreg_t& a, const vreg_t& b, sew_e sew, vpu_op_e op);
+    static vreg_t alu_cmp(const vreg_t& a, const vreg_t& b, sew_e sew, vpu_op_e op);
+    static vreg_t alu_sat(const vreg_t& a, const vreg_t& b, sew_e sew, vpu_op_e op);
+    static vreg_t alu_permute(const vreg_t& vs2, const vreg_t& vs1, sc_uint<32> scalar, sew_e sew, vpu_op_e op);
+    static vreg_t alu_narrowing(const vreg_t& vs2, const vreg_t& vs1, sew_e sew, vpu_op_e op);
+    static vreg_t alu_lut(vpu_op_e op, const vreg_t& idx, sew_e sew);
+    static vreg_t alu_int4(const vreg_t& val, vpu_op_e op);
+    static vreg_t apply_mask(const vreg_t& res, const vreg_t& old_vd, const vreg_t& mask, bool vm, sew_e sew);
+    static uint64_t red_combine(vpu_op_e op, uint64_t a, uint64_t b, int width);
+
+    // Crossbar passes a permute needs (at least 1): the most source lanes
+    // any one destination lane reads. Adds the cross-lane elements to *xlane.
+    // vs1: gather indices (SEW, or 16-bit for VRGATHEREI16), VCOMPRESS mask
+    static int xbar_route(const vreg_t& vs1, sc_uint<32> scalar, sew_e sew, vpu_op_e op, uint64_t* xlane);
+
+    // Per-stage datapaths built from the ALU functions
+    static vreg_t exec_alu(exec_unit_e unit, vpu_op_e op, sew_e sew, const vreg_t& a, const vreg_t& b, sc_uint<32> scalar); // E2
+    static vreg_t exec_mul(vpu_op_e op, sew_e sew, const vreg_t& a, const vreg_t& b, const vreg_t& c); // E1m
+    static vreg_t exec_mac(vpu_op_e op, sew_e sew, const vreg_t& prod, const vreg_t& a, const vreg_t& c); // E2 (MAC)
+    static vreg_t exec_reduction(vpu_op_e op, sew_e sew, const vreg_t& src, const vreg_t& init); // R2B (or XL)
+    static vreg_t exec_widening(vpu_op_e op, sew_e sew, const vreg_t& s1, const vreg_t& s2); // W1
 };
 
+// Member definitions in hp_vpu_lanes.cpp, instantiated there for every config
+typedef hp_vpu_lanes_t<cfg_default> hp_vpu_lanes;
+
 } // namespace hp_vpu
 
 #endif // HP_VPU_LANES_H
@@ -0,0 +1,346 @@
+#ifndef HP_VPU_PIPEVIEW_H
+#define HP_VPU_PIPEVIEW_H
+
+#include <systemc.h>
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "hp_vpu_pkg.h"
+#include "hp_vpu_top.h"
+
+namespace hp_vpu {
+
+// Per-instruction pipeline monitor
+// - Follows every instruction from IQ push through D, OF, the lanes
+//   (E1/E1m/E2/E3, R1/R2A/R2B/Rx/R3, W1/W2 or X/Xw) to writeback, one row per uop
+// - Kanata 0004 log (Konata viewer) when given a path; writeback is the
+//   retire event. D1 is the decode register; D2 decodes it combinationally
+//   in the same cycle, so both show as stage "D"
+// - Issue (IQ push) to last-uop writeback latency per uop_class_e, reported
+//   as p50/p99/max and a latency histogram
+// - IQ pushes and D/OF handoffs are taken at the clk posedge (pre-edge
+//   handshake), stage occupancy at the negedge, when every pipeline
+//   register is stable.
+//   D -> OF -> lanes follow the in-order handoff; inside the lanes uops are
+//   matched by (id, vd)
+// - Disabled (the default) both processes park on an event
+template<class CFG>
+struct hp_vpu_pipeview_t : sc_module {
+    typedef hp_vpu_top_t<CFG> top_t;
+    typedef hp_vpu_lanes_t<CFG> lanes_t;
+
+    enum stage_e { ST_IQ = 0, ST_D, ST_OF, ST_E1, ST_E1M, ST_E2, ST_E3, ST_R1, ST_R2A, ST_R2B, ST_RX, ST_R3, ST_W1, ST_W2, ST_X, ST_XW, ST_COUNT };
+
+    top_t* top;
+    uint64_t retired; // Instructions with all uops written back
+
+    // kanata_path empty: latency statistics only
+    bool enable(const std::string& kanata_path) {
+        close();
+        if (!kanata_path.empty()) {
+            kf = fopen(kanata_path.c_str(), "w");
+            if (!kf) return false;
+            fprintf(kf, "Kanata\t0004\n");
+        }
+        on = true;
+        log_started = false;
+        if (parked) arm_ev.notify(SC_ZERO_TIME);
+        return true;
+    }
+
+    void close() {
+        if (kf) {
+            flush_retires(last_cycle + 1);
+            fclose(kf);
+            kf = nullptr;
+        }
+    }
+
+    // Latency percentiles per class, plus the histogram (latency:count)
+    void report(std::ostream& os) const {
+        static const char* cls[UC_COUNT] = { "alu", "mul", "red", "wide", "perm", "lut", "mask" };
+        os << "[LAT] Issue-to-writeback latency (cycles), " << retired << " instructions" << std::endl;
+        for (int c = 0; c < UC_COUNT; c++) {
+            std::vector<uint32_t> v = lat[c];
+            if (v.empty()) continue;
+            std::sort(v.begin(), v.end());
+            size_t n = v.size();
+            size_t i99 = (n * 99 + 99) / 100 - 1;
+            os << "[LAT] " << cls[c] << ": n=" << n << " p50=" << v[(n - 1) / 2] << " p99=" << v[i99 < n ? i99 : n - 1]
+               << " max=" << v[n - 1] << " hist:";
+            for (size_t i = 0; i < n;) {
+                size_t j = i;
+                while (j < n && v[j] == v[i]) j++;
+                os << " " << v[i] << ":" << (j - i);
+                i = j;
+            }
+            os << std::endl;
+        }
+    }
+
+    void on_posedge() {
+        if (!on) { park(); return; }
+        if (parked) { unpark(); return; }
+        if (!top->rst_n.read()) return;
+        // D -> OF and OF -> lanes handoffs on this edge, from the values the
+        // clocked stages use (at the negedge ready_o / hazard_stall can
+        // still be settling after the lanes FSM state changed)
+        prev_d_moved = prev_d >= 0 && !top->hazard_stall.read();
+        prev_of_moved = prev_of >= 0 && top->s_lanes_ready.read();
+        // Pushed on this edge: in the IQ from this cycle
+        if (top->x_issue_valid_i.read() && top->x_issue_ready_o.read()) {
+            uint64_t s = new_inst(top->x_issue_id_i.read().to_uint(), top->x_issue_instr_i.read().to_uint(), cycle_now());
+            iq.push_back(s);
+            open_row(s, 0, ST_IQ, cycle_now());
+        }
+    }
+
+    void on_negedge() {
+        if (!on) { park(); return; }
+        if (parked) { unpark(); return; }
+        if (!top->rst_n.read()) return;
+        uint64_t c = cycle_now();
+        if (!retire_q.empty()) advance(c);
+
+        const top_t& t = *top;
+        const lanes_t& l = *t.u_lanes;
+
+        // OF: held, or the uop D handed over at the last edge
+        int64_t of = -1;
+        if (t.of_valid.read()) {
+            if (prev_of >= 0 && !prev_of_moved) of = prev_of;
+            else if (prev_d >= 0 && prev_d_moved) of = prev_d;
+            if (of >= 0 && rows[of].stage != ST_OF) set_stage(of, ST_OF, c);
+        }
+        if (prev_of >= 0 && prev_of_moved) in_lanes.push_back(prev_of);
+
+        // D: held, or a new uop (first uop pops the IQ)
+        int64_t d = -1;
+        if (t.dec_valid.read()) {
+            if (prev_d >= 0 && !prev_d_moved) {
+                d = prev_d;
+            } else if (t.u_decode->uop_counter.read() == 0) {
+                uint32_t id = t.dec_id.read().to_uint();
+                uint64_t s;
+                if (!iq.empty() && insts[iq.front()].id == id) { s = iq.front(); iq.pop_front(); }
+                else s = new_inst(id, t.u_decode->d1_instr.read().to_uint(), c); // Preloaded IQ (hybrid runner)
+                inst_t& in = insts[s];
+                in.uclass = t.dec_uclass.read();
+                in.uops = t.u_decode->uop_total.read();
+                d = in.first_row >= 0 ? in.first_row : open_row(s, 0, ST_D, c);
+                d_inst = s;
+            } else {
+                d = open_row(d_inst, t.u_decode->uop_counter.read(), ST_D, c);
+            }
+            rows[d].vd = t.dec_vd.read().to_uint();
+            if (rows[d].stage != ST_D) set_stage(d, ST_D, c);
+        }
+
+        // Lanes, oldest stage first
+        assigned.clear();
+        int64_t e3 = -1, r3 = -1, w2 = -1, xw = -1;
+        if (l.e3_valid.read())  e3 = lane_stage(ST_E3, l.e3_id, l.e3_vd, c);
+        if (l.e2_valid.read())  lane_stage(ST_E2, l.e2_id, l.e2_vd, c);
+        if (l.e1m_valid.read()) lane_stage(ST_E1M, l.e1m_id, l.e1m_vd, c);
+        if (l.e1_valid.read())  lane_stage(ST_E1, l.e1_id, l.e1_vd, c);
+        switch (l.red_state.read()) {
+            case lanes_t::RED_R1:  lane_stage(ST_R1, l.r3_id, l.r3_vd, c); break;
+            case lanes_t::RED_R2A: lane_stage(ST_R2A, l.r3_id, l.r3_vd, c); break;
+            case lanes_t::RED_R2B: lane_stage(ST_R2B, l.r3_id, l.r3_vd, c); break;
+            case lanes_t::RED_XL:  lane_stage(ST_RX, l.r3_id, l.r3_vd, c); break;
+            case lanes_t::RED_R3:  r3 = lane_stage(ST_R3, l.r3_id, l.r3_vd, c); break;
+            default: break;
+        }
+        switch (l.wide_state.read()) {
+            case lanes_t::WIDE_W1: lane_stage(ST_W1, l.w2_id, l.w2_vd, c); break;
+            case lanes_t::WIDE_W2: w2 = lane_stage(ST_W2, l.w2_id, l.w2_vd, c); break;
+            default: break;
+        }
+        switch (l.perm_state.read()) {
+            case lanes_t::PERM_X:  lane_stage(ST_X, l.xw_id, l.xw_vd, c); break;
+            case lanes_t::PERM_XW: xw = lane_stage(ST_XW, l.xw_id, l.xw_vd, c); break;
+            default: break;
+        }
+
+        // Writeback at the end of this cycle (same priority as the lanes
+        // result mux: W2, Xw, R3, E3)
+        int64_t wb = l.w2_valid.read() ? w2 : l.xw_valid.read() ? xw : l.r3_valid.read() ? r3 : e3;
+        if (wb >= 0) {
+            in_lanes.erase(std::find(in_lanes.begin(), in_lanes.end(), wb));
+            retire_q.push_back(wb);
+        }
+
+        prev_d = d;
+        prev_of = of;
+    }
+
+    SC_HAS_PROCESS(hp_vpu_pipeview_t);
+    hp_vpu_pipeview_t(sc_module_name name, top_t* t) : sc_module(name) {
+        top = t;
+        retired = 0;
+        on = false;
+        parked = false;
+        kf = nullptr;
+        log_started = false;
+        last_cycle = 0;
+        next_seq = 0;
+        next_row = 0;
+        d_inst = 0;
+        prev_d = prev_of = -1;
+        prev_d_moved = prev_of_moved = false;
+
+        SC_METHOD(on_posedge);
+        sensitive << top->clk.pos();
+        dont_initialize();
+        SC_METHOD(on_negedge);
+        sensitive << top->clk.neg();
+        dont_initialize();
+    }
+
+    ~hp_vpu_pipeview_t() { close(); }
+
+private:
+    struct inst_t {
+        uint32_t id, instr;
+        uint64_t push_cycle;
+        int uclass;
+        int uops, uops_done;
+        int64_t first_row;
+    };
+    struct row_t {
+        uint64_t inst;
+        int uop;
+        int stage;
+        uint32_t vd;
+    };
+
+    bool on, parked;
+    sc_event arm_ev;
+    FILE* kf;
+    bool log_started;
+    uint64_t last_cycle;
+    uint64_t next_seq;
+    int64_t next_row;
+    uint64_t d_inst;
+
+    std::unordered_map<uint64_t, inst_t> insts;
+    std::unordered_map<int64_t, row_t> rows;
+    std::deque<uint64_t> iq;
+    std::vector<int64_t> in_lanes;
+    std::vector<int64_t> assigned;
+    std::vector<int64_t> retire_q;
+    int64_t prev_d, prev_of;
+    bool prev_d_moved, prev_of_moved;
+    std::vector<uint32_t> lat[UC_COUNT];
+
+    void park() { parked = true; next_trigger(arm_ev); }
+    void unpark() { parked = false; next_trigger(); }
+
+    uint64_t cycle_now() const { return top->cycle_count(); }
+
+    static const char* stage_name(int s) {
+        static const char* n[ST_COUNT] = { "Iq", "D", "Of", "E1", "E1m", "E2", "E3", "R1", "R2a", "R2b", "Rx", "R3", "W1", "W2", "X", "Xw" };
+        return n[s];
+    }
+
+    uint64_t new_inst(uint32_t id, uint32_t instr, uint64_t c) {
+        inst_t in = { id, instr, c, UC_ALU, 1, 0, -1 };
+        insts[next_seq] = in;
+        return next_seq++;
+    }
+
+    // Move the log to cycle c (retires of the previous cycle first)
+    void advance(uint64_t c) {
+        if (!log_started) {
+            if (kf) fprintf(kf, "C=\t%llu\n", (unsigned long long)c);
+            last_cycle = c;
+            log_started = true;
+        }
+        if (c > last_cycle) flush_retires(c);
+    }
+
+    void flush_retires(uint64_t c) {
+        if (!retire_q.empty()) {
+            tick(last_cycle + 1);
+            for (size_t i = 0; i < retire_q.size(); i++) retire(retire_q[i]);
+            retire_q.clear();
+        }
+        tick(c);
+    }
+
+    void tick(uint64_t c) {
+        if (c <= last_cycle) return;
+        if (kf) fprintf(kf, "C\t%llu\n", (unsigned long long)(c - last_cycle));
+        last_cycle = c;
+    }
+
+    int64_t open_row(uint64_t s, int uop, int stage, uint64_t c) {
+        advance(c);
+        inst_t& in = insts[s];
+        int64_t r = next_row++;
+        row_t row = { s, uop, stage, 0 };
+        rows[r] = row;
+        if (in.first_row < 0) in.first_row = r;
+        if (kf) {
+            fprintf(kf, "I\t%lld\t%llu\t0\n", (long long)r, (unsigned long long)s);
+            fprintf(kf, "L\t%lld\t0\tid=%u %08x", (long long)r, in.id, in.instr);
+            if (uop) fprintf(kf, " uop%d", uop);
+            fprintf(kf, "\n");
+            fprintf(kf, "S\t%lld\t0\t%s\n", (long long)r, stage_name(stage));
+        }
+        return r;
+    }
+
+    void set_stage(int64_t r, int stage, uint64_t c) {
+        advance(c);
+        rows[r].stage = stage;
+        if (kf) fprintf(kf, "S\t%lld\t0\t%s\n", (long long)r, stage_name(stage));
+    }
+
+    // Oldest lanes row with this (id, vd) not past `stage` nor placed this cycle
+    int64_t find_lane_row(uint32_t id, uint32_t vd, int stage) const {
+        int64_t best = -1;
+        for (size_t i = 0; i < in_lanes.size(); i++) {
+            int64_t r = in_lanes[i];
+            auto it = rows.find(r);
+            const row_t& row = it->second;
+            if (insts.at(row.inst).id != id || row.vd != vd) continue;
+            if (row.stage > stage && row.stage >= ST_E1) continue;
+            if (std::find(assigned.begin(), assigned.end(), r) != assigned.end()) continue;
+            if (best < 0 || r < best) best = r;
+        }
+        return best;
+    }
+
+    int64_t lane_stage(int stage, const sc_uint<CVXIF_ID_W>& id, const sc_uint<5>& vd, uint64_t c) {
+        int64_t r = find_lane_row(id.to_uint(), vd.to_uint(), stage);
+        if (r < 0) return -1;
+        assigned.push_back(r);
+        if (rows[r].stage != stage) set_stage(r, stage, c);
+        return r;
+    }
+
+    void retire(int64_t r) {
+        row_t row = rows[r];
+        rows.erase(r);
+        if (kf) fprintf(kf, "R\t%lld\t%lld\t0\n", (long long)r, (long long)r);
+        auto it = insts.find(row.inst);
+        if (it == insts.end()) return;
+        inst_t& in = it->second;
+        if (++in.uops_done < in.uops) return;
+        uint64_t l = last_cycle - in.push_cycle; // last_cycle = writeback edge
+        if (in.uclass >= 0 && in.uclass < UC_COUNT) lat[in.uclass].push_back((uint32_t)l);
+        retired++;
+        insts.erase(it);
+    }
+};
+
+typedef hp_vpu_pipeview_t<cfg_default> hp_vpu_pipeview;
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_PIPEVIEW_H
@@ -6,11 +6,52 @@
 
 namespace hp_vpu {
 
-// Configuration Parameters
-const int VLEN = 64;   // Default 64, can be changed
-const int NLANES = 1;  // Default 1
+// Datapath configuration traits (config/vpu_config*.json "parameters")
+// Width-dependent modules (vreg, VRF, lanes, functional model, top, golden
+// model) are templated on one of these; every instance below is compiled
+// into the same executable and picked at run time with with_config().
+// The plain names (hp_vpu_top, vreg_t, ...) are the cfg_default instances.
+constexpr int log2_ceil(int n) { return n <= 1 ? 0 : 1 + log2_ceil((n + 1) / 2); }
+
+template<int VLEN_, int DLEN_>
+struct vpu_cfg {
+    static const int VLEN = VLEN_;
+    static const int DLEN = DLEN_;        // Data path width
+    static const int NLANES = DLEN_ / 64; // 64-bit lanes
+    static const int RED_TREE_LEVELS = log2_ceil(NLANES); // Cross-lane reduction tree depth
+};
+
+typedef vpu_cfg<64, 64>   cfg_64;  // vpu_config.json, _arty7
+typedef vpu_cfg<128, 128> cfg_128; // vpu_config_128.json
+typedef vpu_cfg<256, 256> cfg_256; // vpu_config_256.json
+typedef vpu_cfg<512, 512> cfg_512; // vpu_config_512.json
+typedef cfg_64 cfg_default;
+
+// Call f(CFG()) for the compiled-in configuration matching VLEN/DLEN.
+// Returns false (f not called) if there is none.
+template<typename F>
+bool with_config(int vlen, int dlen, F&& f) {
+    if (vlen == 64 && dlen == 64)   { f(cfg_64());  return true; }
+    if (vlen == 128 && dlen == 128) { f(cfg_128()); return true; }
+    if (vlen == 256 && dlen == 256) { f(cfg_256()); return true; }
+    if (vlen == 512 && dlen == 512) { f(cfg_512()); return true; }
+    return false;
+}
+
+// Cross-lane timing of the lanes model (hp_vpu_lanes_t::timing). Run-time,
+// so one binary sweeps it. All zero (the default) is the RTL timing, which
+// folds the reduction tree into R1/R2A/R2B and permutes in one E2 cycle;
+// only NLANES > 1 configurations have a cross-lane network at all.
+struct lane_timing_t {
+    int red_level_lat; // Cycles per cross-lane reduction tree level, after R2B
+    int xbar_lat;      // Permute crossbar pipeline depth; > 0 moves slides/gathers to the X stage
+};
+
+// Configuration Parameters (default configuration)
+const int VLEN = cfg_default::VLEN;
+const int NLANES = cfg_default::NLANES;
 const int ELEN = 32;
-const int DLEN = NLANES * 64; // Data path width
+const int DLEN = cfg_default::DLEN;
 const int NUM_REGS = 32;
 const int CVXIF_ID_W = 8;
 const bool ENABLE_VMADD = true;
@@ -74,7 +115,9 @@ enum vpu_op_e {
 
     // Custom/LLM
     OP_VEXP, OP_VRECIP, OP_VRSQRT, OP_VGELU,
-    OP_VPACK4, OP_VUNPACK4
+    OP_VPACK4, OP_VUNPACK4,
+
+    OP_COUNT // Number of opcodes (table sizing only)
 };
 
 // SEW (Standard Element Width)
@@ -96,6 +139,102 @@ enum lmul_e {
     LMUL_F8 = 7
 };
 
+// Micro-op class (pipeline routing), attached to each instruction by decode
+enum uop_class_e {
+    UC_ALU = 0, // E1 -> E2 single-cycle ALU
+    UC_MUL,     // E1 -> E1m -> E2 (multiply / MAC)
+    UC_RED,     // Reduction FSM (R1 -> R2A -> R2B -> R3)
+    UC_WIDE,    // Widening FSM (W1 -> W2)
+    UC_PERM,    // Slides / gathers (E2)
+    UC_LUT,     // LLM LUT ops (E2)
+    UC_MASK,    // Mask-producing ops (E2, written back unmasked)
+    UC_COUNT
+};
+
+// E2 function unit selector (one switch in the lanes instead of range tests)
+enum exec_unit_e {
+    EU_NONE = 0, // Result is zero
+    EU_ADD, EU_SUB, EU_LOGIC, EU_SHIFT, EU_MINMAX, EU_SAT, EU_CMP,
+    EU_PERM, EU_NARROW, EU_LUT, EU_INT4, EU_MOVE,
+    EU_MUL      // Handled in E1m
+};
+
+inline uop_class_e uop_class_of(vpu_op_e op) {
+    if (op >= OP_VMUL && op <= OP_VNMSUB) return UC_MUL;
+    if (op >= OP_VWMUL && op <= OP_VWSUBU) return UC_WIDE;
+    if (op >= OP_VREDSUM && op <= OP_VREDMAX) return UC_RED;
+    if (op >= OP_VRGATHER && op <= OP_VCOMPRESS) return UC_PERM;
+    if (op >= OP_VEXP && op <= OP_VGELU) return UC_LUT;
+    if (op >= OP_VMSEQ && op <= OP_VMSGT) return UC_MASK;
+    if (op >= OP_VMAND_MM && op <= OP_VID) return UC_MASK;
+    return UC_ALU;
+}
+
+inline exec_unit_e exec_unit_of(vpu_op_e op) {
+    switch (op) {
+        case OP_VADD:  return EU_ADD;
+        case OP_VSUB:
+        case OP_VRSUB: return EU_SUB;
+        case OP_VAND: case OP_VOR: case OP_VXOR: return EU_LOGIC;
+        case OP_VSLL: case OP_VSRL: case OP_VSRA:
+        case OP_VSSRL: case OP_VSSRA: return EU_SHIFT;
+        case OP_VNSRL: case OP_VNSRA:
+        case OP_VNCLIPU: case OP_VNCLIP: return EU_NARROW;
+        case OP_VPACK4: case OP_VUNPACK4: return EU_INT4;
+        case OP_VMV: case OP_VMERGE: return EU_MOVE;
+        default: break;
+    }
+    if (op >= OP_VMINU && op <= OP_VMAX) return EU_MINMAX;
+    if (op >= OP_VSADDU && op <= OP_VSSUB) return EU_SAT;
+    if (op >= OP_VMSEQ && op <= OP_VMSGT) return EU_CMP;
+    if (op >= OP_VRGATHER && op <= OP_VSLIDE1DN) return EU_PERM;
+    if (op >= OP_VEXP && op <= OP_VGELU) return EU_LUT;
+    if (op >= OP_VMUL && op <= OP_VNMSUB) return EU_MUL;
+    return EU_NONE;
+}
+
+// Why decode is held this cycle (hp_vpu_hazard::stall_reason_o)
+enum stall_reason_e {
+    STALL_NONE = 0,
+    STALL_RAW,   // vs1/vs2 pending in the scoreboard
+    STALL_WAW,   // vd (= vs3, accumulator) pending in the scoreboard
+    STALL_BUSY,  // OF held: lanes busy (E1 blocked, reduction/widening/crossbar FSM)
+    STALL_DRAIN, // OF held: reduction/widening/crossbar waiting for E1/E1m/E2 to drain
+    STALL_COUNT
+};
+
+// Use of the D -> OF issue slot, one per cycle (hp_vpu_top::slot_cycles)
+enum slot_cause_e {
+    SLOT_ISSUED = 0,      // A uop moved D -> OF
+    SLOT_RAW_OF,          // RAW on a producer in OF ...
+    SLOT_RAW_E1,
+    SLOT_RAW_E1M,
+    SLOT_RAW_E2,
+    SLOT_RAW_E3,
+    SLOT_RAW_R2A,
+    SLOT_RAW_R2B,
+    SLOT_RAW_W2,
+    SLOT_RAW_WB,          // ... or writing back this cycle
+    SLOT_RAW_FSM,         // RAW on a producer inside a reduction/widening/crossbar FSM state
+    SLOT_WAW,             // Accumulator (vd) still pending
+    SLOT_MULTICYCLE_BUSY, // OF held: reduction/widening FSM running
+    SLOT_DRAIN_STALL,     // OF held: FSM waiting for E1/E1m/E2 to drain
+    SLOT_MUL_STALL,       // OF held: E1 blocked behind E1m
+    SLOT_LANES_BUSY,      // OF held, other
+    SLOT_IQ_EMPTY,        // Nothing queued (includes idle-skipped cycles)
+    SLOT_DECODE,          // IQ holds an instruction, D1/D2 not yet valid
+    SLOT_COUNT
+};
+
+inline const char* slot_cause_name(int c) {
+    static const char* n[SLOT_COUNT] = {
+        "issued", "raw_of", "raw_e1", "raw_e1m", "raw_e2", "raw_e3", "raw_r2a", "raw_r2b", "raw_w2",
+        "raw_wb", "raw_fsm", "waw", "multicycle_busy", "drain_stall", "mul_stall", "lanes_busy",
+        "iq_empty", "decode"
+    };
+    return (c >= 0 && c < SLOT_COUNT) ? n[c] : "?";
+}
+
 // Funct3 Constants
 const int OPIVV = 0b000;
 const int OPMVV = 0b010;
@@ -0,0 +1,128 @@
+#ifndef HP_VPU_POOL_H
+#define HP_VPU_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hp_vpu {
+
+// Fixed worker pool for data-parallel host work (batched golden checks)
+// - parallel_for(n, chunk, fn) calls fn(begin, end) over [0, n) in chunks;
+//   the calling thread works on its own job too and returns when every
+//   chunk is done
+// - Safe for concurrent callers: each call is a separate job, workers take
+//   chunks from the oldest unfinished job first
+// - Never use from inside an SC process that other processes wait on: the
+//   model itself stays single-threaded, only host-side checking fans out
+class work_pool {
+public:
+    typedef std::function<void(size_t, size_t)> range_fn;
+
+    // threads = total including the caller; 0: HP_VPU_THREADS or all cores
+    explicit work_pool(int threads = 0) : stop(false) {
+        if (threads <= 0) threads = default_threads();
+        for (int i = 1; i < threads; i++) workers.emplace_back([this]() { worker(); });
+    }
+
+    ~work_pool() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            stop = true;
+        }
+        cv.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    int size() const { return (int)workers.size() + 1; }
+
+    void parallel_for(size_t n, size_t chunk, const range_fn& fn) {
+        if (n == 0) return;
+        if (chunk == 0) chunk = 1;
+        if (workers.empty() || n <= chunk) {
+            fn(0, n);
+            return;
+        }
+        std::shared_ptr<job_t> j = std::make_shared<job_t>(fn, n, chunk);
+        {
+            std::lock_guard<std::mutex> lk(m);
+            jobs.push_back(j);
+        }
+        cv.notify_all();
+        run_chunks(*j);
+        std::unique_lock<std::mutex> lk(j->m);
+        j->cv.wait(lk, [&]() { return j->done.load() == j->n; });
+    }
+
+    // Process-wide pool, created on first use
+    static work_pool& shared() {
+        static work_pool pool;
+        return pool;
+    }
+
+    static int default_threads() {
+        const char* env = getenv("HP_VPU_THREADS");
+        int t = env ? atoi(env) : 0;
+        if (t <= 0) t = (int)std::thread::hardware_concurrency();
+        return t > 0 ? t : 1;
+    }
+
+private:
+    struct job_t {
+        const range_fn& fn;
+        size_t n, chunk;
+        std::atomic<size_t> next, done;
+        std::mutex m;
+        std::condition_variable cv;
+
+        job_t(const range_fn& f, size_t n_, size_t c) : fn(f), n(n_), chunk(c), next(0), done(0) {}
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<std::shared_ptr<job_t>> jobs;
+    std::mutex m;
+    std::condition_variable cv;
+    bool stop;
+
+    static void run_chunks(job_t& j) {
+        for (;;) {
+            size_t b = j.next.fetch_add(j.chunk);
+            if (b >= j.n) return;
+            size_t e = std::min(b + j.chunk, j.n);
+            j.fn(b, e);
+            if (j.done.fetch_add(e - b) + (e - b) == j.n) {
+                std::lock_guard<std::mutex> lk(j.m);
+                j.cv.notify_all();
+            }
+        }
+    }
+
+    void worker() {
+        for (;;) {
+            std::shared_ptr<job_t> j;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk, [&]() { return stop || !jobs.empty(); });
+                if (stop) return;
+                j = jobs.front();
+                // Fully handed out: retire it from the queue, chunks may still be running
+                if (j->next.load() >= j->n) {
+                    jobs.pop_front();
+                    continue;
+                }
+            }
+            run_chunks(*j);
+        }
+    }
+};
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_POOL_H
@@ -0,0 +1,85 @@
+#ifndef HP_VPU_PROF_H
+#define HP_VPU_PROF_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace hp_vpu {
+
+// Host time per SC process (simulator speed, not simulated time)
+// Compiled in with -DHP_VPU_PROF: each process body opens a prof_scope and
+// its wall time and call count accumulate in prof_counters(). The timer
+// costs ~20-40 ns per activation, so gate speed on a build without it and
+// use the profiled build for the split only. Without the flag the macro is
+// empty and the counters stay zero.
+enum prof_proc_e {
+    PROF_IQ_LOGIC = 0,     // hp_vpu_iq::iq_logic
+    PROF_IQ_OUTPUT,        // hp_vpu_iq::output_logic
+    PROF_DECODE_PIPELINE,  // hp_vpu_decode::decode_pipeline
+    PROF_DECODE_OUTPUT,    // hp_vpu_decode::output_logic
+    PROF_HAZARD_LOGIC,     // hp_vpu_hazard::hazard_logic
+    PROF_SCOREBOARD,       // hp_vpu_hazard::scoreboard_update
+    PROF_VRF_CONTROL,      // hp_vpu_top::vrf_control_logic
+    PROF_OF_STAGE,         // hp_vpu_top::of_stage_logic
+    PROF_SLOT_ATTRIBUTION, // hp_vpu_top::slot_attribution
+    PROF_LANES_PIPELINE,   // hp_vpu_lanes::pipeline_logic
+    PROF_LANES_OUTPUT,     // hp_vpu_lanes::outputs_method
+    PROF_VRF_READ,         // hp_vpu_vrf::read_process
+    PROF_VRF_WRITE,        // hp_vpu_vrf::write_process
+    PROF_COUNT
+};
+
+inline const char* prof_proc_name(int p) {
+    static const char* names[PROF_COUNT] = {
+        "iq_logic", "iq_output_logic", "decode_pipeline", "decode_output_logic", "hazard_logic",
+        "scoreboard_update", "vrf_control_logic", "of_stage_logic", "slot_attribution",
+        "lanes_pipeline_logic", "lanes_outputs_method", "vrf_read_process", "vrf_write_process"
+    };
+    return (p >= 0 && p < PROF_COUNT) ? names[p] : "?";
+}
+
+struct prof_counters_t {
+    uint64_t ns[PROF_COUNT];
+    uint64_t calls[PROF_COUNT];
+
+    void clear() {
+        for (int i = 0; i < PROF_COUNT; i++) ns[i] = calls[i] = 0;
+    }
+};
+
+// Process-wide (one elaboration per process, as the kernel requires)
+inline prof_counters_t& prof_counters() {
+    static prof_counters_t c = {};
+    return c;
+}
+
+inline bool prof_enabled() {
+#ifdef HP_VPU_PROF
+    return true;
+#else
+    return false;
+#endif
+}
+
+struct prof_scope {
+    int proc;
+    std::chrono::steady_clock::time_point t0;
+
+    explicit prof_scope(int p) : proc(p), t0(std::chrono::steady_clock::now()) {}
+    ~prof_scope() {
+        prof_counters_t& c = prof_counters();
+        c.ns[proc] += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        c.calls[proc]++;
+    }
+};
+
+} // namespace hp_vpu
+
+#ifdef HP_VPU_PROF
+#define HP_VPU_PROF_SCOPE(p) ::hp_vpu::prof_scope hp_vpu_prof_scope_(::hp_vpu::p)
+#else
+#define HP_VPU_PROF_SCOPE(p) ((void)0)
+#endif
+
+#endif // HP_VPU_PROF_H
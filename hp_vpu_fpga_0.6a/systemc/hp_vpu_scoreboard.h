@@ -0,0 +1,217 @@
+#ifndef HP_VPU_SCOREBOARD_H
+#define HP_VPU_SCOREBOARD_H
+
+#include <systemc.h>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include "hp_vpu_pkg.h"
+#include "hp_vpu_vreg.h"
+#include "hp_vpu_decode.h"
+#include "hp_vpu_func.h"
+#include "hp_vpu_top.h"
+#include "golden_model.h"
+
+namespace hp_vpu {
+
+// Lockstep commit scoreboard on the hp_vpu_top writeback port
+// - Shadow architectural VRF, updated in program order: DMA writes as they
+//   land, each accepted issue (x_issue_valid_i && x_issue_ready_o) expanded
+//   into its LMUL uops and run through GoldenModel at once
+// - Every expected uop result is queued under its CV-X-IF id and vd; each
+//   writeback (s_valid_o) is matched to the oldest pending entry with the
+//   same id and vd and compared, so any number may be in flight
+// - Samples at each delivered clk posedge, the edge the IQ and VRF use
+// - Uops the golden model does not implement, and uops reading a result of
+//   such a uop, are tracked but not compared (counted as unchecked)
+// - A writeback in the same cycle as a DMA write is dropped by the VRF
+//   write mux (DMA priority); counted as dma_collisions
+// - Disabled (the default) the process parks on an event
+// - IQ entries preloaded by hp_vpu_hybrid bypass the pins: call expect()
+template<class CFG>
+struct hp_vpu_scoreboard_t : sc_module {
+    typedef vreg<CFG::DLEN> vreg_t;
+    typedef hp_vpu_top_t<CFG> top_t;
+    typedef GoldenModel_t<CFG> golden_t;
+
+    struct expect_t {
+        uint32_t id;
+        uint32_t vd;
+        uint32_t instr; // Uop instruction word (register fields of this uop)
+        vpu_op_e op;
+        bool checked;   // false: result not predicted (unsupported / unknown source)
+        vreg_t data;
+    };
+
+    top_t* top;
+
+    // Statistics (reset by enable)
+    uint64_t issued;          // Instructions seen at issue
+    uint64_t uops;            // Uops expected
+    uint64_t checked;         // Writebacks compared
+    uint64_t mismatches;
+    uint64_t unchecked;       // Writebacks of unpredicted uops
+    uint64_t unexpected;      // Writebacks with no pending (id, vd)
+    uint64_t dma_collisions;  // Writebacks dropped by a same-cycle DMA write
+
+    int max_reports; // Mismatch lines printed by the process (0 = silent)
+    std::function<void(const expect_t&, const vreg_t& actual)> on_error;
+
+    // Start checking; the shadow starts from the current VRF contents.
+    // May be called between sc_start calls.
+    void enable() {
+        issued = uops = checked = mismatches = unchecked = unexpected = dma_collisions = 0;
+        reports = 0;
+        q.clear();
+        sync();
+        on = true;
+        if (parked) arm_ev.notify(SC_ZERO_TIME);
+    }
+
+    void disable() { on = false; }
+
+    bool enabled() const { return on; }
+
+    // Reload the shadow from the VRF (e.g. after a functional fast-forward);
+    // only meaningful with nothing in flight
+    void sync() {
+        for (int r = 0; r < 32; r++) {
+            shadow[r] = top->u_vrf->peek(r);
+            known[r] = true;
+        }
+    }
+
+    // An instruction entering the pipeline without the issue pins
+    void expect(const cvxif_issue_t& req, uint32_t vtype) {
+        if (on) predict(req.instr, req.id & ((1u << CVXIF_ID_W) - 1), req.rs1, vtype);
+    }
+
+    // Expected writebacks not yet seen
+    size_t pending() const { return q.size(); }
+
+    bool clean() const { return mismatches == 0 && unexpected == 0 && dma_collisions == 0 && q.empty(); }
+
+    void report(std::ostream& os) const {
+        os << "[SCB] " << issued << " instructions, " << uops << " uops: " << checked << " checked, "
+           << mismatches << " mismatches, " << unchecked << " unchecked, " << unexpected << " unexpected, "
+           << dma_collisions << " lost to DMA, " << q.size() << " pending" << std::endl;
+    }
+
+    void sample() {
+        if (!on) {
+            parked = true;
+            next_trigger(arm_ev);
+            return;
+        }
+        if (parked) {
+            parked = false;
+            next_trigger(); // Back to the static sensitivity (clk posedge)
+            return;
+        }
+        const top_t& t = *top;
+
+        // Writeback first: it belongs to an instruction issued in an
+        // earlier cycle, the shadow already holds its result
+        bool dma = t.dma_we_i.read();
+        if (t.s_valid_o.read()) {
+            if (dma) dma_collisions++;
+            retire(t.s_id_o.read().to_uint(), t.s_vd_o.read().to_uint(), t.s_result_o.read());
+        }
+        if (dma) {
+            uint32_t a = t.dma_addr_i.read().to_uint();
+            shadow[a] = t.dma_wdata_i.read();
+            known[a] = true;
+        }
+        if (t.x_issue_valid_i.read() && t.x_issue_ready_o.read())
+            predict(t.x_issue_instr_i.read().to_uint(), t.x_issue_id_i.read().to_uint(),
+                    t.x_issue_rs1_i.read().to_uint(), t.csr_vtype_i.read().to_uint());
+    }
+
+    SC_HAS_PROCESS(hp_vpu_scoreboard_t);
+    hp_vpu_scoreboard_t(sc_module_name name, top_t* t) : sc_module(name) {
+        top = t;
+        issued = uops = checked = mismatches = unchecked = unexpected = dma_collisions = 0;
+        max_reports = 10;
+        reports = 0;
+        on = false;
+        parked = false;
+        for (int r = 0; r < 32; r++) known[r] = false;
+        SC_METHOD(sample);
+        sensitive << top->clk.pos();
+        dont_initialize();
+    }
+
+private:
+    std::deque<expect_t> q;
+    vreg_t shadow[32];
+    bool known[32];
+    decode_cache dcache;
+    int reports;
+    bool on;
+    bool parked;
+    sc_event arm_ev;
+
+    // Same uop expansion and operand selection as hp_vpu_func::execute
+    void predict(uint32_t instr, uint32_t id, uint32_t rs1, uint32_t vtype) {
+        sew_e sew = (sew_e)((vtype >> 3) & 0x7);
+        int total = 1 << (vtype & 0x7);
+        issued++;
+        for (int u = 0; u < total; u++) {
+            const decoded_uop_t& d = dcache.lookup(instr, vtype & 0x3F);
+            int vd = d.vd, vs1 = d.vs1, vs2 = d.vs2;
+            expect_t e;
+            e.id = id;
+            e.vd = vd;
+            e.instr = instr;
+            e.op = d.op;
+            e.checked = golden_t::supports(d.op) && known[vs2] && known[vd] &&
+                        (d.is_vx || known[vs1]) && (d.vm || known[0]);
+            if (e.checked) {
+                uint32_t scalar = d.is_vx ? (d.is_opivi ? d.imm.to_uint() : rs1) : 0;
+                e.data = golden_t::compute(d.op, sew, shadow[vs1], shadow[vs2], shadow[vd], shadow[0], d.vm,
+                                           d.is_vx, scalar);
+                shadow[vd] = e.data;
+            }
+            known[vd] = e.checked;
+            q.push_back(e);
+            uops++;
+            instr = d.next_instr;
+        }
+    }
+
+    void retire(uint32_t id, uint32_t vd, const vreg_t& actual) {
+        typename std::deque<expect_t>::iterator it = q.begin();
+        while (it != q.end() && !(it->id == id && it->vd == vd)) ++it;
+        if (it == q.end()) {
+            unexpected++;
+            if (reports++ < max_reports)
+                cout << "[SCB] unexpected writeback id=" << id << " v" << vd << " at " << sc_time_stamp() << endl;
+            return;
+        }
+        expect_t e = *it;
+        q.erase(it);
+        if (!e.checked) {
+            unchecked++;
+            return;
+        }
+        checked++;
+        if (actual == e.data) return;
+        mismatches++;
+        if (reports++ < max_reports) {
+            cout << "[SCB] MISMATCH id=" << e.id << " v" << e.vd << " instr=0x" << std::hex << std::setw(8)
+                 << std::setfill('0') << e.instr << std::dec << std::setfill(' ') << " op=" << (int)e.op
+                 << " at " << sc_time_stamp() << endl;
+            cout << "[SCB]   DUT  " << actual << endl;
+            cout << "[SCB]   GOLD " << e.data << endl;
+        }
+        if (on_error) on_error(e, actual);
+    }
+};
+
+typedef hp_vpu_scoreboard_t<cfg_default> hp_vpu_scoreboard;
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_SCOREBOARD_H
@@ -0,0 +1,333 @@
+#include "hp_vpu_simd.h"
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HP_VPU_SIMD_X86 1
+#define HP_SSE4 __attribute__((target("sse4.1")))
+#define HP_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace hp_vpu {
+namespace simd {
+
+kernel_fn g_kernels[K_NUM][3];
+
+static inline bool is_cmp(int op) { return op >= K_MSEQ; }
+
+// ----------------------------------------------------------------------
+// Portable scalar kernels (word shifts, endian independent)
+// ----------------------------------------------------------------------
+
+template<int W> static inline int64_t sx(uint64_t v) {
+    return (int64_t)(v << (64 - W)) >> (64 - W);
+}
+
+template<int W, int OP> static inline uint64_t elem_op(uint64_t ua, uint64_t ub) {
+    const uint64_t umax = (1ULL << W) - 1;
+    const int64_t smax = (1LL << (W - 1)) - 1;
+    const int64_t smin = -(1LL << (W - 1));
+    int64_t sa = sx<W>(ua), sb = sx<W>(ub);
+
+    switch (OP) {
+        case K_ADD:    return ua + ub;
+        case K_SUB:    return ua - ub;
+        case K_MUL:    return ua * ub;
+        case K_MULH:   return (uint64_t)(sa * sb) >> W;
+        case K_MULHU:  return (ua * ub) >> W;
+        case K_MULHSU: return (uint64_t)(sa * (int64_t)ub) >> W;
+        case K_MINU:   return (ua < ub) ? ua : ub;
+        case K_MIN:    return (sa < sb) ? ua : ub;
+        case K_MAXU:   return (ua < ub) ? ub : ua;
+        case K_MAX:    return (sa < sb) ? ub : ua;
+        case K_SADDU:  { uint64_t s = ua + ub; return (s > umax) ? umax : s; }
+        case K_SADD:   { int64_t s = sa + sb; return (uint64_t)((s > smax) ? smax : (s < smin) ? smin : s); }
+        case K_SSUBU:  return (ua < ub) ? 0 : (ua - ub);
+        case K_SSUB:   { int64_t s = sa - sb; return (uint64_t)((s > smax) ? smax : (s < smin) ? smin : s); }
+        case K_MSEQ:   return ua == ub;
+        case K_MSNE:   return ua != ub;
+        case K_MSLTU:  return ua < ub;
+        case K_MSLT:   return sa < sb;
+        case K_MSLEU:  return ua <= ub;
+        case K_MSLE:   return sa <= sb;
+        case K_MSGTU:  return ua > ub;
+        case K_MSGT:   return sa > sb;
+        default:       return 0;
+    }
+}
+
+template<int W, int OP> static void k_scalar(uint64_t* d, const uint64_t* a, const uint64_t* b, int nwords) {
+    const uint64_t m = (1ULL << W) - 1;
+    const int per_word = 64 / W;
+
+    if (is_cmp(OP)) {
+        uint64_t bits = 0;
+        for (int i = 0; i < nwords; i++) {
+            for (int e = 0; e < per_word; e++) {
+                uint64_t ua = (a[i] >> (e * W)) & m;
+                uint64_t ub = (b[i] >> (e * W)) & m;
+                bits |= elem_op<W, OP>(ua, ub) << (i * per_word + e);
+            }
+        }
+        d[0] = bits;
+        for (int i = 1; i < nwords; i++) d[i] = 0;
+        return;
+    }
+
+    for (int i = 0; i < nwords; i++) {
+        uint64_t r = 0;
+        for (int e = 0; e < per_word; e++) {
+            uint64_t ua = (a[i] >> (e * W)) & m;
+            uint64_t ub = (b[i] >> (e * W)) & m;
+            r |= (elem_op<W, OP>(ua, ub) & m) << (e * W);
+        }
+        d[i] = r;
+    }
+}
+
+#ifdef HP_VPU_SIMD_X86
+
+// Which (SEW, op) pairs have a native SSE4.1/AVX2 form (same set for both)
+static bool simd_ok(int w, int op) {
+    switch (op) {
+        case K_MULH: case K_MULHU: return w == 16;
+        case K_MULHSU:             return false;
+        case K_SADDU: case K_SADD:
+        case K_SSUBU: case K_SSUB: return w != 32;
+        default:                   return true;
+    }
+}
+
+// ----------------------------------------------------------------------
+// SSE4.1 kernels (16-byte blocks, 8-byte tail for DLEN=64)
+// ----------------------------------------------------------------------
+
+template<int W> HP_SSE4 static inline __m128i sse_add(__m128i a, __m128i b) {
+    return (W == 8) ? _mm_add_epi8(a, b) : (W == 16) ? _mm_add_epi16(a, b) : _mm_add_epi32(a, b);
+}
+template<int W> HP_SSE4 static inline __m128i sse_sub(__m128i a, __m128i b) {
+    return (W == 8) ? _mm_sub_epi8(a, b) : (W == 16) ? _mm_sub_epi16(a, b) : _mm_sub_epi32(a, b);
+}
+template<int W> HP_SSE4 static inline __m128i sse_eq(__m128i a, __m128i b) {
+    return (W == 8) ? _mm_cmpeq_epi8(a, b) : (W == 16) ? _mm_cmpeq_epi16(a, b) : _mm_cmpeq_epi32(a, b);
+}
+template<int W> HP_SSE4 static inline __m128i sse_gt(__m128i a, __m128i b) {
+    return (W == 8) ? _mm_cmpgt_epi8(a, b) : (W == 16) ? _mm_cmpgt_epi16(a, b) : _mm_cmpgt_epi32(a, b);
+}
+template<int W> HP_SSE4 static inline __m128i sse_gtu(__m128i a, __m128i b) {
+    __m128i sign = (W == 8) ? _mm_set1_epi8((char)0x80) : (W == 16) ? _mm_set1_epi16((short)0x8000) : _mm_set1_epi32((int)0x80000000);
+    return sse_gt<W>(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+}
+HP_SSE4 static inline __m128i sse_not(__m128i a) {
+    return _mm_xor_si128(a, _mm_set1_epi32(-1));
+}
+
+template<int W, int OP> HP_SSE4 static inline __m128i sse_op(__m128i a, __m128i b) {
+    switch (OP) {
+        case K_ADD: return sse_add<W>(a, b);
+        case K_SUB: return sse_sub<W>(a, b);
+        case K_MUL:
+            if (W == 8) { // No 8-bit multiply: even/odd bytes through 16-bit lanes
+                __m128i even = _mm_mullo_epi16(a, b);
+                __m128i odd  = _mm_mullo_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+                return _mm_or_si128(_mm_and_si128(even, _mm_set1_epi16(0x00FF)), _mm_slli_epi16(odd, 8));
+            }
+            return (W == 16) ? _mm_mullo_epi16(a, b) : _mm_mullo_epi32(a, b);
+        case K_MULH:  return _mm_mulhi_epi16(a, b);
+        case K_MULHU: return _mm_mulhi_epu16(a, b);
+        case K_MINU: return (W == 8) ? _mm_min_epu8(a, b) : (W == 16) ? _mm_min_epu16(a, b) : _mm_min_epu32(a, b);
+        case K_MIN:  return (W == 8) ? _mm_min_epi8(a, b) : (W == 16) ? _mm_min_epi16(a, b) : _mm_min_epi32(a, b);
+        case K_MAXU: return (W == 8) ? _mm_max_epu8(a, b) : (W == 16) ? _mm_max_epu16(a, b) : _mm_max_epu32(a, b);
+        case K_MAX:  return (W == 8) ? _mm_max_epi8(a, b) : (W == 16) ? _mm_max_epi16(a, b) : _mm_max_epi32(a, b);
+        case K_SADDU: return (W == 8) ? _mm_adds_epu8(a, b) : _mm_adds_epu16(a, b);
+        case K_SADD:  return (W == 8) ? _mm_adds_epi8(a, b) : _mm_adds_epi16(a, b);
+        case K_SSUBU: return (W == 8) ? _mm_subs_epu8(a, b) : _mm_subs_epu16(a, b);
+        case K_SSUB:  return (W == 8) ? _mm_subs_epi8(a, b) : _mm_subs_epi16(a, b);
+        case K_MSEQ:  return sse_eq<W>(a, b);
+        case K_MSNE:  return sse_not(sse_eq<W>(a, b));
+        case K_MSLTU: return sse_gtu<W>(b, a);
+        case K_MSLT:  return sse_gt<W>(b, a);
+        case K_MSLEU: return sse_not(sse_gtu<W>(a, b));
+        case K_MSLE:  return sse_not(sse_gt<W>(a, b));
+        case K_MSGTU: return sse_gtu<W>(a, b);
+        case K_MSGT:  return sse_gt<W>(a, b);
+        default:      return _mm_setzero_si128();
+    }
+}
+
+// One mask bit per element of a compare result
+template<int W> HP_SSE4 static inline uint64_t sse_movemask(__m128i m) {
+    if (W == 8)  return (uint32_t)_mm_movemask_epi8(m);
+    if (W == 16) return (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(m, _mm_setzero_si128()));
+    return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(m));
+}
+
+// Process words [w0, nwords); compare bits are accumulated into `bits`
+template<int W, int OP> HP_SSE4 static inline void sse_run(uint64_t* d, const uint64_t* a, const uint64_t* b,
+                                                          int w0, int nwords, uint64_t& bits) {
+    const int per_word = 64 / W;
+    int i = w0;
+    for (; i + 2 <= nwords; i += 2) {
+        __m128i r = sse_op<W, OP>(_mm_loadu_si128((const __m128i*)(a + i)), _mm_loadu_si128((const __m128i*)(b + i)));
+        if (is_cmp(OP)) bits |= sse_movemask<W>(r) << (i * per_word);
+        else _mm_storeu_si128((__m128i*)(d + i), r);
+    }
+    if (i < nwords) { // Single-word tail (DLEN=64, or odd word count)
+        __m128i r = sse_op<W, OP>(_mm_loadl_epi64((const __m128i*)(a + i)), _mm_loadl_epi64((const __m128i*)(b + i)));
+        if (is_cmp(OP)) bits |= (sse_movemask<W>(r) & ((1ULL << per_word) - 1)) << (i * per_word);
+        else _mm_storel_epi64((__m128i*)(d + i), r);
+    }
+}
+
+template<int W, int OP> HP_SSE4 static void k_sse4(uint64_t* d, const uint64_t* a, const uint64_t* b, int nwords) {
+    uint64_t bits = 0;
+    sse_run<W, OP>(d, a, b, 0, nwords, bits);
+    if (is_cmp(OP)) {
+        d[0] = bits;
+        for (int i = 1; i < nwords; i++) d[i] = 0;
+    }
+}
+
+// ----------------------------------------------------------------------
+// AVX2 kernels (32-byte blocks, SSE4.1 tail)
+// ----------------------------------------------------------------------
+
+template<int W> HP_AVX2 static inline __m256i avx_eq(__m256i a, __m256i b) {
+    return (W == 8) ? _mm256_cmpeq_epi8(a, b) : (W == 16) ? _mm256_cmpeq_epi16(a, b) : _mm256_cmpeq_epi32(a, b);
+}
+template<int W> HP_AVX2 static inline __m256i avx_gt(__m256i a, __m256i b) {
+    return (W == 8) ? _mm256_cmpgt_epi8(a, b) : (W == 16) ? _mm256_cmpgt_epi16(a, b) : _mm256_cmpgt_epi32(a, b);
+}
+template<int W> HP_AVX2 static inline __m256i avx_gtu(__m256i a, __m256i b) {
+    __m256i sign = (W == 8) ? _mm256_set1_epi8((char)0x80) : (W == 16) ? _mm256_set1_epi16((short)0x8000) : _mm256_set1_epi32((int)0x80000000);
+    return avx_gt<W>(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+}
+HP_AVX2 static inline __m256i avx_not(__m256i a) {
+    return _mm256_xor_si256(a, _mm256_set1_epi32(-1));
+}
+
+template<int W, int OP> HP_AVX2 static inline __m256i avx_op(__m256i a, __m256i b) {
+    switch (OP) {
+        case K_ADD: return (W == 8) ? _mm256_add_epi8(a, b) : (W == 16) ? _mm256_add_epi16(a, b) : _mm256_add_epi32(a, b);
+        case K_SUB: return (W == 8) ? _mm256_sub_epi8(a, b) : (W == 16) ? _mm256_sub_epi16(a, b) : _mm256_sub_epi32(a, b);
+        case K_MUL:
+            if (W == 8) {
+                __m256i even = _mm256_mullo_epi16(a, b);
+                __m256i odd  = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+                return _mm256_or_si256(_mm256_and_si256(even, _mm256_set1_epi16(0x00FF)), _mm256_slli_epi16(odd, 8));
+            }
+            return (W == 16) ? _mm256_mullo_epi16(a, b) : _mm256_mullo_epi32(a, b);
+        case K_MULH:  return _mm256_mulhi_epi16(a, b);
+        case K_MULHU: return _mm256_mulhi_epu16(a, b);
+        case K_MINU: return (W == 8) ? _mm256_min_epu8(a, b) : (W == 16) ? _mm256_min_epu16(a, b) : _mm256_min_epu32(a, b);
+        case K_MIN:  return (W == 8) ? _mm256_min_epi8(a, b) : (W == 16) ? _mm256_min_epi16(a, b) : _mm256_min_epi32(a, b);
+        case K_MAXU: return (W == 8) ? _mm256_max_epu8(a, b) : (W == 16) ? _mm256_max_epu16(a, b) : _mm256_max_epu32(a, b);
+        case K_MAX:  return (W == 8) ? _mm256_max_epi8(a, b) : (W == 16) ? _mm256_max_epi16(a, b) : _mm256_max_epi32(a, b);
+        case K_SADDU: return (W == 8) ? _mm256_adds_epu8(a, b) : _mm256_adds_epu16(a, b);
+        case K_SADD:  return (W == 8) ? _mm256_adds_epi8(a, b) : _mm256_adds_epi16(a, b);
+        case K_SSUBU: return (W == 8) ? _mm256_subs_epu8(a, b) : _mm256_subs_epu16(a, b);
+        case K_SSUB:  return (W == 8) ? _mm256_subs_epi8(a, b) : _mm256_subs_epi16(a, b);
+        case K_MSEQ:  return avx_eq<W>(a, b);
+        case K_MSNE:  return avx_not(avx_eq<W>(a, b));
+        case K_MSLTU: return avx_gtu<W>(b, a);
+        case K_MSLT:  return avx_gt<W>(b, a);
+        case K_MSLEU: return avx_not(avx_gtu<W>(a, b));
+        case K_MSLE:  return avx_not(avx_gt<W>(a, b));
+        case K_MSGTU: return avx_gtu<W>(a, b);
+        case K_MSGT:  return avx_gt<W>(a, b);
+        default:      return _mm256_setzero_si256();
+    }
+}
+
+template<int W> HP_AVX2 static inline uint64_t avx_movemask(__m256i m) {
+    if (W == 8)  return (uint32_t)_mm256_movemask_epi8(m);
+    if (W == 16) { // packs works per 128-bit half, so pack the halves together instead
+        __m128i lo = _mm256_castsi256_si128(m);
+        __m128i hi = _mm256_extracti128_si256(m, 1);
+        return (uint32_t)_mm_movemask_epi8(_mm_packs_epi16(lo, hi));
+    }
+    return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(m));
+}
+
+template<int W, int OP> HP_AVX2 static void k_avx2(uint64_t* d, const uint64_t* a, const uint64_t* b, int nwords) {
+    const int per_word = 64 / W;
+    uint64_t bits = 0;
+    int i = 0;
+    for (; i + 4 <= nwords; i += 4) {
+        __m256i r = avx_op<W, OP>(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        if (is_cmp(OP)) bits |= avx_movemask<W>(r) << (i * per_word);
+        else _mm256_storeu_si256((__m256i*)(d + i), r);
+    }
+    sse_run<W, OP>(d, a, b, i, nwords, bits);
+    if (is_cmp(OP)) {
+        d[0] = bits;
+        for (int j = 1; j < nwords; j++) d[j] = 0;
+    }
+}
+
+#endif // HP_VPU_SIMD_X86
+
+// ----------------------------------------------------------------------
+// Dispatch
+// ----------------------------------------------------------------------
+
+template<int W, int OP> static kernel_fn pick(isa_e isa) {
+#ifdef HP_VPU_SIMD_X86
+    if (simd_ok(W, OP)) {
+        if (isa == ISA_AVX2) return &k_avx2<W, OP>;
+        if (isa == ISA_SSE4) return &k_sse4<W, OP>;
+    }
+#endif
+    return &k_scalar<W, OP>;
+}
+
+template<int OP> static void fill_op(isa_e isa) {
+    g_kernels[OP][0] = pick<8, OP>(isa);
+    g_kernels[OP][1] = pick<16, OP>(isa);
+    g_kernels[OP][2] = pick<32, OP>(isa);
+    fill_op<OP + 1>(isa);
+}
+template<> void fill_op<K_NUM>(isa_e) {}
+
+static isa_e host_isa() {
+#ifdef HP_VPU_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return ISA_AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return ISA_SSE4;
+#endif
+    return ISA_SCALAR;
+}
+
+static isa_e g_isa = ISA_SCALAR;
+
+void select_isa(isa_e isa) {
+    isa_e host = host_isa();
+    g_isa = (isa > host) ? host : isa;
+    fill_op<0>(g_isa);
+}
+
+isa_e active_isa() { return g_isa; }
+
+const char* isa_name(isa_e isa) {
+    switch (isa) {
+        case ISA_AVX2: return "avx2";
+        case ISA_SSE4: return "sse4";
+        default:       return "scalar";
+    }
+}
+
+// Resolve once at load time
+static struct kernel_init {
+    kernel_init() {
+        isa_e isa = ISA_AVX2;
+        if (const char* env = getenv("HP_VPU_SIMD")) {
+            if (!strcmp(env, "scalar")) isa = ISA_SCALAR;
+            else if (!strcmp(env, "sse4")) isa = ISA_SSE4;
+        }
+        select_isa(isa);
+    }
+} s_kernel_init;
+
+} // namespace simd
+} // namespace hp_vpu
@@ -0,0 +1,46 @@
+#ifndef HP_VPU_SIMD_H
+#define HP_VPU_SIMD_H
+
+#include <cstdint>
+
+namespace hp_vpu {
+namespace simd {
+
+// Element-wise kernels shared by hp_vpu_lanes and GoldenModel.
+// Each (op, SEW) pair resolves once at startup to an AVX2, SSE4.1 or portable
+// scalar implementation; pairs without a native instruction (e.g. 32-bit
+// saturating add, 8/32-bit mulh) always use the scalar kernel.
+// Min/max, saturating and compare groups follow the vpu_op_e order.
+enum kop_e {
+    K_ADD, K_SUB,
+    K_MUL, K_MULH, K_MULHU, K_MULHSU,
+    K_MINU, K_MIN, K_MAXU, K_MAX,
+    K_SADDU, K_SADD, K_SSUBU, K_SSUB,
+    // Compares: packed mask bits (bit i = element i) in d[0], rest of d zeroed
+    K_MSEQ, K_MSNE, K_MSLTU, K_MSLT, K_MSLEU, K_MSLE, K_MSGTU, K_MSGT,
+    K_NUM
+};
+
+enum isa_e { ISA_SCALAR = 0, ISA_SSE4, ISA_AVX2 };
+
+// d = a <op> b over nwords packed 64-bit words. For compares d must not alias a/b.
+typedef void (*kernel_fn)(uint64_t* d, const uint64_t* a, const uint64_t* b, int nwords);
+
+// Active dispatch table, indexed [op][sew] (sew = SEW_8/16/32)
+extern kernel_fn g_kernels[K_NUM][3];
+
+inline kernel_fn kernel(kop_e op, int sew) {
+    return g_kernels[op][(sew > 2) ? 2 : sew];
+}
+
+// Best ISA supported by the host, overridable with HP_VPU_SIMD=scalar|sse4|avx2
+isa_e active_isa();
+const char* isa_name(isa_e isa);
+
+// Rebuild the table for a given ISA (clamped to what the host supports)
+void select_isa(isa_e isa);
+
+} // namespace simd
+} // namespace hp_vpu
+
+#endif // HP_VPU_SIMD_H
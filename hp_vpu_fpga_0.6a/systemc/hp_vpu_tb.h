@@ -0,0 +1,139 @@
+#ifndef HP_VPU_TB_H
+#define HP_VPU_TB_H
+
+#include <systemc.h>
+#include "hp_vpu_pkg.h"
+#include "hp_vpu_top.h"
+#include "hp_vpu_hybrid.h"
+#include "hp_vpu_drivers.h"
+#include "hp_vpu_flightrec.h"
+#include "hp_vpu_scoreboard.h"
+#include "hp_vpu_pipeview.h"
+#include "hp_vpu_json.h"
+
+namespace hp_vpu {
+
+// Standard testbench around hp_vpu_top: clock source (idle skipping on,
+// see hp_vpu_clkgen), pin signals, the DUT, the
+// issue and DMA drivers on the pins, a flight recorder, a pipeline
+// monitor and a commit scoreboard (all off until enabled) and a hp_vpu_hybrid
+// runner using the drivers.
+// Construct in sc_main before the first sc_start (elaboration), one per
+// process. Typical use after reset(): dma.write(...), issue.push(...),
+// then one sc_start(), which returns once the pipeline has drained.
+template<class CFG>
+struct vpu_tb_t {
+    typedef vreg<CFG::DLEN> vreg_t;
+
+    sc_time period;
+    sc_signal<bool> clk;
+    sc_signal<bool> rst_n;
+    sc_signal<bool> x_issue_valid;
+    sc_signal<sc_uint<32>> x_issue_instr;
+    sc_signal<sc_uint<CVXIF_ID_W>> x_issue_id;
+    sc_signal<sc_uint<32>> x_issue_rs1;
+    sc_signal<sc_uint<32>> x_issue_rs2;
+    sc_signal<bool> x_issue_ready;
+    sc_signal<sc_uint<32>> csr_vtype;
+    sc_signal<sc_uint<32>> csr_vl;
+    sc_signal<bool> dma_we;
+    sc_signal<sc_uint<5>> dma_addr;
+    sc_signal<vreg_t> dma_wdata;
+
+    hp_vpu_clkgen clkgen;
+    hp_vpu_top_t<CFG> top;
+    hp_vpu_issue_drv issue;
+    hp_vpu_dma_drv_t<CFG> dma;
+    hp_vpu_flightrec_t<CFG> frec;
+    hp_vpu_pipeview_t<CFG> pview;
+    hp_vpu_scoreboard_t<CFG> scb;
+    hp_vpu_hybrid_t<CFG> runner;
+
+    explicit vpu_tb_t(const sc_time& clk_period = sc_time(2, SC_NS))
+        : period(clk_period), clk("clk"), clkgen("clkgen", clk_period), top("top"), issue("issue"), dma("dma"),
+          frec("frec", &top), pview("pview", &top), scb("scb", &top),
+          runner("runner") {
+        clkgen.clk_o(clk);
+        clkgen.quiet_fn = [this]() { return top.quiescent(); };
+        clkgen.work_fn = [this]() { return issue.busy() || dma.pending() > 0; };
+        clkgen.skip_fn = [this](uint64_t n) { top.credit_idle(n); };
+        clkgen.wake_on = x_issue_valid.value_changed_event() | dma_we.value_changed_event() |
+                         rst_n.value_changed_event() | csr_vtype.value_changed_event() |
+                         csr_vl.value_changed_event() | top.wake_ev | issue.work_ev | dma.work_ev;
+
+        top.clk(clk);
+        top.rst_n(rst_n);
+        top.x_issue_valid_i(x_issue_valid);
+        top.x_issue_instr_i(x_issue_instr);
+        top.x_issue_id_i(x_issue_id);
+        top.x_issue_rs1_i(x_issue_rs1);
+        top.x_issue_rs2_i(x_issue_rs2);
+        top.x_issue_ready_o(x_issue_ready);
+        top.csr_vtype_i(csr_vtype);
+        top.csr_vl_i(csr_vl);
+        top.dma_we_i(dma_we);
+        top.dma_addr_i(dma_addr);
+        top.dma_wdata_i(dma_wdata);
+
+        issue.clk(clk);
+        issue.rst_n(rst_n);
+        issue.valid_o(x_issue_valid);
+        issue.instr_o(x_issue_instr);
+        issue.id_o(x_issue_id);
+        issue.rs1_o(x_issue_rs1);
+        issue.rs2_o(x_issue_rs2);
+        issue.ready_i(x_issue_ready);
+        issue.after = &dma; // Register preloads land before the instructions that read them
+        issue.idle_fn = [this]() { return top.pipeline_idle(); };
+
+        dma.clk(clk);
+        dma.rst_n(rst_n);
+        dma.we_o(dma_we);
+        dma.addr_o(dma_addr);
+        dma.wdata_o(dma_wdata);
+
+        csr_pins_t pins = { &csr_vtype, &csr_vl };
+        runner.bind(&top, &issue, pins, period);
+        runner.scb = &scb;
+    }
+
+    // 10 ns reset, 10 ns settle (as tb_main/tb_full)
+    void reset() {
+        rst_n = 0;
+        x_issue_valid = 0;
+        x_issue_instr = 0;
+        dma_we = 0;
+        sc_start(10, SC_NS);
+        rst_n = 1;
+        sc_start(10, SC_NS);
+    }
+
+    // One reset cycle between tests on the same elaboration: IQ, pipeline
+    // and hazard state cleared; VRF contents and CSR pins kept
+    void soft_reset() {
+        rst_n = 0;
+        sc_start(period);
+        rst_n = 1;
+        sc_start(period);
+    }
+};
+
+typedef vpu_tb_t<cfg_default> vpu_tb;
+
+// VLEN/DLEN from a config/vpu_config*.json file (for with_config)
+inline bool load_config_dims(const std::string& path, int& vlen, int& dlen, std::string* err) {
+    json_value cfg;
+    if (!json_load(path, cfg, err)) return false;
+    const json_value& p = cfg["parameters"];
+    vlen = (int)p["VLEN"].as_int();
+    dlen = (int)p["DLEN"].as_int(vlen);
+    if (vlen <= 0) {
+        if (err) *err = path + ": no parameters.VLEN";
+        return false;
+    }
+    return true;
+}
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_TB_H
@@ -0,0 +1,189 @@
+#ifndef HP_VPU_TOML_H
+#define HP_VPU_TOML_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hp_vpu {
+
+// Minimal TOML reader for the tests/toml/*.toml vector files.
+// key = "string" | integer | array (nested, multi-line, trailing comma),
+// [table] headers (keys stored as "table.key"), # comments. Integers are
+// decimal, 0x/0o/0b, with underscores, kept as 64-bit patterns (negative
+// decimals two's complement); quoted integers ("0xffff...") read the same
+// through as_u64. No floats, dates, inline tables or multi-line strings.
+struct toml_value {
+    enum type_e { T_NONE = 0, T_INT, T_STRING, T_ARRAY };
+    type_e type;
+    uint64_t num;
+    std::string str;
+    std::vector<toml_value> arr;
+
+    toml_value() : type(T_NONE), num(0) {}
+
+    bool is_array() const { return type == T_ARRAY; }
+
+    // Integer, or a string holding one
+    bool as_u64(uint64_t& out) const {
+        if (type == T_INT) { out = num; return true; }
+        if (type == T_STRING) return parse_int(str, out);
+        return false;
+    }
+
+    std::string as_string(const std::string& def = "") const { return type == T_STRING ? str : def; }
+
+    static bool parse_int(const std::string& text, uint64_t& out) {
+        std::string t;
+        for (char c : text) if (c != '_') t += c;
+        bool neg = false;
+        size_t p = 0;
+        if (p < t.size() && (t[p] == '+' || t[p] == '-')) neg = t[p++] == '-';
+        int base = 10;
+        if (t.size() > p + 1 && t[p] == '0') {
+            char x = t[p + 1];
+            if (x == 'x' || x == 'X') base = 16;
+            else if (x == 'o' || x == 'O') base = 8;
+            else if (x == 'b' || x == 'B') base = 2;
+            if (base != 10) p += 2;
+        }
+        if (p >= t.size()) return false;
+        char* end = nullptr;
+        unsigned long long v = std::strtoull(t.c_str() + p, &end, base);
+        if (*end) return false;
+        out = neg ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+        return true;
+    }
+};
+
+struct toml_doc {
+    std::vector<std::pair<std::string, toml_value>> keys; // File order kept
+
+    // "table.key" (or a top-level "key"); a T_NONE value if absent
+    const toml_value& operator[](const std::string& key) const {
+        static const toml_value none;
+        for (const auto& kv : keys) if (kv.first == key) return kv.second;
+        return none;
+    }
+};
+
+class toml_parser {
+public:
+    explicit toml_parser(const std::string& text) : s(text), i(0), line(1) {}
+
+    bool parse(toml_doc& out, std::string* err) {
+        std::string table;
+        bool ok = true;
+        for (;;) {
+            ws(true);
+            if (i >= s.size()) break;
+            if (s[i] == '[') {
+                size_t e = s.find(']', i);
+                if (e == std::string::npos) { ok = false; break; }
+                table = trim(s.substr(i + 1, e - i - 1));
+                i = e + 1;
+                continue;
+            }
+            size_t eq = s.find('=', i);
+            size_t nl = s.find('\n', i);
+            if (eq == std::string::npos || (nl != std::string::npos && nl < eq)) { ok = false; break; }
+            std::string key = trim(s.substr(i, eq - i));
+            if (key.size() >= 2 && key[0] == '"') key = key.substr(1, key.size() - 2);
+            i = eq + 1;
+            out.keys.push_back(std::make_pair(table.empty() ? key : table + "." + key, toml_value()));
+            if (!value(out.keys.back().second)) { ok = false; break; }
+        }
+        if (!ok && err) {
+            std::ostringstream os;
+            os << "TOML parse error at line " << line;
+            *err = os.str();
+        }
+        return ok;
+    }
+
+private:
+    const std::string& s;
+    size_t i;
+    int line;
+
+    static std::string trim(const std::string& t) {
+        size_t b = t.find_first_not_of(" \t\r");
+        size_t e = t.find_last_not_of(" \t\r");
+        return b == std::string::npos ? std::string() : t.substr(b, e - b + 1);
+    }
+
+    // Blanks and comments; newlines too inside arrays and between keys
+    void ws(bool newlines) {
+        while (i < s.size()) {
+            char c = s[i];
+            if (c == '#') {
+                while (i < s.size() && s[i] != '\n') i++;
+            } else if (c == ' ' || c == '\t' || c == '\r') {
+                i++;
+            } else if (c == '\n' && newlines) {
+                line++;
+                i++;
+            } else {
+                break;
+            }
+        }
+    }
+
+    bool value(toml_value& v) {
+        ws(false);
+        if (i >= s.size()) return false;
+        char c = s[i];
+        if (c == '[') {
+            v.type = toml_value::T_ARRAY;
+            i++;
+            for (;;) {
+                ws(true);
+                if (i < s.size() && s[i] == ']') { i++; return true; }
+                v.arr.push_back(toml_value());
+                if (!value(v.arr.back())) return false;
+                ws(true);
+                if (i < s.size() && s[i] == ',') { i++; continue; }
+                if (i < s.size() && s[i] == ']') { i++; return true; }
+                return false;
+            }
+        }
+        if (c == '"' || c == '\'') {
+            size_t e = s.find(c, i + 1);
+            if (e == std::string::npos) return false;
+            v.type = toml_value::T_STRING;
+            v.str = s.substr(i + 1, e - i - 1);
+            i = e + 1;
+            return true;
+        }
+        size_t b = i;
+        while (i < s.size() && s[i] != ',' && s[i] != ']' && s[i] != '\n' && s[i] != '#' && s[i] != ' ' &&
+               s[i] != '\t' && s[i] != '\r')
+            i++;
+        v.type = toml_value::T_INT;
+        return toml_value::parse_int(s.substr(b, i - b), v.num);
+    }
+};
+
+inline bool toml_load(const std::string& path, toml_doc& out, std::string* err) {
+    std::ifstream f(path);
+    if (!f) {
+        if (err) *err = "cannot open " + path;
+        return false;
+    }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    std::string text = ss.str();
+    if (!toml_parser(text).parse(out, err)) {
+        if (err) *err = path + ": " + *err;
+        return false;
+    }
+    return true;
+}
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_TOML_H
@@ -2,16 +2,27 @@
 #define HP_VPU_TOP_H
 
 #include <systemc.h>
+#include <ostream>
 #include "hp_vpu_pkg.h"
+#include "hp_vpu_prof.h"
 #include "hp_vpu_iq.h"
 #include "hp_vpu_decode.h"
 #include "hp_vpu_hazard.h"
 #include "hp_vpu_lanes.h"
 #include "hp_vpu_vrf.h"
+#include "hp_vpu_vreg.h"
+#include "hp_vpu_func.h"
 
 namespace hp_vpu {
 
-SC_MODULE(hp_vpu_top) {
+template<class CFG>
+struct hp_vpu_top_t : sc_module {
+    static const int DLEN = CFG::DLEN;
+    typedef vreg<DLEN> vreg_t;
+    typedef hp_vpu_lanes_t<CFG> lanes_t;
+    typedef hp_vpu_vrf_t<CFG> vrf_t;
+    typedef hp_vpu_func_t<CFG> func_t;
+
     // Clock/Reset
     sc_in<bool> clk;
     sc_in<bool> rst_n;
@@ -31,7 +42,7 @@ SC_MODULE(hp_vpu_top) {
     // DMA Interface
     sc_in<bool> dma_we_i;
     sc_in<sc_uint<5>> dma_addr_i;
-    sc_in<sc_biguint<DLEN>> dma_wdata_i;
+    sc_in<vreg_t> dma_wdata_i;
 
     // IQ <-> Decode Interface
     sc_signal<bool> iq_pop_valid;
@@ -44,6 +55,8 @@ SC_MODULE(hp_vpu_top) {
     // Decode <-> Lanes/Hazard Interface
     sc_signal<bool> dec_valid;
     sc_signal<int> dec_op;
+    sc_signal<int> dec_uclass;
+    sc_signal<int> dec_unit;
     sc_signal<int> dec_sew;
     sc_signal<int> dec_lmul;
     sc_signal<sc_uint<5>> dec_vd, dec_vs1, dec_vs2, dec_vs3;
@@ -54,18 +67,22 @@ SC_MODULE(hp_vpu_top) {
     sc_signal<bool> dec_is_last_uop;
 
     sc_signal<bool> hazard_stall;
+    sc_signal<int>  hazard_reason; // stall_reason_e
 
     // OF Stage Pipeline Registers
     sc_signal<bool> of_valid;
     sc_signal<int>  of_op;
+    sc_signal<int>  of_uclass;
+    sc_signal<int>  of_unit;
     sc_signal<int>  of_sew;
     sc_signal<sc_uint<5>> of_vd;
+    sc_signal<sc_uint<5>> of_vs1, of_vs2, of_vs3; // Re-read while OF is held
     sc_signal<sc_uint<CVXIF_ID_W>> of_id;
     sc_signal<bool> of_is_last_uop;
     sc_signal<bool> of_vm;
     sc_signal<bool> of_is_vx;
     sc_signal<sc_uint<32>> of_scalar;
-    sc_signal<sc_biguint<DLEN>> of_vmask; // Mask read from v0
+    sc_signal<vreg_t> of_vmask; // Mask read from v0
 
     // VRF Read Data (Combinational output from VRF, but VRF has internal register)
     // Wait, VRF has registered read. So read address is latch in VRF.
@@ -79,19 +96,40 @@ SC_MODULE(hp_vpu_top) {
     hp_vpu_iq*     u_iq;
     hp_vpu_decode* u_decode;
     hp_vpu_hazard* u_hazard;
-    hp_vpu_lanes*  u_lanes;
-    hp_vpu_vrf*    u_vrf;
+    lanes_t*       u_lanes;
+    vrf_t*         u_vrf;
+    func_t*        u_func; // Loosely-timed functional mode (shares u_vrf)
+
+    // Simulation mode (run-time switchable, see set_mode)
+    enum sim_mode_e { MODE_CYCLE = 0, MODE_FUNCTIONAL };
+    sim_mode_e mode;
+
+    // Idle-cycle skipping is done by the clock source (hp_vpu_clkgen): while
+    // quiescent() it stops toggling clk, so no process runs and the kernel
+    // jumps to the next event. The posedges it did not deliver come back
+    // through credit_idle(); wake_ev ends a sleep after a backdoor change.
+    sc_event wake_ev;
+    uint64_t posedges;        // Delivered clk posedges
+    uint64_t skipped_cycles;  // Posedges credited by the clock source
+
+    // Issue-slot attribution: every cycle the D -> OF slot is either used or
+    // charged to exactly one slot_cause_e (see slot_attribution)
+    uint64_t slot_cycles[SLOT_COUNT];
+    // Front-end conditions behind lost CV-X-IF issue cycles
+    uint64_t iq_full_cycles;  // x_issue_valid_i high with the IQ full
+    uint64_t lmul_seq_cycles; // IQ head held while D expands an LMUL group
 
     // Lanes connectivity
-    sc_signal<sc_biguint<DLEN>> s_vs1_data, s_vs2_data, s_vs3_data, s_vmask_data;
+    sc_signal<vreg_t> s_vs1_data, s_vs2_data, s_vs3_data, s_vmask_data;
     sc_signal<bool> s_valid_o;
-    sc_signal<sc_biguint<DLEN>> s_result_o;
+    sc_signal<vreg_t> s_result_o;
     sc_signal<sc_uint<5>> s_vd_o;
     sc_signal<sc_uint<CVXIF_ID_W>> s_id_o;
     sc_signal<bool> s_is_last_uop_o;
     sc_signal<bool> s_mac_stall, s_mul_stall, s_multicycle_busy, s_drain_stall;
+    sc_signal<bool> s_lanes_ready;
 
-    // Hazard feedback signals (extended)
+    // Lanes stage status (tracing / pipeline_idle)
     sc_signal<bool> h_e1_valid, h_e1m_valid, h_e2_valid, h_e3_valid;
     sc_signal<sc_uint<5>> h_e1_vd, h_e1m_vd, h_e2_vd, h_e3_vd;
     sc_signal<bool> h_r2a_valid, h_r2b_valid;
@@ -103,38 +141,44 @@ SC_MODULE(hp_vpu_top) {
 
     // Constant 0 addr for mask read (v0)
     sc_signal<sc_uint<5>> c_addr_v0;
+    // Read addresses: D sources, or the OF sources while OF is held
+    sc_signal<sc_uint<5>> vrf_raddr1, vrf_raddr2, vrf_raddr3;
     // Read enables
     sc_signal<bool> ren_all; // Simplified read enable
     sc_signal<bool> ren_mask;
 
     // Byte enables for write
-    sc_signal<sc_biguint<DLEN/8>> vrf_be;
+    sc_signal<sc_uint<DLEN/8>> vrf_be;
 
     // MUX signals for VRF Write Port
     sc_signal<bool> vrf_mux_we;
     sc_signal<sc_uint<5>> vrf_mux_waddr;
-    sc_signal<sc_biguint<DLEN>> vrf_mux_wdata;
+    sc_signal<vreg_t> vrf_mux_wdata;
 
     // OF Stage Logic
     void of_stage_logic() {
+        HP_VPU_PROF_SCOPE(PROF_OF_STAGE);
         if (!rst_n.read() || s_flush.read()) {
             of_valid.write(false);
             of_op.write(OP_NOP);
+            of_unit.write(EU_NONE);
             return;
         }
 
-        // Stall logic: if hazard stall, freeze OF?
-        // Or if hazard stall, bubble OF?
-        // Usually hazard stalls decode. OF latches decode output if not stalled?
-        // Simplified: stall freezes the pipeline shift.
-        if (hazard_stall.read()) return;
+        // Hold while the lanes cannot take the OF instruction
+        if (of_valid.read() && !s_lanes_ready.read()) return;
 
-        // Advance D -> OF
-        if (dec_valid.read()) {
+        // Advance D -> OF (issue), or bubble on a hazard stall
+        if (dec_valid.read() && !hazard_stall.read()) {
             of_valid.write(true);
             of_op.write(dec_op.read());
+            of_uclass.write(dec_uclass.read());
+            of_unit.write(dec_unit.read());
             of_sew.write(dec_sew.read());
             of_vd.write(dec_vd.read());
+            of_vs1.write(dec_vs1.read());
+            of_vs2.write(dec_vs2.read());
+            of_vs3.write(dec_vs3.read());
             of_id.write(dec_id.read());
             of_is_last_uop.write(dec_is_last_uop.read());
             of_vm.write(dec_vm.read());
@@ -146,20 +190,26 @@ SC_MODULE(hp_vpu_top) {
     }
 
     void vrf_control_logic() {
+        HP_VPU_PROF_SCOPE(PROF_VRF_CONTROL);
         c_addr_v0.write(0);
         s_flush.write(false);
 
+        // A held OF instruction keeps its own operands on the read ports
+        // (registered read: the data must still be there next cycle)
+        bool of_hold = of_valid.read() && !s_lanes_ready.read();
+        vrf_raddr1.write(of_hold ? of_vs1.read() : dec_vs1.read());
+        vrf_raddr2.write(of_hold ? of_vs2.read() : dec_vs2.read());
+        vrf_raddr3.write(of_hold ? of_vs3.read() : dec_vs3.read());
+
         // Read enables - simple, always read if valid decode (power optimization skipped)
-        ren_all.write(dec_valid.read());
+        ren_all.write(dec_valid.read() || of_hold);
         ren_mask.write(true); // Always read mask for simplicity
 
         // Write Byte Enables - Full width for now, or based on masking?
         // Ideally should come from Lanes/WB stage logic.
         // For this model level, we assume full write or handled by mask in lanes.
         // But VRF has be_i.
-        sc_biguint<DLEN/8> all_ones = 0;
-        all_ones = ~all_ones;
-        vrf_be.write(all_ones);
+        vrf_be.write(vreg_t::width_mask(DLEN/8));
 
         // Write Port MUX (DMA priority)
         if (dma_we_i.read()) {
@@ -173,7 +223,125 @@ SC_MODULE(hp_vpu_top) {
         }
     }
 
-    SC_CTOR(hp_vpu_top) {
+    // True when no instruction is anywhere between the IQ and writeback
+    bool pipeline_idle() const {
+        return u_iq->count.read() == 0 && !iq_pop_valid.read() &&
+               !dec_valid.read() && !of_valid.read() &&
+               !h_e1_valid.read() && !h_e1m_valid.read() && !h_e2_valid.read() && !h_e3_valid.read() &&
+               !s_multicycle_busy.read() && !s_valid_o.read() &&
+               u_hazard->pending.read() == 0;
+    }
+
+    // Nothing in flight and no external input asking for a cycle
+    bool quiescent() const {
+        return rst_n.read() && !x_issue_valid_i.read() && !dma_we_i.read() && pipeline_idle();
+    }
+
+    // Youngest in-flight stage writing register r (OF first, WB last)
+    slot_cause_e raw_stage(int r) const {
+        if (of_valid.read() && (int)of_vd.read() == r)      return SLOT_RAW_OF;
+        if (h_e1_valid.read() && (int)h_e1_vd.read() == r)   return SLOT_RAW_E1;
+        if (h_e1m_valid.read() && (int)h_e1m_vd.read() == r) return SLOT_RAW_E1M;
+        if (h_e2_valid.read() && (int)h_e2_vd.read() == r)   return SLOT_RAW_E2;
+        if (h_e3_valid.read() && (int)h_e3_vd.read() == r)   return SLOT_RAW_E3;
+        if (h_r2a_valid.read() && (int)h_r2a_vd.read() == r) return SLOT_RAW_R2A;
+        if (h_r2b_valid.read() && (int)h_r2b_vd.read() == r) return SLOT_RAW_R2B;
+        if (h_w2_valid.read() && (int)h_w2_vd.read() == r)   return SLOT_RAW_W2;
+        if (s_valid_o.read() && (int)s_vd_o.read() == r)     return SLOT_RAW_WB;
+        return SLOT_RAW_FSM;
+    }
+
+    // Clocked: charge the cycle that just ended (pre-edge values)
+    void slot_attribution() {
+        HP_VPU_PROF_SCOPE(PROF_SLOT_ATTRIBUTION);
+        posedges++;
+        if (!rst_n.read()) return;
+
+        slot_cause_e c;
+        stall_reason_e why = (stall_reason_e)hazard_reason.read();
+        if (dec_valid.read()) {
+            switch (why) {
+                case STALL_NONE: c = SLOT_ISSUED; break;
+                case STALL_RAW:  c = raw_stage(u_hazard->blocking_reg(why)); break;
+                case STALL_WAW:  c = SLOT_WAW; break;
+                case STALL_DRAIN: c = SLOT_DRAIN_STALL; break;
+                default:
+                    c = s_multicycle_busy.read() ? SLOT_MULTICYCLE_BUSY :
+                        s_mul_stall.read() ? SLOT_MUL_STALL : SLOT_LANES_BUSY;
+                    break;
+            }
+        } else {
+            c = (u_iq->count.read() == 0 && !iq_pop_valid.read()) ? SLOT_IQ_EMPTY : SLOT_DECODE;
+        }
+        slot_cycles[c]++;
+
+        if (x_issue_valid_i.read() && u_iq->count.read() >= hp_vpu_iq::DEPTH) iq_full_cycles++;
+        if (iq_pop_valid.read() && u_decode->in_multicycle_seq.read()) lmul_seq_cycles++;
+    }
+
+    // Zero slot, hazard and lanes statistics (hp_vpu_hybrid: end of warm-up)
+    void clear_stats() {
+        for (int i = 0; i < SLOT_COUNT; i++) slot_cycles[i] = 0;
+        iq_full_cycles = 0;
+        lmul_seq_cycles = 0;
+        u_hazard->clear_stats();
+        u_lanes->clear_stats();
+    }
+
+    uint64_t lost_slots() const {
+        uint64_t n = 0;
+        for (int i = SLOT_ISSUED + 1; i < SLOT_COUNT; i++) n += slot_cycles[i];
+        return n;
+    }
+
+    // Attribution and hazard statistics as one JSON object (sync the clock source first)
+    void stall_json(std::ostream& os) const {
+        uint64_t cycles = slot_cycles[SLOT_ISSUED] + lost_slots();
+        os << "{\n  \"cycles\": " << cycles << ",\n";
+        os << "  \"issue_slots\": {\n    \"used\": " << slot_cycles[SLOT_ISSUED]
+           << ",\n    \"lost\": " << lost_slots() << ",\n    \"lost_by_cause\": {";
+        for (int i = SLOT_ISSUED + 1; i < SLOT_COUNT; i++)
+            os << (i > SLOT_ISSUED + 1 ? ", " : "") << "\"" << slot_cause_name(i) << "\": " << slot_cycles[i];
+        os << "}\n  },\n";
+        os << "  \"frontend\": {\"iq_full\": " << iq_full_cycles << ", \"lmul_seq_busy\": " << lmul_seq_cycles << "},\n";
+        os << "  \"hazard\": ";
+        u_hazard->report_json(os);
+        os << "\n}\n";
+    }
+
+    // Cycle number of the last posedge, skipped ones included
+    uint64_t cycle_count() const { return posedges + skipped_cycles; }
+
+    // Posedges the clock source skipped: no stalls, nothing queued
+    void credit_idle(uint64_t n) {
+        skipped_cycles += n;
+        u_hazard->skip(n);
+        slot_cycles[SLOT_IQ_EMPTY] += n;
+    }
+
+    // End an idle-skip sleep after a backdoor change (IQ preload, mode switch)
+    void wake() { wake_ev.notify(SC_ZERO_TIME); }
+
+    // Switch between the pin-level pipeline and the TLM functional model.
+    // Both work on u_vrf, so no register state moves. Entering functional
+    // mode seeds the CSR shadow from the pins; the pipeline must be drained
+    // first (returns false otherwise). Keep x_issue_valid_i low while in
+    // functional mode and issue through u_func->issue_tsock instead.
+    bool set_mode(sim_mode_e m) {
+        if (m == mode) return true;
+        if (m == MODE_FUNCTIONAL) {
+            if (!pipeline_idle()) return false;
+            u_func->vtype = csr_vtype_i.read().to_uint();
+            u_func->vl = csr_vl_i.read().to_uint();
+        }
+        u_func->enabled = (m == MODE_FUNCTIONAL);
+        mode = m;
+        wake();
+        return true;
+    }
+
+    SC_HAS_PROCESS(hp_vpu_top_t);
+    hp_vpu_top_t(sc_module_name name) : sc_module(name) {
         // Instantiate IQ
         u_iq = new hp_vpu_iq("u_iq");
         u_iq->clk(clk);
@@ -208,6 +376,8 @@ SC_MODULE(hp_vpu_top) {
 
         u_decode->valid_o(dec_valid);
         u_decode->op_o(dec_op);
+        u_decode->uclass_o(dec_uclass);
+        u_decode->unit_o(dec_unit);
         u_decode->sew_o(dec_sew);
         u_decode->lmul_o(dec_lmul);
         u_decode->vd_o(dec_vd);
@@ -220,36 +390,34 @@ SC_MODULE(hp_vpu_top) {
         u_decode->id_o(dec_id);
         u_decode->is_last_uop_o(dec_is_last_uop);
 
-        // Instantiate Hazard
+        // Instantiate Hazard (scoreboard: issue at D -> OF, release at writeback)
         u_hazard = new hp_vpu_hazard("u_hazard");
+        u_hazard->clk(clk);
+        u_hazard->rst_n(rst_n);
         u_hazard->d_valid_i(dec_valid);
+        u_hazard->d_uclass_i(dec_uclass);
         u_hazard->d_vd_i(dec_vd);
         u_hazard->d_vs1_i(dec_vs1);
+        u_hazard->d_is_vx_i(dec_is_vx);
         u_hazard->d_vs2_i(dec_vs2);
         u_hazard->d_vs3_i(dec_vs3);
 
-        u_hazard->of_valid_i(of_valid); u_hazard->of_vd_i(of_vd); // OF stage
-        u_hazard->e1_valid_i(h_e1_valid); u_hazard->e1_vd_i(h_e1_vd);
-        u_hazard->e1m_valid_i(h_e1m_valid); u_hazard->e1m_vd_i(h_e1m_vd);
-        u_hazard->e2_valid_i(h_e2_valid); u_hazard->e2_vd_i(h_e2_vd);
-        u_hazard->e3_valid_i(h_e3_valid); u_hazard->e3_vd_i(h_e3_vd);
-        u_hazard->r2a_valid_i(h_r2a_valid); u_hazard->r2a_vd_i(h_r2a_vd);
-        u_hazard->r2b_valid_i(h_r2b_valid); u_hazard->r2b_vd_i(h_r2b_vd);
-        u_hazard->w2_valid_i(h_w2_valid); u_hazard->w2_vd_i(h_w2_vd);
+        u_hazard->of_valid_i(of_valid);
+        u_hazard->lanes_ready_i(s_lanes_ready);
+        u_hazard->drain_stall_i(s_drain_stall);
 
         u_hazard->wb_valid_i(s_valid_o); u_hazard->wb_vd_i(s_vd_o); // WB stage (Writeback)
 
         u_hazard->stall_dec_o(hazard_stall);
-        u_hazard->multicycle_busy_i(s_multicycle_busy);
-        u_hazard->drain_stall_i(s_drain_stall);
+        u_hazard->stall_reason_o(hazard_reason);
 
         // Instantiate VRF
-        u_vrf = new hp_vpu_vrf("u_vrf");
+        u_vrf = new vrf_t("u_vrf");
         u_vrf->clk(clk);
-        // Address from Decode (Read in D2/OF)
-        u_vrf->raddr1_i(dec_vs1);
-        u_vrf->raddr2_i(dec_vs2);
-        u_vrf->raddr3_i(dec_vs3);
+        // Address from Decode, or OF while held (Read in D2/OF)
+        u_vrf->raddr1_i(vrf_raddr1);
+        u_vrf->raddr2_i(vrf_raddr2);
+        u_vrf->raddr3_i(vrf_raddr3);
         u_vrf->raddr_mask_i(c_addr_v0);
 
         u_vrf->ren1_i(ren_all);
@@ -268,8 +436,13 @@ SC_MODULE(hp_vpu_top) {
         u_vrf->wdata_i(vrf_mux_wdata);
         u_vrf->be_i(vrf_be);
 
+        // Functional model on the same register file
+        u_func = new func_t("u_func");
+        u_func->bind_vrf(u_vrf);
+        mode = MODE_CYCLE;
+
         // Instantiate Lanes
-        u_lanes = new hp_vpu_lanes("u_lanes");
+        u_lanes = new lanes_t("u_lanes");
         u_lanes->clk(clk);
         u_lanes->rst_n(rst_n);
         u_lanes->stall_i(s_flush); // Lanes generally don't stall, they drain
@@ -277,6 +450,8 @@ SC_MODULE(hp_vpu_top) {
         // Lanes get inputs from OF registers
         u_lanes->valid_i(of_valid);
         u_lanes->op_i(of_op);
+        u_lanes->uclass_i(of_uclass);
+        u_lanes->unit_i(of_unit);
 
         // VRF Data (Ready at OF stage due to registered read)
         u_lanes->vs1_i(s_vs1_data);
@@ -301,6 +476,7 @@ SC_MODULE(hp_vpu_top) {
         u_lanes->mul_stall_o(s_mul_stall);
         u_lanes->multicycle_busy_o(s_multicycle_busy);
         u_lanes->drain_stall_o(s_drain_stall);
+        u_lanes->ready_o(s_lanes_ready);
 
         u_lanes->e1_valid_o(h_e1_valid); u_lanes->e1_vd_o(h_e1_vd);
         u_lanes->e1m_valid_o(h_e1m_valid); u_lanes->e1m_vd_o(h_e1m_vd);
@@ -311,13 +487,26 @@ SC_MODULE(hp_vpu_top) {
         u_lanes->w2_valid_o(h_w2_valid); u_lanes->w2_vd_o(h_w2_vd);
 
         SC_METHOD(vrf_control_logic);
-        sensitive << dma_we_i << dma_addr_i << dma_wdata_i << s_valid_o << s_vd_o << s_result_o << dec_valid;
+        sensitive << dma_we_i << dma_addr_i << dma_wdata_i << s_valid_o << s_vd_o << s_result_o << dec_valid
+                  << dec_vs1 << dec_vs2 << dec_vs3 << of_valid << of_vs1 << of_vs2 << of_vs3 << s_lanes_ready;
 
         SC_METHOD(of_stage_logic);
         sensitive << clk.pos();
+
+        for (int i = 0; i < SLOT_COUNT; i++) slot_cycles[i] = 0;
+        iq_full_cycles = 0;
+        lmul_seq_cycles = 0;
+        SC_METHOD(slot_attribution);
+        sensitive << clk.pos();
+        dont_initialize();
+
+        posedges = 0;
+        skipped_cycles = 0;
     }
 };
 
+typedef hp_vpu_top_t<cfg_default> hp_vpu_top;
+
 } // namespace hp_vpu
 
 #endif // HP_VPU_TOP_H
@@ -0,0 +1,124 @@
+#ifndef HP_VPU_TRACE_H
+#define HP_VPU_TRACE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "hp_vpu_func.h"
+
+namespace hp_vpu {
+
+// Binary instruction trace (.vtr), host byte order (little-endian targets)
+// - 32-byte header: magic, version, vtype/vl for the whole stream, record
+//   size and count
+// - count records of cvxif_issue_t {instr, id, rs1, rs2}, so a mapped file
+//   is directly an issue stream for hp_vpu_issue_drv or the functional model
+struct vtrace_header_t {
+    char     magic[8]; // "HPVTRACE"
+    uint32_t version;
+    uint32_t vtype;
+    uint32_t vl;
+    uint32_t rec_size; // sizeof(cvxif_issue_t)
+    uint64_t count;
+};
+
+static_assert(sizeof(vtrace_header_t) == 32, "vtrace header layout");
+static_assert(sizeof(cvxif_issue_t) == 16, "vtrace record layout");
+
+const char VTRACE_MAGIC[8] = { 'H', 'P', 'V', 'T', 'R', 'A', 'C', 'E' };
+const uint32_t VTRACE_VERSION = 1;
+
+inline bool vtrace_write(const std::string& path, uint32_t vtype, uint32_t vl,
+                         const std::vector<cvxif_issue_t>& prog, std::string* err) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        if (err) *err = "cannot create " + path;
+        return false;
+    }
+    vtrace_header_t h;
+    memcpy(h.magic, VTRACE_MAGIC, sizeof(h.magic));
+    h.version = VTRACE_VERSION;
+    h.vtype = vtype;
+    h.vl = vl;
+    h.rec_size = sizeof(cvxif_issue_t);
+    h.count = prog.size();
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+              (prog.empty() || fwrite(prog.data(), sizeof(cvxif_issue_t), prog.size(), f) == prog.size());
+    ok = (fclose(f) == 0) && ok;
+    if (!ok && err) *err = "write failed: " + path;
+    return ok;
+}
+
+// Read-only mapping of a .vtr file; records stay valid while it is open
+class vtrace_map {
+public:
+    vtrace_map() : base(nullptr), len(0) {}
+    ~vtrace_map() { close(); }
+
+    bool open(const std::string& path, std::string* err) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return fail(err, "cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(vtrace_header_t)) {
+            ::close(fd);
+            return fail(err, path + ": not a trace (too short)");
+        }
+        len = (size_t)st.st_size;
+        void* p = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            len = 0;
+            return fail(err, "mmap failed: " + path);
+        }
+        base = p;
+        madvise(base, len, MADV_SEQUENTIAL);
+
+        const vtrace_header_t& h = header();
+        if (memcmp(h.magic, VTRACE_MAGIC, sizeof(h.magic)) != 0 || h.version != VTRACE_VERSION ||
+            h.rec_size != sizeof(cvxif_issue_t)) {
+            close();
+            return fail(err, path + ": bad trace header");
+        }
+        if (h.count > (len - sizeof(vtrace_header_t)) / sizeof(cvxif_issue_t)) {
+            close();
+            return fail(err, path + ": truncated trace");
+        }
+        return true;
+    }
+
+    void close() {
+        if (base) munmap(base, len);
+        base = nullptr;
+        len = 0;
+    }
+
+    bool is_open() const { return base != nullptr; }
+    const vtrace_header_t& header() const { return *static_cast<const vtrace_header_t*>(base); }
+    uint64_t size() const { return header().count; }
+    const cvxif_issue_t* records() const {
+        return reinterpret_cast<const cvxif_issue_t*>(static_cast<const char*>(base) + sizeof(vtrace_header_t));
+    }
+
+private:
+    void* base;
+    size_t len;
+
+    static bool fail(std::string* err, const std::string& msg) {
+        if (err) *err = msg;
+        return false;
+    }
+
+    vtrace_map(const vtrace_map&);
+    vtrace_map& operator=(const vtrace_map&);
+};
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_TRACE_H
@@ -0,0 +1,141 @@
+#ifndef HP_VPU_VREG_H
+#define HP_VPU_VREG_H
+
+#include <systemc.h>
+#include <cstdint>
+#include <iomanip>
+#include <string>
+#include "hp_vpu_pkg.h"
+
+namespace hp_vpu {
+
+// Element width in bits for a SEW encoding.
+// SEW_64 is not supported by the datapath and is treated as 32 (as before).
+inline int sew_bits(int sew) {
+    return (sew == SEW_8) ? 8 : (sew == SEW_16) ? 16 : 32;
+}
+
+// Sign-extend the low `width` bits of v
+inline int64_t sext(uint64_t v, int width) {
+    return (width >= 64) ? (int64_t)v : ((int64_t)(v << (64 - width)) >> (64 - width));
+}
+
+// Fixed-layout vector register (BITS = DLEN bits held as native 64-bit words)
+// Element i of width W occupies bits [i*W, (i+1)*W), same packing as the RTL.
+// Power-of-two elements up to 64 bits never straddle a word, so every access
+// is a single shift/mask. sc_biguint<BITS> is only used at trace/debug edges.
+template<int BITS>
+struct vreg {
+    static_assert(BITS % 64 == 0 && BITS <= 512, "DLEN must be a multiple of 64, at most 512 (byte enables are sc_uint<DLEN/8>)");
+
+    static const int NWORDS = (BITS + 63) / 64;
+    static const int NBYTES = BITS / 8;
+
+    uint64_t w[NWORDS];
+
+    vreg() { clear(); }
+    vreg(uint64_t v) { clear(); w[0] = v; } // Low word init (e.g. `x = 0`, `x = 10`)
+
+    void clear() {
+        for (int i = 0; i < NWORDS; i++) w[i] = 0;
+    }
+
+    static uint64_t width_mask(int width) {
+        return (width >= 64) ? ~0ULL : ((1ULL << width) - 1);
+    }
+
+    // Runtime-width element access (width = 8/16/32/64)
+    uint64_t elem(int i, int width) const {
+        int pos = i * width;
+        return (w[pos >> 6] >> (pos & 63)) & width_mask(width);
+    }
+    void set_elem(int i, int width, uint64_t v) {
+        int pos = i * width;
+        uint64_t m = width_mask(width) << (pos & 63);
+        w[pos >> 6] = (w[pos >> 6] & ~m) | ((v << (pos & 63)) & m);
+    }
+
+    // Typed element views: get<int8_t>(i), set<uint16_t>(i, v), ...
+    template<typename T> T get(int i) const {
+        return (T)elem(i, 8 * sizeof(T));
+    }
+    template<typename T> void set(int i, T v) {
+        set_elem(i, 8 * sizeof(T), (uint64_t)v);
+    }
+
+    // Replicate the low `width` bits of v into every element
+    void broadcast(int width, uint64_t v) {
+        v &= width_mask(width);
+        for (int s = width; s < 64; s <<= 1) v |= v << s;
+        for (int i = 0; i < NWORDS; i++) w[i] = v;
+    }
+
+    // Mask register view (bit i = element i)
+    bool bit(int i) const { return (w[i >> 6] >> (i & 63)) & 1; }
+    void set_bit(int i, bool b) {
+        if (b) w[i >> 6] |= (1ULL << (i & 63));
+        else   w[i >> 6] &= ~(1ULL << (i & 63));
+    }
+
+    bool operator==(const vreg& o) const {
+        for (int i = 0; i < NWORDS; i++) if (w[i] != o.w[i]) return false;
+        return true;
+    }
+    bool operator!=(const vreg& o) const { return !(*this == o); }
+
+    vreg operator&(const vreg& o) const { vreg r; for (int i = 0; i < NWORDS; i++) r.w[i] = w[i] & o.w[i]; return r; }
+    vreg operator|(const vreg& o) const { vreg r; for (int i = 0; i < NWORDS; i++) r.w[i] = w[i] | o.w[i]; return r; }
+    vreg operator^(const vreg& o) const { vreg r; for (int i = 0; i < NWORDS; i++) r.w[i] = w[i] ^ o.w[i]; return r; }
+    vreg operator~() const { vreg r; for (int i = 0; i < NWORDS; i++) r.w[i] = ~w[i]; return r; }
+
+    // Trace/debug boundary conversions
+    sc_biguint<BITS> to_biguint() const {
+        sc_biguint<BITS> r = 0;
+        for (int i = 0; i < NWORDS; i++) {
+            int lo = i * 64;
+            int hi = (lo + 63 < BITS) ? lo + 63 : BITS - 1;
+            r(hi, lo) = (sc_uint<64>)w[i];
+        }
+        return r;
+    }
+    static vreg from_biguint(const sc_biguint<BITS>& b) {
+        vreg r;
+        for (int i = 0; i < NWORDS; i++) {
+            int lo = i * 64;
+            int hi = (lo + 63 < BITS) ? lo + 63 : BITS - 1;
+            r.w[i] = b(hi, lo).to_uint64();
+        }
+        return r;
+    }
+};
+
+// Default-configuration register (cfg_default); templated modules use
+// vreg<CFG::DLEN>
+typedef vreg<DLEN> vreg_t;
+
+// Hex dump, MSB word first (required for sc_signal<vreg<N>>)
+template<int BITS>
+std::ostream& operator<<(std::ostream& os, const vreg<BITS>& v) {
+    std::ios_base::fmtflags f = os.flags();
+    char fill = os.fill();
+    os << "0x";
+    for (int i = vreg<BITS>::NWORDS - 1; i >= 0; i--) {
+        os << std::hex << std::setw(16) << std::setfill('0') << v.w[i];
+        if (i != 0) os << "_";
+    }
+    os.flags(f);
+    os.fill(fill);
+    return os;
+}
+
+// Traced as one 64-bit variable per word (name_w0 = bits 63:0)
+template<int BITS>
+void sc_trace(sc_trace_file* tf, const vreg<BITS>& v, const std::string& name) {
+    for (int i = 0; i < vreg<BITS>::NWORDS; i++) {
+        sc_core::sc_trace(tf, v.w[i], name + "_w" + std::to_string(i));
+    }
+}
+
+} // namespace hp_vpu
+
+#endif // HP_VPU_VREG_H
@@ -3,6 +3,8 @@
 
 #include <systemc.h>
 #include "hp_vpu_pkg.h"
+#include "hp_vpu_prof.h"
+#include "hp_vpu_vreg.h"
 
 namespace hp_vpu {
 
@@ -10,7 +12,11 @@ namespace hp_vpu {
 // - Registered reads (BRAM style): Data available 1 cycle after address
 // - Byte-level write enables
 // - Flat 32-register model (simplification of bank structure but timing accurate)
-SC_MODULE(hp_vpu_vrf) {
+template<class CFG>
+struct hp_vpu_vrf_t : sc_module {
+    static const int DLEN = CFG::DLEN;
+    typedef vreg<DLEN> vreg_t;
+
     // Clock
     sc_in<bool> clk;
 
@@ -27,23 +33,23 @@ SC_MODULE(hp_vpu_vrf) {
     sc_in<bool> ren_mask_i;
 
     // Read Data (Output)
-    sc_out<sc_biguint<DLEN>> rdata1_o;
-    sc_out<sc_biguint<DLEN>> rdata2_o;
-    sc_out<sc_biguint<DLEN>> rdata3_o;
-    sc_out<sc_biguint<DLEN>> rdata_mask_o;
+    sc_out<vreg_t> rdata1_o;
+    sc_out<vreg_t> rdata2_o;
+    sc_out<vreg_t> rdata3_o;
+    sc_out<vreg_t> rdata_mask_o;
 
     // Write Port
     sc_in<bool> we_i;
     sc_in<sc_uint<5>> waddr_i;
-    sc_in<sc_biguint<DLEN>> wdata_i;
-    sc_in<sc_biguint<DLEN/8>> be_i; // Byte enables (1 bit per byte)
+    sc_in<vreg_t> wdata_i;
+    sc_in<sc_uint<DLEN/8>> be_i; // Byte enables (1 bit per byte)
 
-    // Internal Storage: 32 registers of DLEN width
-    // Using uint64_t chunks if DLEN=64, but biguint is generic.
-    sc_biguint<DLEN> regs[32];
+    // Internal Storage: 32 registers of DLEN width (native words)
+    vreg_t regs[32];
 
     // Read Logic (Synchronous)
     void read_process() {
+        HP_VPU_PROF_SCOPE(PROF_VRF_READ);
         if (ren1_i.read()) rdata1_o.write(regs[raddr1_i.read()]);
         if (ren2_i.read()) rdata2_o.write(regs[raddr2_i.read()]);
         if (ren3_i.read()) rdata3_o.write(regs[raddr3_i.read()]);
@@ -52,23 +58,32 @@ SC_MODULE(hp_vpu_vrf) {
 
     // Write Logic (Synchronous)
     void write_process() {
+        HP_VPU_PROF_SCOPE(PROF_VRF_WRITE);
         if (we_i.read()) {
             sc_uint<5> addr = waddr_i.read();
-            sc_biguint<DLEN> data = wdata_i.read();
-            sc_biguint<DLEN/8> be = be_i.read();
-            sc_biguint<DLEN> current = regs[addr];
-
-            // Byte-enable application
-            for (int i = 0; i < DLEN/8; ++i) {
-                if (be[i]) {
-                    current((i+1)*8-1, i*8) = data((i+1)*8-1, i*8);
+            const vreg_t& data = wdata_i.read();
+            uint64_t be = be_i.read().to_uint64();
+            vreg_t& current = regs[addr];
+
+            // Byte-enable application, one 8-bit enable group per word
+            for (int i = 0; i < vreg_t::NWORDS; ++i) {
+                uint64_t be_byte = (be >> (i * 8)) & 0xFF;
+                if (be_byte == 0xFF) { current.w[i] = data.w[i]; continue; }
+                uint64_t m = 0;
+                for (int b = 0; b < 8; ++b) {
+                    if ((be_byte >> b) & 1) m |= 0xFFULL << (b * 8);
                 }
+                current.w[i] = (current.w[i] & ~m) | (data.w[i] & m);
             }
-            regs[addr] = current;
         }
     }
 
-    SC_CTOR(hp_vpu_vrf) {
+    // Backdoor access (functional model, loaders): no ports, no timing
+    const vreg_t& peek(int r) const { return regs[r & 31]; }
+    void poke(int r, const vreg_t& v) { regs[r & 31] = v; }
+
+    SC_HAS_PROCESS(hp_vpu_vrf_t);
+    hp_vpu_vrf_t(sc_module_name name) : sc_module(name) {
         SC_METHOD(read_process);
         sensitive << clk.pos(); // Registered read
 
@@ -76,10 +91,12 @@ SC_MODULE(hp_vpu_vrf) {
         sensitive << clk.pos();
 
         // Initialize
-        for(int i=0; i<32; i++) regs[i] = 0;
+        for(int i=0; i<32; i++) regs[i].clear();
     }
 };
 
+typedef hp_vpu_vrf_t<cfg_default> hp_vpu_vrf;
+
 } // namespace hp_vpu
 
 #endif // HP_VPU_VRF_H
@@ -0,0 +1,162 @@
+#include <systemc.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "hp_vpu_kernels.h"
+#include "hp_vpu_tb.h"
+
+using namespace hp_vpu;
+
+// LLM kernel benchmark suite
+// Runs each kernel of hp_vpu_kernels.h at each accumulator / row count on
+// one testbench (the pipeline drains between runs) and prints a Markdown
+// table in the layout of docs/BENCH_GEMV_RESULTS.md: cycles, vector MACs
+// per cycle and element MACs per cycle (vector MACs x DLEN/SEW).
+// Sanity check: for a kernel with MACs, each extra accumulator chain up to
+// the MAC latency must raise IPC (a dependent vmacc waits that long); a
+// run where it does not fails the benchmark.
+
+namespace {
+
+struct bench_row {
+    std::string kernel;
+    int n_acc;
+    uint64_t insns;
+    uint64_t cycles;
+    uint64_t vec_macs;
+};
+
+std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+sew_e sew_of_bits(int bits) {
+    return bits == 32 ? SEW_32 : bits == 16 ? SEW_16 : SEW_8;
+}
+
+template<class CFG>
+int run_bench(const std::vector<std::string>& kernels, const std::vector<int>& accs, int sew, int insns,
+               std::ostream& md) {
+    vpu_tb_t<CFG> tb;
+    tb.csr_vtype = encode_vtype(sew_of_bits(sew));
+    tb.reset();
+
+    std::vector<bench_row> rows;
+    for (const std::string& name : kernels) {
+        for (int n_acc : accs) {
+            bench_kernel_t k = kernel_build(name, n_acc, insns);
+            hybrid_cfg_t hcfg = { 0, 0, 0 };
+            hybrid_stats_t st = tb.runner.run(k.prog, hcfg);
+            if (tb.issue.timed_out) cerr << "[BENCH] " << name << ": pipeline did not drain" << endl;
+            bench_row r = { name, n_acc, st.insns, st.cycles, k.vec_macs };
+            rows.push_back(r);
+            cout << "[BENCH] " << name << " n_acc=" << n_acc << ": " << st.cycles << " cycles" << endl;
+        }
+    }
+
+    int epv = CFG::DLEN / sew;
+    md << "## LLM Kernels (VLEN=" << CFG::VLEN << ", DLEN=" << CFG::DLEN << ", SEW=" << sew
+       << ", " << epv << " elements/vec)\n\n";
+    md << "| Kernel | Accumulators | Insns | Cycles | IPC | Vec MACs/cycle | Elem MACs/cycle |\n";
+    md << "|:---|:---:|:---:|:---:|:---:|:---:|:---:|\n";
+    char buf[256];
+    for (const bench_row& r : rows) {
+        double c = r.cycles ? (double)r.cycles : 1.0;
+        snprintf(buf, sizeof(buf), "| %s | %d | %llu | %llu | %.3f | %.3f | %.1f |\n", r.kernel.c_str(), r.n_acc,
+                 (unsigned long long)r.insns, (unsigned long long)r.cycles, r.insns / c, r.vec_macs / c,
+                 r.vec_macs * epv / c);
+        md << buf;
+    }
+    md << "\n";
+
+    int bad = 0;
+    const int lat = hp_vpu_hazard::latency(UC_MUL);
+    auto ipc = [](const bench_row& r) { return r.cycles ? (double)r.insns / r.cycles : 0.0; };
+    for (size_t i = 0; i < rows.size(); i++) {
+        for (size_t j = 0; j < i; j++) {
+            const bench_row& a = rows[j];
+            const bench_row& b = rows[i];
+            if (a.kernel != b.kernel || !a.vec_macs || a.n_acc >= b.n_acc || b.n_acc > lat) continue;
+            if (ipc(b) > ipc(a)) continue;
+            cerr << "[BENCH] FAIL: " << b.kernel << " IPC at n_acc=" << b.n_acc << " is not above n_acc=" << a.n_acc
+                 << " (MAC latency " << lat << ")" << endl;
+            bad++;
+        }
+    }
+    return bad;
+}
+
+} // namespace
+
+int sc_main(int argc, char* argv[]) {
+    // Usage: vpu_bench [--config FILE.json] [--kernels a,b,...] [--n-acc 1,2,4,8] [--sew 8|16|32]
+    //                  [--insns N] [--out FILE.md]
+    //   --kernels: subset of kernel_names() (default: all; --help lists them)
+    //   --n-acc:   accumulators (GEMV/GEMM) or rows in flight (softmax, norms) per run
+    //   --insns:   minimum instructions per run, rounded up to whole tiles (default 2000)
+    //   --out:     also write the Markdown table to FILE.md
+    // Exits 1 if a MAC kernel's IPC does not rise with n_acc up to the MAC latency
+    int vlen = VLEN, dlen = DLEN;
+    int sew = 8, insns = 2000;
+    std::vector<std::string> kernels = kernel_names();
+    std::vector<int> accs = { 1, 2, 4, 8 };
+    std::string out_path;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--help")) continue;
+        cout << "Usage: vpu_bench [--config FILE.json] [--kernels a,b,...] [--n-acc 1,2,4,8] [--sew 8|16|32]\n"
+             << "                 [--insns N] [--out FILE.md]\nKernels:";
+        for (const std::string& k : kernels) cout << " " << k;
+        cout << endl;
+        return 0;
+    }
+    for (int a = 1; a + 1 < argc; a += 2) {
+        if (!strcmp(argv[a], "--kernels")) kernels = split_list(argv[a + 1]);
+        else if (!strcmp(argv[a], "--n-acc")) {
+            accs.clear();
+            for (const std::string& s : split_list(argv[a + 1])) accs.push_back(atoi(s.c_str()));
+        }
+        else if (!strcmp(argv[a], "--sew")) sew = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--insns")) insns = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--out")) out_path = argv[a + 1];
+        else if (!strcmp(argv[a], "--config")) {
+            std::string err;
+            if (!load_config_dims(argv[a + 1], vlen, dlen, &err)) {
+                cerr << "[BENCH] " << err << endl;
+                return 2;
+            }
+        }
+    }
+    if (sew != 16 && sew != 32) sew = 8;
+    for (const std::string& k : kernels) {
+        if (kernel_build(k, 1, 1).prog.empty()) {
+            cerr << "[BENCH] unknown kernel: " << k << endl;
+            return 2;
+        }
+    }
+
+    std::ostringstream md;
+    int bad = 0;
+    bool ok = with_config(vlen, dlen, [&](auto cfg) {
+        bad = run_bench<decltype(cfg)>(kernels, accs, sew, insns, md);
+    });
+    if (!ok) {
+        cerr << "[BENCH] No compiled-in configuration for VLEN=" << vlen << " DLEN=" << dlen << endl;
+        return 2;
+    }
+    cout << "\n" << md.str();
+    if (!out_path.empty()) {
+        std::ofstream f(out_path);
+        f << md.str();
+        if (!f) {
+            cerr << "[BENCH] cannot write " << out_path << endl;
+            return 1;
+        }
+    }
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+#include <systemc.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include "verilated.h"
+#include "Vhp_vpu_cosim_probe.h"
+#include "hp_vpu_cosim.h"
+#include "hp_vpu_kernels.h"
+#include "hp_vpu_tb.h"
+#include "hp_vpu_trace.h"
+
+using namespace hp_vpu;
+
+// RTL vs SystemC co-simulation (built by `make cosim`, see hp_vpu_cosim.h)
+// - The Verilated RTL fixes VLEN/DLEN (generated/hp_vpu_pkg.sv); the
+//   matching SystemC instance is picked from it
+// - Stimulus: a benchmark kernel (default: the 500-instruction, 16
+//   accumulator GEMV of tb_main and results/bench_64.log) or a .vtr trace,
+//   optionally after random DMA preloads of v0..v31
+// - Exit 1 on any divergence, a drain timeout or an IPC difference above
+//   --ipc-tol
+
+namespace {
+
+struct cosim_opts_t {
+    std::string kernel, trace, ignore;
+    int n_acc, insns, sew, history;
+    bool preload;
+    uint64_t max_diffs;
+    double ipc_tol;
+};
+
+template<class CFG>
+int run_cosim(Vhp_vpu_cosim_probe* rtl, const cosim_opts_t& o) {
+    typedef typename vpu_tb_t<CFG>::vreg_t vreg_t;
+    vpu_tb_t<CFG> tb;
+    hp_vpu_cosim_t<CFG, Vhp_vpu_cosim_probe> cs("cosim", &tb.top, rtl);
+    cs.clk(tb.clk);
+    tb.clkgen.idle_skip = false; // The RTL is clocked and compared every cycle
+    cs.history = o.history;
+    cs.max_diffs = o.max_diffs;
+    if (!cs.set_ignore(o.ignore)) {
+        cerr << "[COSIM] unknown field in --ignore " << o.ignore << endl;
+        return 2;
+    }
+    // Drained only once both pipelines are
+    tb.issue.idle_fn = [&tb, &cs]() { return tb.top.pipeline_idle() && cs.rtl_idle(); };
+
+    std::vector<cvxif_issue_t> prog;
+    vtrace_map trace;
+    if (!o.trace.empty()) {
+        std::string err;
+        if (!trace.open(o.trace, &err)) {
+            cerr << "[COSIM] " << err << endl;
+            return 2;
+        }
+        tb.csr_vtype = trace.header().vtype;
+        tb.csr_vl = trace.header().vl;
+        prog.assign(trace.records(), trace.records() + trace.size());
+    } else {
+        tb.csr_vtype = encode_vtype(o.sew == 32 ? SEW_32 : o.sew == 16 ? SEW_16 : SEW_8);
+        prog = kernel_build(o.kernel, o.n_acc, o.insns).prog;
+        if (prog.empty()) {
+            cerr << "[COSIM] unknown kernel " << o.kernel << endl;
+            return 2;
+        }
+    }
+    if (!cs.rtl_timing()) {
+        cerr << "[COSIM] lane_timing_t must be zero (RTL timing) to compare against the RTL" << endl;
+        return 2;
+    }
+    tb.reset();
+
+    cout << "[COSIM] " << (o.trace.empty() ? o.kernel : o.trace) << ": " << prog.size()
+         << " instructions, VLEN=" << CFG::VLEN << " DLEN=" << CFG::DLEN << endl;
+
+    if (o.preload) {
+        std::mt19937 rng(2024);
+        for (int r = 0; r < 32; r++) {
+            vreg_t v;
+            for (int w = 0; w < vreg_t::NWORDS; w++) v.w[w] = ((uint64_t)rng() << 32) | rng();
+            tb.dma.write(r, v);
+        }
+    }
+    tb.issue.push(prog);
+    sc_start(); // Paused by the driver once both have drained, or at --max-diffs
+
+    cs.report(cout);
+    int rc = 0;
+    if (!cs.clean()) rc = 1;
+    if (tb.issue.timed_out) {
+        cout << "[COSIM] WARNING: pipelines did not drain" << endl;
+        rc = 1;
+    }
+    if (!cs.halted && std::fabs(cs.ipc_delta()) > o.ipc_tol) {
+        cout << "[COSIM] IPC outside tolerance (" << o.ipc_tol * 100.0 << "%)" << endl;
+        rc = 1;
+    }
+    cout << "[COSIM] " << (rc ? "FAIL" : "PASS") << endl;
+    return rc;
+}
+
+} // namespace
+
+int sc_main(int argc, char* argv[]) {
+    // Usage: vpu_cosim [--kernel NAME] [--n-acc N] [--insns N] [--sew 8|16|32] [--trace FILE.vtr]
+    //                  [--preload 0|1] [--max-diffs N] [--ignore F1,F2] [--history N] [--ipc-tol F]
+    //   --kernel:    kernel_build name (default gemv, 16 accumulators, 500 instructions)
+    //   --trace:     replay a .vtr instead (vtype/vl from its header)
+    //   --preload:   random DMA writes to v0..v31 first
+    //   --max-diffs: stop after N divergent cycles (default 0: run to the end)
+    //   --ignore:    fields left out of the comparison (names as in the report)
+    //   --history:   cycles of context printed at the first divergence (default 16)
+    //   --ipc-tol:   allowed relative IPC difference (default 0.01)
+    cosim_opts_t o;
+    o.kernel = "gemv";
+    o.n_acc = 16;
+    o.insns = 500;
+    o.sew = 8;
+    o.history = 16;
+    o.preload = false;
+    o.max_diffs = 0;
+    o.ipc_tol = 0.01;
+    for (int a = 1; a + 1 < argc; a += 2) {
+        if (!strcmp(argv[a], "--kernel")) o.kernel = argv[a + 1];
+        else if (!strcmp(argv[a], "--n-acc")) o.n_acc = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--insns")) o.insns = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--sew")) o.sew = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--trace")) o.trace = argv[a + 1];
+        else if (!strcmp(argv[a], "--preload")) o.preload = atoi(argv[a + 1]) != 0;
+        else if (!strcmp(argv[a], "--max-diffs")) o.max_diffs = strtoull(argv[a + 1], nullptr, 10);
+        else if (!strcmp(argv[a], "--ignore")) o.ignore = argv[a + 1];
+        else if (!strcmp(argv[a], "--history")) o.history = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--ipc-tol")) o.ipc_tol = atof(argv[a + 1]);
+    }
+
+    Verilated::commandArgs(argc, argv);
+    Vhp_vpu_cosim_probe* rtl = new Vhp_vpu_cosim_probe;
+    rtl->eval();
+    int vlen = (int)rtl->cfg_vlen_o, dlen = (int)rtl->cfg_dlen_o;
+
+    int rc = 2;
+    bool ok = with_config(vlen, dlen, [&](auto cfg) {
+        rc = run_cosim<decltype(cfg)>(rtl, o);
+    });
+    if (!ok) cerr << "[COSIM] No compiled-in configuration for VLEN=" << vlen << " DLEN=" << dlen << endl;
+    rtl->final();
+    delete rtl;
+    return rc;
+}
@@ -1,86 +1,45 @@
 #include <systemc.h>
-#include "hp_vpu_top.h"
+#include "hp_vpu_tb.h"
 #include "golden_model.h"
+#include "hp_vpu_kernels.h"
 #include <iomanip>
+#include <random>
 
 using namespace hp_vpu;
 using namespace std;
 
-// Helper to print DLEN sized biguints
-void print_vec(const char* name, sc_biguint<DLEN> val) {
+// Helper to print DLEN sized vector registers
+void print_vec(const char* name, const vreg_t& val) {
     cout << name << " = ";
     for (int i = DLEN/8 - 1; i >= 0; i--) {
-        int lo = i * 8;
-        int hi = lo + 7;
-        cout << hex << setw(2) << setfill('0') << val(hi, lo).to_uint();
+        cout << hex << setw(2) << setfill('0') << (int)val.get<uint8_t>(i);
         if (i % 4 == 0 && i != 0) cout << "_";
     }
     cout << dec << endl;
 }
 
-int sc_main(int argc, char* argv[]) {
-    sc_clock clk("clk", 2, SC_NS);
-    sc_signal<bool> rst_n;
-
-    // Issue Interface
-    sc_signal<bool> x_issue_valid;
-    sc_signal<sc_uint<32>> x_issue_instr;
-    sc_signal<sc_uint<CVXIF_ID_W>> x_issue_id;
-    sc_signal<sc_uint<32>> x_issue_rs1;
-    sc_signal<sc_uint<32>> x_issue_rs2;
-    sc_signal<bool> x_issue_ready;
-
-    // CSRs
-    sc_signal<sc_uint<32>> csr_vtype;
-    sc_signal<sc_uint<32>> csr_vl;
-
-    // DMA (unused for now)
-    sc_signal<bool> dma_we;
-    sc_signal<sc_uint<5>> dma_addr;
-    sc_signal<sc_biguint<DLEN>> dma_wdata;
-
-    // Instantiate Top
-    hp_vpu_top top("top");
-    top.clk(clk);
-    top.rst_n(rst_n);
-    top.x_issue_valid_i(x_issue_valid);
-    top.x_issue_instr_i(x_issue_instr);
-    top.x_issue_id_i(x_issue_id);
-    top.x_issue_rs1_i(x_issue_rs1);
-    top.x_issue_rs2_i(x_issue_rs2);
-    top.x_issue_ready_o(x_issue_ready);
-    top.csr_vtype_i(csr_vtype);
-    top.csr_vl_i(csr_vl);
-    top.dma_we_i(dma_we);
-    top.dma_addr_i(dma_addr);
-    top.dma_wdata_i(dma_wdata);
-
-    // Trace
-    sc_trace_file *tf = sc_create_vcd_trace_file("wave_full");
-    sc_trace(tf, clk, "clk");
-    sc_trace(tf, rst_n, "rst_n");
-    sc_trace(tf, x_issue_valid, "valid");
-    sc_trace(tf, top.s_valid_o, "res_valid");
-    sc_trace(tf, top.s_result_o, "res_data");
-    sc_trace(tf, top.s_vd_o, "res_vd");
-    sc_trace(tf, top.u_lanes->red_state, "red_state");
-    sc_trace(tf, top.u_lanes->wide_state, "wide_state");
+int sc_main(int, char*[]) {
+    // Clock, pins, hp_vpu_top and the issue/DMA drivers
+    vpu_tb tb;
+    hp_vpu_top& top = tb.top;
+
+    // Flight recorder: the last cycles before a failure, not a full-run VCD
+    tb.frec.enable(256, "wave_full");
+
+    // Commit scoreboard: every writeback against the golden model, also for
+    // the directed tests below; the first mismatch dumps the window
+    tb.scb.on_error = [&](const hp_vpu_scoreboard::expect_t& e, const vreg_t&) {
+        tb.frec.trigger("scoreboard mismatch, id " + std::to_string(e.id));
+    };
 
     // Initialize
-    x_issue_valid = 0;
-    x_issue_instr = 0;
-    x_issue_id = 0;
-    x_issue_rs1 = 0;
-    x_issue_rs2 = 0;
-    csr_vtype = 0; // SEW=8, LMUL=1
-    csr_vl = DLEN/8;
-    dma_we = 0;
-    rst_n = 0;
+    tb.csr_vtype = 0; // SEW=8, LMUL=1
+    tb.csr_vl = DLEN/8;
+    tb.issue.timeout_cycles = 500;
 
     // Reset
-    sc_start(10, SC_NS);
-    rst_n = 1;
-    sc_start(10, SC_NS);
+    tb.reset();
+    tb.scb.enable();
 
     int errors = 0;
     int tests_run = 0;
@@ -91,82 +50,53 @@ int sc_main(int argc, char* argv[]) {
         sc_uint<32> instr_word,
         vpu_op_e op_enum,
         sew_e sew,
-        sc_biguint<DLEN> vs1_val,
-        sc_biguint<DLEN> vs2_val,
-        sc_biguint<DLEN> vs3_val, // old vd
-        sc_biguint<DLEN> vmask_val,
+        vreg_t vs1_val,
+        vreg_t vs2_val,
+        vreg_t vs3_val, // old vd
+        vreg_t vmask_val,
         bool vm,
         bool is_vx,
         sc_uint<32> scalar_val
     ) {
-        // 1. Load Registers (Backdoor or via DMA - using DMA here to be cleaner)
+        // 1. Load Registers through the DMA port
         // Extract register indices from instr
         sc_uint<5> vd  = instr_word(11, 7);
         sc_uint<5> vs1 = instr_word(19, 15);
         sc_uint<5> vs2 = instr_word(24, 20);
 
-        // Write VS1
-        dma_we = 1; dma_addr = vs1; dma_wdata = vs1_val;
-        sc_start(2, SC_NS);
-        // Write VS2
-        dma_we = 1; dma_addr = vs2; dma_wdata = vs2_val;
-        sc_start(2, SC_NS);
-        // Write VS3 (Old VD)
-        dma_we = 1; dma_addr = vd; dma_wdata = vs3_val;
-        sc_start(2, SC_NS);
-        // Write Mask (v0)
-        dma_we = 1; dma_addr = 0; dma_wdata = vmask_val;
-        sc_start(2, SC_NS);
-        dma_we = 0;
-
-        // 2. Setup Issue
-        // Assuming we set VTYPE separately
-        csr_vtype = (int)sew << 3; // Shift to SEW position
-
-        x_issue_valid = 1;
-        x_issue_instr = instr_word;
-        x_issue_id = tests_run;
-        if (is_vx) x_issue_rs1 = scalar_val;
-        else x_issue_rs1 = 0;
-
-        // Wait for ready
-        int timeout = 0;
-        while (!x_issue_ready.read() && timeout < 100) {
-            sc_start(2, SC_NS);
-            timeout++;
-        }
-        if (timeout >= 100) {
-            cout << "TIMEOUT waiting for ready on " << test_name << endl;
-            errors++;
-            x_issue_valid = 0;
-            return;
-        }
+        tb.dma.write(vs1, vs1_val);
+        tb.dma.write(vs2, vs2_val);
+        tb.dma.write(vd, vs3_val);   // VS3 (Old VD)
+        tb.dma.write(0, vmask_val);  // Mask (v0)
 
-        // Clock once to issue
-        sc_start(2, SC_NS);
-        x_issue_valid = 0;
+        // 2. Setup Issue (held by the driver until the DMA writes land)
+        // Assuming we set VTYPE separately
+        tb.csr_vtype = (int)sew << 3; // Shift to SEW position
 
-        // 3. Wait for Result
-        timeout = 0;
-        while (!top.s_valid_o.read() && timeout < 500) {
-            sc_start(2, SC_NS);
-            timeout++;
-        }
+        cvxif_issue_t req = {};
+        req.instr = instr_word.to_uint();
+        req.id = tests_run;
+        req.rs1 = is_vx ? scalar_val.to_uint() : 0;
+        tb.issue.push(req);
 
-        if (timeout >= 500) {
+        // 3. Preload, issue and drain in one run
+        sc_start();
+        if (tb.issue.timed_out || tb.issue.issued == 0) {
             cout << "TIMEOUT waiting for result on " << test_name << endl;
+            tb.frec.trigger(std::string("timeout: ") + test_name);
             errors++;
             return;
         }
+        tb.issue.clear_stats();
 
-        // Capture Result
-        sc_biguint<DLEN> dut_res = top.s_result_o.read();
+        // Capture Result (written back to vd)
+        vreg_t dut_res = top.u_vrf->peek(vd);
 
         // Compute Golden
         // Re-construct logic for golden model arguments
         // Note: decode logic inside GoldenModel call needs to match or we pass explicit args
         // Here we pass explicit args to GoldenModel::compute
-        sc_biguint<DLEN> gold_res = GoldenModel::compute(
+        vreg_t gold_res = GoldenModel::compute(
             op_enum, sew, vs1_val, vs2_val, vs3_val, vmask_val, vm, is_vx, scalar_val
         );
 
@@ -175,14 +105,12 @@ int sc_main(int argc, char* argv[]) {
             cout << "FAIL: " << test_name << endl;
             print_vec("  DUT ", dut_res);
             print_vec("  GOLD", gold_res);
+            tb.frec.trigger(std::string("mismatch: ") + test_name);
             errors++;
         } else {
             // cout << "PASS: " << test_name << endl;
         }
         tests_run++;
-
-        // Wait a few cycles to clear
-        sc_start(4, SC_NS);
     };
 
     cout << "---------------------------------------" << endl;
@@ -197,9 +125,9 @@ int sc_main(int argc, char* argv[]) {
         instr(6,0) = 0x57; instr(11,7) = 10; instr(14,12) = 0b010;
         instr(19,15) = 3; instr(24,20) = 2; instr(25,25) = 1; instr(31,26) = 0b000000;
 
-        sc_biguint<DLEN> vs2; vs2 = 0;
-        for(int i=0; i<DLEN/8; i++) vs2(i*8+7, i*8) = 1; // All 1s
-        sc_biguint<DLEN> vs1; vs1 = 10; // Start value 10
+        vreg_t vs2;
+        for(int i=0; i<DLEN/8; i++) vs2.set<uint8_t>(i, 1); // All 1s
+        vreg_t vs1 = 10; // Start value 10
 
         run_test_op("VREDSUM.VS (All 1s + 10)", instr, OP_VREDSUM, SEW_8, vs1, vs2, 0, 0, true, false, 0);
     }
@@ -211,12 +139,12 @@ int sc_main(int argc, char* argv[]) {
         instr(6,0) = 0x57; instr(11,7) = 11; instr(14,12) = 0b010;
         instr(19,15) = 3; instr(24,20) = 2; instr(25,25) = 1; instr(31,26) = 0b111011;
 
-        sc_biguint<DLEN> vs2; vs2 = 0;
-        sc_biguint<DLEN> vs1; vs1 = 0;
+        vreg_t vs2;
+        vreg_t vs1;
         // Test values: 0x03 * 0x05 = 0x000F (Widened)
         for(int i=0; i<DLEN/8; i++) {
-             vs2(i*8+7, i*8) = 3;
-             vs1(i*8+7, i*8) = 5;
+             vs2.set<uint8_t>(i, 3);
+             vs1.set<uint8_t>(i, 5);
         }
 
         run_test_op("VWMUL.VV (3 * 5 = 15)", instr, OP_VWMUL, SEW_8, vs1, vs2, 0, 0, true, false, 0);
@@ -229,12 +157,12 @@ int sc_main(int argc, char* argv[]) {
         instr(6,0) = 0x57; instr(11,7) = 12; instr(14,12) = 0b000;
         instr(19,15) = 3; instr(24,20) = 2; instr(25,25) = 1; instr(31,26) = 0b100001;
 
-        sc_biguint<DLEN> vs2; vs2 = 0;
-        sc_biguint<DLEN> vs1; vs1 = 0;
+        vreg_t vs2;
+        vreg_t vs1;
         // 100 + 100 = 200 (signed 8-bit saturates to 127)
         for(int i=0; i<DLEN/8; i++) {
-            vs2(i*8+7, i*8) = 100;
-            vs1(i*8+7, i*8) = 100;
+            vs2.set<uint8_t>(i, 100);
+            vs1.set<uint8_t>(i, 100);
         }
 
         run_test_op("VSADD.VV (Sat 100+100)", instr, OP_VSADD, SEW_8, vs1, vs2, 0, 0, true, false, 0);
@@ -248,12 +176,12 @@ int sc_main(int argc, char* argv[]) {
         instr(6,0) = 0x57; instr(11,7) = 13; instr(14,12) = 0b010; // OPMVV
         instr(19,15) = 3; instr(24,20) = 2; instr(25,25) = 1; instr(31,26) = 0b100101; // VMUL
 
-        sc_biguint<DLEN> vs2; vs2 = 0;
-        sc_biguint<DLEN> vs1; vs1 = 0;
+        vreg_t vs2;
+        vreg_t vs1;
         // 0xFF (-1) * 0x01 (1)
         for(int i=0; i<DLEN/8; i++) {
-            vs2(i*8+7, i*8) = 0xFF;
-            vs1(i*8+7, i*8) = 0x01;
+            vs2.set<uint8_t>(i, 0xFF);
+            vs1.set<uint8_t>(i, 0x01);
         }
 
         run_test_op("VMUL.VV (-1 * 1)", instr, OP_VMUL, SEW_8, vs1, vs2, 0, 0, true, false, 0);
@@ -269,12 +197,12 @@ int sc_main(int argc, char* argv[]) {
         instr(25,25) = 0; // vm=0 (Merge)
         instr(31,26) = 0b010111; // VMERGE
 
-        sc_biguint<DLEN> vs2; vs2 = 0; // Old value
-        sc_biguint<DLEN> mask; mask = 0;
+        vreg_t vs2; // Old value
+        vreg_t mask;
         // Mask pattern: 10101010
         for(int i=0; i<DLEN/8; i++) {
-            if(i%2==0) mask[i] = 1; else mask[i] = 0;
-            vs2(i*8+7, i*8) = 0xAA; // Old val
+            mask.set_bit(i, i%2==0);
+            vs2.set<uint8_t>(i, 0xAA); // Old val
         }
 
         // Expected: if mask=1, result=5. if mask=0, result=vs2(0xAA).
@@ -291,11 +219,89 @@ int sc_main(int argc, char* argv[]) {
         run_test_op("VMERGE.VIM (Masked Merge)", instr, OP_VMERGE, SEW_8, 0, vs2, vs2, mask, false, true, 5);
     }
 
+    // --- Test 6: back-to-back random stream, checked by the scoreboard ---
+    // Random encodings over random register contents, issued at full rate
+    // with no drain in between, once per SEW. Drawn from the classes where
+    // GoldenModel and the lanes datapath agree on semantics: single-cycle
+    // ALU and mask-producing ops, unmasked multiply/MAC, the LUT ops and
+    // vslide1up/vslide1down. Reductions and widening (old-vd tail), masked
+    // multiplies, vrsub, vslideup/vslidedown (old-vd head) and vrgather
+    // still differ between the two and are left out.
+    {
+        std::mt19937 rng(2024);
+        decode_cache dc;
+        const int f3s[] = { OPIVV, OPIVX, OPIVI, OPMVV, OPMVX };
+        const sew_e sews[] = { SEW_8, SEW_16, SEW_32 };
+        for (sew_e sew : sews) {
+            uint32_t vt = encode_vtype(sew);
+            for (int r = 0; r < 32; r++) {
+                vreg_t v;
+                for (int w = 0; w < vreg_t::NWORDS; w++) v.w[w] = ((uint64_t)rng() << 32) | rng();
+                tb.dma.write(r, v);
+            }
+            std::vector<cvxif_issue_t> prog;
+            while (prog.size() < 700) {
+                bool vm = (rng() & 3) != 0;
+                int vd = 1 + (int)(rng() % 31); // v0 stays the DMA-loaded mask (read without a hazard check)
+                uint32_t instr = encode_opv(rng() & 63, f3s[rng() % 5], vd, rng() & 31, rng() & 31, vm);
+                const decoded_uop_t& d = dc.lookup(instr, vt);
+                bool ok = d.uclass == UC_ALU || d.uclass == UC_MASK || d.uclass == UC_LUT || (d.uclass == UC_MUL && vm) ||
+                          d.op == OP_VSLIDE1UP || d.op == OP_VSLIDE1DN;
+                if (!ok || d.op == OP_VRSUB || !GoldenModel::supports(d.op)) continue;
+                cvxif_issue_t req = { instr, (uint32_t)(prog.size() & 0xFF), (uint32_t)rng(), 0 };
+                prog.push_back(req);
+            }
+            tb.csr_vtype = vt;
+            tb.issue.push(prog);
+            sc_start();
+            if (tb.issue.timed_out || tb.issue.issued != prog.size()) {
+                cout << "TIMEOUT in random stream, SEW=" << sew_bits(sew) << endl;
+                tb.frec.trigger("timeout: random stream");
+                errors++;
+            }
+            tb.issue.clear_stats();
+            tests_run++;
+        }
+    }
+
+    // --- Test 7: one-accumulator MAC chain on v0 ---
+    // vmacc.vx v0, x10, v16 back to back: each one reads the previous
+    // result, so D must wait the full MAC latency per instruction and the
+    // stalls must be charged to v0 (as hp_vpu_hazard.sv, which compares
+    // the raw register fields)
+    {
+        const int n = 32, lat = hp_vpu_hazard::latency(UC_MUL);
+        tb.csr_vtype = encode_vtype(SEW_8);
+        std::vector<cvxif_issue_t> prog;
+        for (int i = 0; i < n; i++) {
+            cvxif_issue_t req = { encode_opv(F6_VMACC, OPMVX, 0, 10, 16), (uint32_t)i, 3, 0 };
+            prog.push_back(req);
+        }
+        uint64_t c0 = top.cycle_count(), v0_stalls = top.u_hazard->stall_by_reg[0];
+        tb.issue.push(prog);
+        sc_start();
+        uint64_t cycles = top.cycle_count() - c0;
+        v0_stalls = top.u_hazard->stall_by_reg[0] - v0_stalls;
+        cout << "MAC chain on v0: " << n << " vmacc in " << cycles << " cycles, " << v0_stalls
+             << " stalled on v0" << endl;
+        if (tb.issue.timed_out || tb.issue.issued != (uint64_t)n) {
+            cout << "TIMEOUT in MAC chain" << endl;
+            errors++;
+        } else if (cycles < (uint64_t)(n * lat) || v0_stalls < (uint64_t)((n - 1) * (lat - 1))) {
+            cout << "FAIL: MAC chain on v0 does not wait " << lat << " cycles per vmacc" << endl;
+            errors++;
+        }
+        tb.issue.clear_stats();
+        tests_run++;
+    }
+
+    tb.scb.report(cout);
+    errors += (int)(tb.scb.mismatches + tb.scb.unexpected + tb.scb.dma_collisions + tb.scb.pending());
+
     cout << "---------------------------------------" << endl;
     cout << "Tests Run: " << tests_run << endl;
     cout << "Errors:    " << errors << endl;
     cout << "---------------------------------------" << endl;
 
-    sc_close_vcd_trace_file(tf);
     return errors;
 }
@@ -0,0 +1,259 @@
+#include <systemc.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "hp_vpu_kernels.h"
+#include "hp_vpu_prof.h"
+#include "hp_vpu_tb.h"
+
+using namespace hp_vpu;
+
+// Simulator speed benchmark (host time, not simulated cycles)
+// - Fixed instruction mixes, each run `reps` times after one warm-up run on
+//   the same testbench; per run: simulated cycles per host second and host
+//   ns per instruction, reported as min/median/mean/stddev
+// - Every compiled-in datapath width, one forked process each (one
+//   elaboration per process); points run one at a time so they do not
+//   compete for cores
+// - Built with -DHP_VPU_PROF it also reports host ns per SC process
+//   (hp_vpu_prof.h); gate on a build without it
+// - --baseline: compare median ns/insn against an earlier JSON, exit 1 on a
+//   slowdown above --max-slowdown
+
+namespace {
+
+const char* MIXES[] = { "gemv", "gemv_vv", "alu", "softmax", "layernorm" };
+const int NMIXES = sizeof(MIXES) / sizeof(MIXES[0]);
+
+struct config_dims {
+    int vlen, dlen;
+};
+const config_dims CONFIGS[] = { { 64, 64 }, { 128, 128 }, { 256, 256 }, { 512, 512 } };
+
+// Independent single-cycle ALU ops over v0..v15 from v16..v31
+std::vector<cvxif_issue_t> alu_mix(int count) {
+    static const int f6[] = { F6_VADD, 0b001011 /* vxor */, F6_VMIN, 0b100001 /* vsadd */ };
+    kernel_builder b;
+    for (int i = 0; i < count; i++) {
+        int vd = i % 16;
+        if (i % 5 == 4) b.op(encode_opv(0b100101 /* vsll */, OPIVI, vd, 3, 16 + vd));
+        else b.op(encode_opv(f6[i % 4], OPIVV, vd, 16 + (i + 1) % 16, 16 + vd));
+    }
+    return b.k.prog;
+}
+
+std::vector<cvxif_issue_t> mix_program(const std::string& mix, int count) {
+    if (mix == "alu") return alu_mix(count);
+    return kernel_build(mix, 8, count).prog;
+}
+
+struct summary_t {
+    double min, median, mean, stddev;
+};
+
+summary_t summarize(std::vector<double> v) {
+    summary_t s = { 0, 0, 0, 0 };
+    if (v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    s.min = v[0];
+    s.median = (n & 1) ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+    for (double x : v) s.mean += x;
+    s.mean /= n;
+    for (double x : v) s.stddev += (x - s.mean) * (x - s.mean);
+    s.stddev = n > 1 ? std::sqrt(s.stddev / (n - 1)) : 0.0;
+    return s;
+}
+
+void json_summary(std::ostream& os, const char* key, const summary_t& s) {
+    os << "\"" << key << "\": {\"min\": " << s.min << ", \"median\": " << s.median << ", \"mean\": " << s.mean
+       << ", \"stddev\": " << s.stddev << "}";
+}
+
+// Child side: all mixes on one elaboration; JSON objects, comma-separated
+template<class CFG>
+void measure_config(int insns, int reps, std::ostream& js) {
+    vpu_tb_t<CFG> tb;
+    tb.reset();
+
+    for (int m = 0; m < NMIXES; m++) {
+        std::vector<cvxif_issue_t> prog = mix_program(MIXES[m], insns);
+        hybrid_cfg_t hcfg = { 0, 0, 0 };
+        std::vector<double> cps, nspi;
+        uint64_t cycles = 0;
+        double host_total = 0;
+        for (int r = 0; r <= reps; r++) {
+            if (r == 1) prof_counters().clear(); // Run 0 is the warm-up
+            auto t0 = std::chrono::steady_clock::now();
+            hybrid_stats_t st = tb.runner.run(prog, hcfg);
+            double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            if (r == 0) continue;
+            cycles = st.cycles;
+            host_total += sec;
+            cps.push_back(sec > 0 ? st.cycles / sec : 0.0);
+            nspi.push_back(st.insns ? sec * 1e9 / st.insns : 0.0);
+        }
+
+        if (m) js << ",\n";
+        js << "    {\"vlen\": " << CFG::VLEN << ", \"dlen\": " << CFG::DLEN << ", \"mix\": \"" << MIXES[m]
+           << "\", \"insns\": " << prog.size() << ", \"cycles\": " << cycles << ",\n     ";
+        json_summary(js, "cycles_per_sec", summarize(cps));
+        js << ",\n     ";
+        json_summary(js, "ns_per_insn", summarize(nspi));
+        if (prof_enabled()) {
+            // Per run, averaged over the measured runs
+            const prof_counters_t& pc = prof_counters();
+            uint64_t in_procs = 0;
+            js << ",\n     \"process_ns\": {";
+            for (int p = 0; p < PROF_COUNT; p++) {
+                in_procs += pc.ns[p];
+                js << (p ? ", " : "") << "\"" << prof_proc_name(p) << "\": " << pc.ns[p] / reps;
+            }
+            double other = host_total * 1e9 - (double)in_procs;
+            js << ", \"kernel_other\": " << (other > 0 ? (uint64_t)(other / reps) : 0) << "}";
+            js << ",\n     \"process_calls\": {";
+            for (int p = 0; p < PROF_COUNT; p++)
+                js << (p ? ", " : "") << "\"" << prof_proc_name(p) << "\": " << pc.calls[p] / reps;
+            js << "}";
+        }
+        js << "}";
+    }
+}
+
+std::string run_child(const config_dims& c, int insns, int reps) {
+    std::ostringstream js;
+    js.precision(6);
+    bool ok = with_config(c.vlen, c.dlen, [&](auto cfg) {
+        measure_config<decltype(cfg)>(insns, reps, js);
+    });
+    return ok ? js.str() : std::string();
+}
+
+// Fork, run one configuration, collect its JSON over a pipe
+std::string run_forked(const config_dims& c, int insns, int reps) {
+    int fds[2];
+    if (pipe(fds) != 0) { perror("pipe"); return std::string(); }
+    pid_t pid = fork();
+    if (pid < 0) { perror("fork"); return std::string(); }
+    if (pid == 0) {
+        close(fds[0]);
+        std::string r = run_child(c, insns, reps);
+        ssize_t off = 0;
+        while (off < (ssize_t)r.size()) {
+            ssize_t n = write(fds[1], r.data() + off, r.size() - off);
+            if (n <= 0) break;
+            off += n;
+        }
+        close(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    std::string out;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(fds[0], buf, sizeof(buf))) > 0) out.append(buf, n);
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return out;
+}
+
+// Median ns/insn regressions against a baseline; returns the count
+int compare_baseline(const json_value& cur, const json_value& base, double max_slowdown) {
+    int bad = 0;
+    for (const json_value& r : cur["results"].arr) {
+        for (const json_value& b : base["results"].arr) {
+            if (b["vlen"].as_int() != r["vlen"].as_int() || b["mix"].as_string() != r["mix"].as_string()) continue;
+            double was = b["ns_per_insn"]["median"].as_number();
+            double now = r["ns_per_insn"]["median"].as_number();
+            double ratio = was > 0 ? now / was : 1.0;
+            bool slow = ratio > 1.0 + max_slowdown;
+            cout << "[HOSTPERF] " << r["mix"].as_string() << " VLEN=" << r["vlen"].as_int() << ": " << now
+                 << " ns/insn vs " << was << " (" << (ratio - 1.0) * 100.0 << "%)" << (slow ? "  REGRESSION" : "")
+                 << endl;
+            if (slow) bad++;
+        }
+    }
+    return bad;
+}
+
+} // namespace
+
+int sc_main(int argc, char* argv[]) {
+    // Usage: vpu_hostperf [--insns N] [--reps N] [--out FILE.json] [--baseline FILE.json] [--max-slowdown F]
+    //   --insns:        instructions per run (default 20000)
+    //   --reps:         measured runs per mix, after one warm-up run (default 5)
+    //   --out:          JSON result (default hostperf.json)
+    //   --baseline:     earlier result to compare median ns/insn against
+    //   --max-slowdown: allowed fractional slowdown before failing (default 0.10)
+    int insns = 20000, reps = 5;
+    double max_slowdown = 0.10;
+    std::string out_path = "hostperf.json", baseline;
+    for (int a = 1; a + 1 < argc; a += 2) {
+        if (!strcmp(argv[a], "--insns")) insns = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--reps")) reps = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--out")) out_path = argv[a + 1];
+        else if (!strcmp(argv[a], "--baseline")) baseline = argv[a + 1];
+        else if (!strcmp(argv[a], "--max-slowdown")) max_slowdown = atof(argv[a + 1]);
+    }
+    if (reps < 1) reps = 1;
+
+    std::ostringstream js;
+    js << "{\n  \"schema\": \"hp_vpu_hostperf/1\",\n  \"insns\": " << insns << ",\n  \"reps\": " << reps
+       << ",\n  \"profiled\": " << (prof_enabled() ? "true" : "false") << ",\n  \"results\": [\n";
+    bool first = true;
+    for (const config_dims& c : CONFIGS) {
+        cout << "[HOSTPERF] VLEN=" << c.vlen << " DLEN=" << c.dlen << " ..." << endl;
+        cout.flush();
+        std::string part = run_forked(c, insns, reps);
+        if (part.empty()) {
+            cerr << "[HOSTPERF] VLEN=" << c.vlen << " DLEN=" << c.dlen << " failed" << endl;
+            continue;
+        }
+        js << (first ? "" : ",\n") << part;
+        first = false;
+    }
+    js << "\n  ]\n}\n";
+
+    std::ofstream f(out_path);
+    f << js.str();
+    if (!f) {
+        cerr << "[HOSTPERF] cannot write " << out_path << endl;
+        return 1;
+    }
+    f.close();
+
+    json_value cur;
+    std::string err;
+    if (!json_load(out_path, cur, &err)) {
+        cerr << "[HOSTPERF] " << err << endl;
+        return 1;
+    }
+    for (const json_value& r : cur["results"].arr) {
+        cout << "[HOSTPERF] " << r["mix"].as_string() << " VLEN=" << r["vlen"].as_int() << ": "
+             << r["cycles_per_sec"]["median"].as_number() / 1e3 << " kcycles/s, "
+             << r["ns_per_insn"]["median"].as_number() << " ns/insn (stddev "
+             << r["ns_per_insn"]["stddev"].as_number() << ")" << endl;
+    }
+    cout << "[HOSTPERF] Results: " << out_path << endl;
+
+    if (!baseline.empty()) {
+        json_value base;
+        if (!json_load(baseline, base, &err)) {
+            cerr << "[HOSTPERF] " << err << endl;
+            return 2;
+        }
+        int bad = compare_baseline(cur, base, max_slowdown);
+        if (bad) {
+            cout << "[HOSTPERF] " << bad << " regression(s) above " << max_slowdown * 100.0 << "%" << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -1,119 +1,174 @@
 #include <systemc.h>
-#include "hp_vpu_top.h"
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <fstream>
+#include "hp_vpu_tb.h"
+#include "hp_vpu_kernels.h"
+#include "hp_vpu_trace.h"
 
 using namespace hp_vpu;
 
-int sc_main(int argc, char* argv[]) {
-    sc_clock clk("clk", 2, SC_NS);
-    sc_signal<bool> rst_n;
-    sc_signal<bool> x_issue_valid;
-    sc_signal<sc_uint<32>> x_issue_instr;
-    sc_signal<sc_uint<CVXIF_ID_W>> x_issue_id;
-    sc_signal<bool> x_issue_ready;
-    // Added signals for binding
-    sc_signal<sc_uint<32>> x_issue_rs1;
-    sc_signal<sc_uint<32>> x_issue_rs2;
-    sc_signal<sc_uint<32>> csr_vtype;
-    sc_signal<sc_uint<32>> csr_vl;
-    sc_signal<bool> dma_we;
-    sc_signal<sc_uint<5>> dma_addr;
-    sc_signal<sc_biguint<DLEN>> dma_wdata;
-
-    // Instantiate Top
-    hp_vpu_top top("top");
-    top.clk(clk);
-    top.rst_n(rst_n);
-    top.x_issue_valid_i(x_issue_valid);
-    top.x_issue_instr_i(x_issue_instr);
-    top.x_issue_id_i(x_issue_id);
-    top.x_issue_rs1_i(x_issue_rs1);
-    top.x_issue_rs2_i(x_issue_rs2);
-    top.x_issue_ready_o(x_issue_ready);
-    top.csr_vtype_i(csr_vtype);
-    top.csr_vl_i(csr_vl);
-    top.dma_we_i(dma_we);
-    top.dma_addr_i(dma_addr);
-    top.dma_wdata_i(dma_wdata);
+// Flight recorder options (off unless depth > 0)
+struct frec_opts_t {
+    size_t depth;       // Cycles kept
+    frec_format_e fmt;
+    int stall_run;      // Predicate: dump after this many consecutive stalled cycles (0 = off)
+};
+
+// Returns false if the commit scoreboard (--check) saw a mismatch
+template<class CFG>
+bool run_gemv(int target_count, const hybrid_cfg_t& hcfg, const std::string& save_trace, const frec_opts_t& fo,
+              const std::string& stall_json, const std::string& kanata, bool latency, bool check, bool idle_skip) {
+    // Clock, pins, hp_vpu_top and the fast-forward / cycle-accurate runner
+    vpu_tb_t<CFG> tb;
+    hp_vpu_top_t<CFG>& top = tb.top;
+    tb.clkgen.idle_skip = idle_skip;
+
+    // Flight recorder window instead of a full-run VCD
+    if (fo.depth) {
+        tb.frec.enable(fo.depth, "wave_systemc", fo.fmt);
+        if (fo.stall_run > 0) {
+            int run = 0, limit = fo.stall_run;
+            tb.frec.predicate = [run, limit](const typename hp_vpu_flightrec_t<CFG>::frame_t& f) mutable {
+                run = (f.stall != STALL_NONE) ? run + 1 : 0;
+                return run >= limit;
+            };
+            tb.frec.post = 8;
+        }
+    }
 
-    // Trace
-    sc_trace_file *tf = sc_create_vcd_trace_file("wave_systemc");
-    sc_trace(tf, clk, "clk");
-    sc_trace(tf, rst_n, "rst_n");
-    sc_trace(tf, x_issue_valid, "valid");
-    sc_trace(tf, x_issue_ready, "ready");
-    sc_trace(tf, x_issue_instr, "instr");
-    sc_trace(tf, top.u_lanes->e1_valid_o, "e1_valid");
-    sc_trace(tf, top.u_lanes->e1m_valid_o, "e1m_valid");
-    sc_trace(tf, top.u_lanes->e2_valid_o, "e2_valid");
-    sc_trace(tf, top.u_lanes->e3_valid_o, "e3_valid");
+    if (latency || !kanata.empty()) {
+        if (!tb.pview.enable(kanata)) cerr << "[SC] cannot write " << kanata << endl;
+    }
 
-    // Reset
-    rst_n = 0;
-    x_issue_valid = 0;
-    x_issue_instr = 0;
-    sc_start(10, SC_NS);
-    rst_n = 1;
-    sc_start(10, SC_NS);
+    tb.reset();
+    if (check) {
+        tb.scb.enable();
+        tb.scb.on_error = [&tb](const typename hp_vpu_scoreboard_t<CFG>::expect_t&,
+                                const typename hp_vpu_scoreboard_t<CFG>::vreg_t&) {
+            tb.frec.trigger("scoreboard mismatch");
+        };
+    }
 
     // --- GEMV Throughput Test (16 Accumulators) ---
     // Mimicking run_long_gemv from RTL testbench
-    // Issue stream of vmacc.vx to v0..v15
+    // Issue stream of vmacc.vx to v0..v15 (see gemv_program)
 
-    int issued_count = 0;
-    int target_count = 500; // Run 500 instructions for correlation check (500k is too slow for simple TB)
     int n_acc = 16;
 
-    cout << "[SC] Starting GEMV Benchmark (N_ACC=" << n_acc << ")..." << endl;
-    double start_time = sc_time_stamp().to_double();
-
-    for (int i = 0; i < target_count; i++) {
-        // Construct vmacc.vx instruction
-        // vmacc.vx vd, rs1, vs2 -> vd = vd + rs1 * vs2
-        // RTL: encode_vmacc_vx(i[4:0], 5'd10, (16 + i))
-        int vd = i % n_acc;
-        int vs2 = 16 + (i % n_acc);
-        int rs1 = 10;
-
-        // Encoding:
-        // opcode=1010111 (0x57)
-        // funct3=110 (OPMVX)
-        // funct6=101101 (OP_VMACC)
-        // vm=1
-        sc_uint<32> instr = 0;
-        instr(6, 0) = 0x57;
-        instr(11, 7) = vd;
-        instr(14, 12) = 0b110; // OPMVX
-        instr(19, 15) = rs1;
-        instr(24, 20) = vs2;
-        instr[25] = 1; // vm
-        instr(31, 26) = 0b101101; // VMACC
-
-        x_issue_valid = 1;
-        x_issue_instr = instr;
-        x_issue_id = i;
-
-        // Wait for ready
-        do {
-            sc_start(2, SC_NS);
-        } while (x_issue_ready.read() == false);
-
-        // Accepted
-        issued_count++;
+    cout << "[SC] Starting GEMV Benchmark (N_ACC=" << n_acc << ", VLEN=" << CFG::VLEN
+         << ", DLEN=" << CFG::DLEN << ")..." << endl;
+
+    std::vector<cvxif_issue_t> prog = gemv_program(n_acc, target_count);
+    if (!save_trace.empty()) {
+        // Same stream for tb_replay
+        std::string err;
+        if (vtrace_write(save_trace, tb.csr_vtype.read().to_uint(), tb.csr_vl.read().to_uint(), prog, &err))
+            cout << "[SC] Trace saved: " << save_trace << endl;
+        else
+            cerr << "[SC] " << err << endl;
     }
 
-    x_issue_valid = 0;
-
-    // Drain pipeline
-    sc_start(100, SC_NS);
+    auto host_t0 = std::chrono::steady_clock::now();
+    hybrid_stats_t st = tb.runner.run(prog, hcfg);
+    double host_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - host_t0).count();
+    if (tb.issue.timed_out) {
+        cout << "[SC] WARNING: pipeline did not drain" << endl;
+        tb.frec.trigger("drain timeout");
+    }
 
-    double end_time = sc_time_stamp().to_double();
-    double duration = end_time - start_time;
-    int cycles = duration / 2.0; // 2ns period
+    if (st.ff_insns) {
+        cout << "[SC] Fast-forwarded: " << st.ff_insns << " (" << st.ff_cycles << " cycles at one uop/cycle, "
+             << st.ff_mips() << " MIPS host)" << endl;
+    }
+    if (st.warmup_insns) {
+        cout << "[SC] Warm-up: " << st.warmup_insns << endl;
+    }
+    cout << "[SC] Done. Issued: " << st.insns << endl;
+    cout << "[SC] Cycles: " << st.cycles << endl;
+    cout << "[SC] IPC: " << st.ipc() << endl;
+    tb.clkgen.sync_idle();
+    if (idle_skip) cout << "[SC] Idle skip: " << tb.clkgen.skipped << " of " << top.cycle_count() << " posedges not delivered" << endl;
+    top.u_hazard->report(cout);
+    cout << "[SC] Issue slots: " << top.slot_cycles[SLOT_ISSUED] << " used, " << top.lost_slots() << " lost:";
+    for (int i = SLOT_ISSUED + 1; i < SLOT_COUNT; i++)
+        if (top.slot_cycles[i]) cout << " " << slot_cause_name(i) << "=" << top.slot_cycles[i];
+    cout << endl;
+    if (latency || !kanata.empty()) {
+        tb.pview.close();
+        tb.pview.report(cout);
+        if (!kanata.empty()) cout << "[SC] Kanata log: " << kanata << endl;
+    }
+    if (!stall_json.empty()) {
+        std::ofstream js(stall_json);
+        top.stall_json(js);
+        if (js) cout << "[SC] Stall attribution: " << stall_json << endl;
+        else cerr << "[SC] cannot write " << stall_json << endl;
+    }
+    const decode_cache& dc = top.u_decode->dcache;
+    cout << "[SC] Decode cache: " << dc.hits << " hits, " << dc.misses << " misses (" << 100.0 * dc.hit_rate() << "%)" << endl;
+    if (st.ff_insns) {
+        const decode_cache& fc = top.u_func->dcache;
+        cout << "[SC] Functional decode cache: " << fc.hits << " hits, " << fc.misses << " misses (" << 100.0 * fc.hit_rate() << "%)" << endl;
+    }
+    cout << "[SC] Host: " << host_sec << " s (" << (host_sec > 0 ? st.cycles / host_sec : 0.0) << " cycles/s)" << endl;
+    if (!check) return true;
+    tb.scb.report(cout);
+    return tb.scb.clean();
+}
 
-    cout << "[SC] Done. Issued: " << issued_count << endl;
-    cout << "[SC] Cycles: " << cycles << endl;
-    cout << "[SC] IPC: " << (double)issued_count / cycles << endl;
+int sc_main(int argc, char* argv[]) {
+    // Usage: vpu_sc [--config FILE.json] [--insns N] [--ff N] [--warmup N] [--detail N] [--save-trace FILE.vtr]
+    //              [--frec CYCLES] [--frec-fmt vcd|bin] [--frec-stall N] [--stall-json FILE]
+    //              [--kanata FILE] [--latency 1] [--check 1] [--idle-skip 0]
+    //   --config: config/vpu_config*.json selecting VLEN/DLEN (default: vpu_config.json)
+    //   --save-trace: also write the issued stream as a binary trace (tb_replay)
+    //   --ff:     instructions fast-forwarded in the functional model
+    //   --warmup: cycle-accurate instructions excluded from the statistics
+    //   --detail: measured instructions (default: rest of the run)
+    //   --frec:   keep the last CYCLES cycles of pipeline state, dumped to wave_systemc_<n>.vcd/.frec
+    //             on a drain timeout or when --frec-stall sees N consecutive stalled cycles
+    //   --stall-json: write the issue-slot attribution and hazard counters at the end of the run
+    //   --kanata: per-uop stage log for the Konata viewer (implies --latency)
+    //   --latency: issue-to-writeback latency p50/p99/max and histogram per class
+    //   --check:  compare every writeback against the golden model (hp_vpu_scoreboard.h); exit 1 on a mismatch
+    //   --idle-skip: 0 keeps the clock running while the pipeline is idle (cycle counts are the same)
+    int target_count = 500;
+    int vlen = VLEN, dlen = DLEN;
+    std::string save_trace, stall_json, kanata;
+    bool latency = false, check = false, idle_skip = true, clean = true;
+    hybrid_cfg_t hcfg = { 0, 0, 0 };
+    frec_opts_t fo = { 0, FREC_VCD, 0 };
+    for (int a = 1; a + 1 < argc; a += 2) {
+        if (!strcmp(argv[a], "--insns")) target_count = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--ff")) hcfg.ff_insns = strtoull(argv[a + 1], nullptr, 0);
+        else if (!strcmp(argv[a], "--warmup")) hcfg.warmup_insns = strtoull(argv[a + 1], nullptr, 0);
+        else if (!strcmp(argv[a], "--detail")) hcfg.detail_insns = strtoull(argv[a + 1], nullptr, 0);
+        else if (!strcmp(argv[a], "--save-trace")) save_trace = argv[a + 1];
+        else if (!strcmp(argv[a], "--stall-json")) stall_json = argv[a + 1];
+        else if (!strcmp(argv[a], "--kanata")) kanata = argv[a + 1];
+        else if (!strcmp(argv[a], "--latency")) latency = atoi(argv[a + 1]) != 0;
+        else if (!strcmp(argv[a], "--check")) check = atoi(argv[a + 1]) != 0;
+        else if (!strcmp(argv[a], "--idle-skip")) idle_skip = atoi(argv[a + 1]) != 0;
+        else if (!strcmp(argv[a], "--frec")) fo.depth = strtoull(argv[a + 1], nullptr, 0);
+        else if (!strcmp(argv[a], "--frec-fmt")) fo.fmt = strcmp(argv[a + 1], "bin") ? FREC_VCD : FREC_BIN;
+        else if (!strcmp(argv[a], "--frec-stall")) fo.stall_run = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--config")) {
+            std::string err;
+            if (!load_config_dims(argv[a + 1], vlen, dlen, &err)) {
+                cerr << "[SC] " << err << endl;
+                return 2;
+            }
+        }
+    }
 
-    sc_close_vcd_trace_file(tf);
-    return 0;
+    bool ok = with_config(vlen, dlen, [&](auto cfg) {
+        clean = run_gemv<decltype(cfg)>(target_count, hcfg, save_trace, fo, stall_json, kanata, latency, check, idle_skip);
+    });
+    if (!ok) {
+        cerr << "[SC] No compiled-in configuration for VLEN=" << vlen << " DLEN=" << dlen << endl;
+        return 2;
+    }
+    return clean ? 0 : 1;
 }
@@ -0,0 +1,279 @@
+#include <systemc.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include "golden_model.h"
+#include "hp_vpu_lanes.h"
+#include "hp_vpu_simd.h"
+
+using namespace hp_vpu;
+
+// Datapath micro-benchmark (host time per vector op, no simulation)
+// For each compiled-in DLEN, SEW and opcode, times GoldenModel::compute and
+// the hp_vpu_lanes ALU function the pipeline uses for that opcode
+// (alu_* for E2 ops, exec_mul + exec_mac for MACs, exec_reduction,
+// exec_widening). Operands come from a pool of random registers; results
+// are folded into a sink so nothing is optimized away. Reports ns per
+// vector and elements per second (DLEN/SEW elements per call).
+// --batch N instead times GoldenModel::compute_batch on N mixed records at
+// 1, 2, 4, ... threads against a serial compute() loop (and checks that
+// all agree).
+
+namespace {
+
+enum fn_e { FN_ADD, FN_SUB, FN_MUL, FN_MAC, FN_LOGIC, FN_SHIFT, FN_MINMAX, FN_CMP, FN_SAT,
+            FN_PERM, FN_NARROW, FN_LUT, FN_INT4, FN_REDUCE, FN_WIDE };
+
+const char* FN_NAMES[] = { "alu_add", "alu_add(sub)", "alu_mul", "exec_mul+exec_mac", "alu_logic", "alu_shift",
+                           "alu_minmax", "alu_cmp", "alu_sat", "alu_permute", "alu_narrowing", "alu_lut",
+                           "alu_int4", "exec_reduction", "exec_widening" };
+
+struct op_case {
+    const char* name;
+    vpu_op_e op;
+    fn_e fn;
+};
+
+const op_case OPS[] = {
+    { "vadd", OP_VADD, FN_ADD },          { "vsub", OP_VSUB, FN_SUB },
+    { "vmul", OP_VMUL, FN_MUL },          { "vmulh", OP_VMULH, FN_MUL },
+    { "vmulhu", OP_VMULHU, FN_MUL },      { "vmacc", OP_VMACC, FN_MAC },
+    { "vmadd", OP_VMADD, FN_MAC },        { "vand", OP_VAND, FN_LOGIC },
+    { "vxor", OP_VXOR, FN_LOGIC },        { "vsll", OP_VSLL, FN_SHIFT },
+    { "vsra", OP_VSRA, FN_SHIFT },        { "vssrl", OP_VSSRL, FN_SHIFT },
+    { "vssra", OP_VSSRA, FN_SHIFT },      { "vmin", OP_VMIN, FN_MINMAX },
+    { "vmaxu", OP_VMAXU, FN_MINMAX },     { "vmseq", OP_VMSEQ, FN_CMP },
+    { "vmslt", OP_VMSLT, FN_CMP },        { "vsaddu", OP_VSADDU, FN_SAT },
+    { "vsadd", OP_VSADD, FN_SAT },        { "vssubu", OP_VSSUBU, FN_SAT },
+    { "vssub", OP_VSSUB, FN_SAT },        { "vslideup", OP_VSLIDEUP, FN_PERM },
+    { "vslidedown", OP_VSLIDEDN, FN_PERM }, { "vrgather", OP_VRGATHER, FN_PERM },
+    { "vnsrl", OP_VNSRL, FN_NARROW },     { "vnclip", OP_VNCLIP, FN_NARROW },
+    { "vexp", OP_VEXP, FN_LUT },          { "vrsqrt", OP_VRSQRT, FN_LUT },
+    { "vpack4", OP_VPACK4, FN_INT4 },     { "vredsum", OP_VREDSUM, FN_REDUCE },
+    { "vredmax", OP_VREDMAX, FN_REDUCE }, { "vwmul", OP_VWMUL, FN_WIDE },
+    { "vwmaccu", OP_VWMACCU, FN_WIDE },   { "vwadd", OP_VWADD, FN_WIDE },
+};
+const int NOPS = sizeof(OPS) / sizeof(OPS[0]);
+
+const int POOL = 64; // Random operand registers (power of two)
+
+struct result_row {
+    int dlen, sew;
+    const op_case* c;
+    double golden_ns, lanes_ns;
+};
+
+// ns per call: batches of `batch` calls until min_ms has elapsed
+template<class F>
+double time_ns(F&& f, int min_ms) {
+    const int batch = 256;
+    uint64_t n = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    double sec;
+    do {
+        for (int i = 0; i < batch; i++) f((int)(n + i));
+        n += batch;
+        sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    } while (sec * 1e3 < min_ms);
+    return sec * 1e9 / n;
+}
+
+template<class CFG>
+typename hp_vpu_lanes_t<CFG>::vreg_t lanes_call(const op_case& c, sew_e sew,
+                                                const typename hp_vpu_lanes_t<CFG>::vreg_t& a,
+                                                const typename hp_vpu_lanes_t<CFG>::vreg_t& b,
+                                                const typename hp_vpu_lanes_t<CFG>::vreg_t& d, uint32_t scalar) {
+    typedef hp_vpu_lanes_t<CFG> L;
+    switch (c.fn) {
+        case FN_ADD:    return L::alu_add(a, b, sew, false);
+        case FN_SUB:    return L::alu_add(a, b, sew, true);
+        case FN_MUL:    return L::alu_mul(a, b, sew, c.op != OP_VMUL, c.op == OP_VMULH, c.op == OP_VMULH);
+        case FN_MAC:    return L::exec_mac(c.op, sew, L::exec_mul(c.op, sew, a, b, d), a, d);
+        case FN_LOGIC:  return L::alu_logic(a, b, c.op);
+        case FN_SHIFT:  return L::alu_shift(a, b, sew, c.op);
+        case FN_MINMAX: return L::alu_minmax(a, b, sew, c.op);
+        case FN_CMP:    return L::alu_cmp(a, b, sew, c.op);
+        case FN_SAT:    return L::alu_sat(a, b, sew, c.op);
+        case FN_PERM:   return L::alu_permute(a, b, scalar, sew, c.op);
+        case FN_NARROW: return L::alu_narrowing(a, b, sew, c.op);
+        case FN_LUT:    return L::alu_lut(c.op, a, sew);
+        case FN_INT4:   return L::alu_int4(a, c.op);
+        case FN_REDUCE: return L::exec_reduction(c.op, sew, a, b);
+        case FN_WIDE:   return L::exec_widening(c.op, sew, a, b);
+    }
+    return a;
+}
+
+template<class CFG>
+void bench_config(const std::vector<int>& sews, const std::string& only, int min_ms, uint64_t& sink,
+                  std::vector<result_row>& rows) {
+    typedef vreg<CFG::DLEN> vreg_t;
+    std::mt19937_64 rng(12345);
+    std::vector<vreg_t> pool(POOL);
+    for (vreg_t& v : pool)
+        for (int i = 0; i < vreg_t::NWORDS; i++) v.w[i] = rng();
+    vreg_t ones;
+    for (int i = 0; i < vreg_t::NWORDS; i++) ones.w[i] = ~0ULL;
+
+    for (int bits : sews) {
+        sew_e sew = bits == 32 ? SEW_32 : bits == 16 ? SEW_16 : SEW_8;
+        for (int k = 0; k < NOPS; k++) {
+            const op_case& c = OPS[k];
+            if (!only.empty() && ("," + only + ",").find(std::string(",") + c.name + ",") == std::string::npos)
+                continue;
+            // Small shift amounts / slide offsets keep the permute and shift paths representative
+            uint32_t scalar = 3;
+            double g = time_ns([&](int i) {
+                vreg_t r = GoldenModel_t<CFG>::compute(c.op, sew, pool[i & (POOL - 1)], pool[(i + 17) & (POOL - 1)],
+                                                      pool[(i + 31) & (POOL - 1)], ones, true, false, scalar);
+                sink ^= r.w[0] ^ r.w[vreg_t::NWORDS - 1];
+            }, min_ms);
+            double l = time_ns([&](int i) {
+                vreg_t r = lanes_call<CFG>(c, sew, pool[i & (POOL - 1)], pool[(i + 17) & (POOL - 1)],
+                                           pool[(i + 31) & (POOL - 1)], scalar);
+                sink ^= r.w[0] ^ r.w[vreg_t::NWORDS - 1];
+            }, min_ms);
+            result_row r = { CFG::DLEN, bits, &c, g, l };
+            rows.push_back(r);
+        }
+    }
+}
+
+template<class CFG>
+void bench_batch(size_t n, int max_threads, uint64_t& sink) {
+    typedef GoldenModel_t<CFG> GM;
+    typedef typename GM::vreg_t vreg_t;
+    std::mt19937_64 rng(777);
+    std::vector<typename GM::batch_req_t> req(n);
+    for (auto& r : req) {
+        const op_case& c = OPS[rng() % NOPS];
+        r.op = c.op;
+        r.sew = (sew_e)(rng() % 3);
+        r.vm = (rng() & 3) != 0;
+        r.is_vx = (rng() & 3) == 0;
+        r.scalar = (uint32_t)rng();
+        for (int i = 0; i < vreg_t::NWORDS; i++) {
+            r.vs1.w[i] = rng();
+            r.vs2.w[i] = rng();
+            r.vs3.w[i] = rng();
+            r.vmask.w[i] = rng();
+        }
+    }
+
+    std::vector<vreg_t> ref(n), out(n);
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+        const auto& r = req[i];
+        ref[i] = GM::compute(r.op, r.sew, r.vs1, r.vs2, r.vs3, r.vmask, r.vm, r.is_vx, r.scalar);
+    }
+    double serial = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    cout << "[OPBENCH] DLEN=" << CFG::DLEN << " batch of " << n << ": serial " << n / serial / 1e6 << " M/s" << endl;
+
+    for (int t = 1; t <= max_threads; t *= 2) {
+        work_pool pool(t);
+        t0 = std::chrono::steady_clock::now();
+        GM::compute_batch(req.data(), out.data(), n, &pool);
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        size_t bad = GM::check_batch(req.data(), ref.data(), n, nullptr, &pool);
+        for (size_t i = 0; i < n; i++) bad += !(out[i] == ref[i]);
+        sink ^= out[n - 1].w[0];
+        cout << "[OPBENCH]   " << t << " thread(s): " << n / sec / 1e6 << " M/s (x" << serial / sec << ")"
+             << (bad ? "  MISMATCH" : "") << endl;
+        if (t < max_threads && t * 2 > max_threads) t = max_threads / 2; // Finish on max_threads
+    }
+}
+
+std::vector<std::string> split_list(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+} // namespace
+
+int sc_main(int argc, char* argv[]) {
+    // Usage: vpu_opbench [--dlen 64,128,256,512] [--sew 8,16,32] [--ops vadd,vsadd,...] [--min-ms N]
+    //                    [--isa scalar|sse4|avx2] [--csv FILE] [--batch N [--threads T]]
+    //   --ops:    subset of the opcodes (default: all in the table)
+    //   --min-ms: minimum timed interval per (op, SEW, function), default 20
+    //   --isa:    SIMD kernel set for both models (default: best supported, see hp_vpu_simd.h)
+    //   --batch:  time compute_batch on N random records instead, up to --threads (default: all cores)
+    std::vector<int> dlens = { 64, 128, 256, 512 }, sews = { 8, 16, 32 };
+    std::string only, csv_path;
+    int min_ms = 20;
+    size_t batch = 0;
+    int threads = work_pool::default_threads();
+    for (int a = 1; a + 1 < argc; a += 2) {
+        if (!strcmp(argv[a], "--dlen")) {
+            dlens.clear();
+            for (const std::string& s : split_list(argv[a + 1])) dlens.push_back(atoi(s.c_str()));
+        } else if (!strcmp(argv[a], "--sew")) {
+            sews.clear();
+            for (const std::string& s : split_list(argv[a + 1])) sews.push_back(atoi(s.c_str()));
+        }
+        else if (!strcmp(argv[a], "--ops")) only = argv[a + 1];
+        else if (!strcmp(argv[a], "--min-ms")) min_ms = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--csv")) csv_path = argv[a + 1];
+        else if (!strcmp(argv[a], "--batch")) batch = strtoull(argv[a + 1], nullptr, 0);
+        else if (!strcmp(argv[a], "--threads")) threads = atoi(argv[a + 1]);
+        else if (!strcmp(argv[a], "--isa")) {
+            const char* v = argv[a + 1];
+            simd::select_isa(!strcmp(v, "scalar") ? simd::ISA_SCALAR : !strcmp(v, "sse4") ? simd::ISA_SSE4 : simd::ISA_AVX2);
+        }
+    }
+    if (min_ms < 1) min_ms = 1;
+
+    uint64_t sink = 0;
+    if (batch) {
+        if (threads < 1) threads = 1;
+        for (int dlen : dlens)
+            with_config(dlen, dlen, [&](auto cfg) { bench_batch<decltype(cfg)>(batch, threads, sink); });
+        cout << "[OPBENCH] sink " << std::hex << sink << std::dec << endl;
+        return 0;
+    }
+
+    std::vector<result_row> rows;
+    for (int dlen : dlens) {
+        bool ok = with_config(dlen, dlen, [&](auto cfg) {
+            bench_config<decltype(cfg)>(sews, only, min_ms, sink, rows);
+        });
+        if (!ok) cerr << "[OPBENCH] No compiled-in configuration for DLEN=" << dlen << endl;
+    }
+
+    cout << "[OPBENCH] SIMD: " << simd::isa_name(simd::active_isa()) << ", min " << min_ms << " ms per point" << endl;
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%5s %4s %-11s %12s %12s  %-18s %12s %12s", "DLEN", "SEW", "op", "golden ns",
+             "golden Me/s", "lanes function", "lanes ns", "lanes Me/s");
+    cout << buf << endl;
+    std::ofstream csv;
+    if (!csv_path.empty()) {
+        csv.open(csv_path);
+        csv << "dlen,sew,op,golden_ns_per_vec,golden_elems_per_sec,lanes_fn,lanes_ns_per_vec,lanes_elems_per_sec\n";
+    }
+    for (const result_row& r : rows) {
+        double elems = (double)r.dlen / r.sew;
+        double ge = r.golden_ns > 0 ? elems / r.golden_ns * 1e9 : 0.0;
+        double le = r.lanes_ns > 0 ? elems / r.lanes_ns * 1e9 : 0.0;
+        snprintf(buf, sizeof(buf), "%5d %4d %-11s %12.1f %12.1f  %-18s %12.1f %12.1f", r.dlen, r.sew, r.c->name,
+                 r.golden_ns, ge / 1e6, FN_NAMES[r.c->fn], r.lanes_ns, le / 1e6);
+        cout << buf << endl;
+        if (csv.is_open())
+            csv << r.dlen << "," << r.sew << "," << r.c->name << "," << r.golden_ns << "," << ge << ","
+                << FN_NAMES[r.c->fn] << "," << r.lanes_ns << "," << le << "\n";
+    }
+    if (csv.is_open()) {
+        if (!csv) {
+            cerr << "[OPBENCH] cannot write " << csv_path << endl;
+            return 1;
+        }
+        cout << "[OPBENCH] CSV: " << csv_path << endl;
+    }
+    cout << "[OPBENCH] sink " << std::hex << sink << std::dec << endl; // Keeps the results live
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <systemc.h>
+#include <chrono>
+#include <cstring>
+#include "hp_vpu_tb.h"
+#include "hp_vpu_trace.h"
+
+using namespace hp_vpu;
+
+// Replays a .vtr instruction trace (tb_main --save-trace) against the
+// cycle-accurate pipeline: trace mmapped and handed to the issue driver
+// without a copy, one sc_start() for the whole stream and its drain.
+
+template<class CFG>
+void run_replay(const vtrace_map& trace) {
+    vpu_tb_t<CFG> tb;
+    hp_vpu_issue_drv& replay = tb.issue;
+
+    const vtrace_header_t& h = trace.header();
+    tb.csr_vtype = h.vtype;
+    tb.csr_vl = h.vl;
+    tb.reset();
+
+    cout << "[REPLAY] " << trace.size() << " instructions (vtype=0x" << std::hex << h.vtype << std::dec
+         << ", vl=" << h.vl << ", VLEN=" << CFG::VLEN << ", DLEN=" << CFG::DLEN << ")" << endl;
+
+    replay.load(trace.records(), trace.size());
+    auto host_t0 = std::chrono::steady_clock::now();
+    if (trace.size()) sc_start(); // Paused by the driver once drained
+    double host_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - host_t0).count();
+    tb.clkgen.sync_idle();
+
+    uint64_t cycles = (uint64_t)((sc_time_stamp() - replay.t_first) / tb.period + 0.5);
+    cout << "[REPLAY] Issued: " << replay.issued << endl;
+    cout << "[REPLAY] Cycles: " << cycles << endl;
+    cout << "[REPLAY] IPC: " << (cycles ? (double)replay.issued / cycles : 0.0) << endl;
+    cout << "[REPLAY] Issue stalls (ready low): " << replay.stall_cycles << endl;
+    if (replay.timed_out) cout << "[REPLAY] WARNING: pipeline did not drain" << endl;
+    tb.top.u_hazard->report(cout);
+    cout << "[REPLAY] Host: " << host_sec << " s (" << (host_sec > 0 ? cycles / host_sec : 0.0) << " cycles/s)" << endl;
+}
+
+int sc_main(int argc, char* argv[]) {
+    // Usage: vpu_replay TRACE.vtr [--config FILE.json]
+    std::string trace_path;
+    int vlen = VLEN, dlen = DLEN;
+    for (int a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "--config") && a + 1 < argc) {
+            std::string err;
+            if (!load_config_dims(argv[++a], vlen, dlen, &err)) {
+                cerr << "[REPLAY] " << err << endl;
+                return 2;
+            }
+        } else {
+            trace_path = argv[a];
+        }
+    }
+    if (trace_path.empty()) {
+        cerr << "usage: " << argv[0] << " TRACE.vtr [--config FILE.json]" << endl;
+        return 2;
+    }
+
+    vtrace_map trace;
+    std::string err;
+    if (!trace.open(trace_path, &err)) {
+        cerr << "[REPLAY] " << err << endl;
+        return 2;
+    }
+
+    bool ok = with_config(vlen, dlen, [&](auto cfg) {
+        run_replay<decltype(cfg)>(trace);
+    });
+    if (!ok) {
+        cerr << "[REPLAY] No compiled-in configuration for VLEN=" << vlen << " DLEN=" << dlen << endl;
+        return 2;
+    }
+    return 0;
+}
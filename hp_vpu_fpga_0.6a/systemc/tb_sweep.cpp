@@ -0,0 +1,275 @@
+#include <systemc.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "hp_vpu_kernels.h"
+#include "hp_vpu_tb.h"
+
+using namespace hp_vpu;
+
+// Parallel sweep driver
+// - Reads a parameter grid (config/sweep_*.json, same layout as the VPU
+//   config files: "meta", "parameters", plus "output")
+// - Each grid point runs in its own forked process: one elaboration of
+//   hp_vpu_top_t<CFG> per process, as the SystemC kernel requires, and no
+//   state shared between points. The config axis selects CFG at run time
+//   (with_config), so datapath widths sweep in one binary
+// - Up to --jobs points run at once (default: all online cores); each child
+//   sends one CSV row back over a pipe, rows are merged in grid order
+
+namespace {
+
+struct sweep_point {
+    std::string config; // VPU config JSON (empty: the compiled-in parameters)
+    std::string kernel;
+    int n_acc;
+    int sew;
+    int insns;
+    int ff;
+    int warmup;
+    int red_lat;  // lane_timing_t, 0: RTL timing
+    int xbar_lat;
+};
+
+const char* CSV_HEADER =
+    "idx,config,kernel,n_acc,sew,insns,red_lat,xbar_lat,status,cycles,ipc,vec_macs_per_cycle,elem_macs_per_cycle,"
+    "stall_raw,stall_waw,stall_busy,stall_drain,stall_overdue,stall_vx_field,xbar_passes,xlane_elems,red_tree_cycles,host_sec";
+
+std::string dir_of(const std::string& path) {
+    size_t p = path.find_last_of('/');
+    return (p == std::string::npos) ? std::string(".") : path.substr(0, p);
+}
+
+std::string base_of(const std::string& path) {
+    size_t p = path.find_last_of('/');
+    return (p == std::string::npos) ? path : path.substr(p + 1);
+}
+
+// Cartesian product of "parameters" (first key varies slowest).
+// A scalar is a one-value axis.
+bool expand_grid(const json_value& grid, const std::string& grid_dir,
+                 std::vector<sweep_point>& points, std::string& err) {
+    static const char* keys[] = { "config", "kernel", "n_acc", "sew", "insns", "ff", "warmup", "red_lat", "xbar_lat" };
+    const json_value& params = grid["parameters"];
+    if (!params.is_object()) { err = "missing \"parameters\" object"; return false; }
+
+    std::vector<std::pair<std::string, std::vector<json_value>>> axes;
+    for (const auto& kv : params.obj) {
+        bool known = false;
+        for (const char* k : keys) known |= (kv.first == k);
+        if (!known) { err = "unknown parameter \"" + kv.first + "\""; return false; }
+        std::vector<json_value> vals;
+        if (kv.second.is_array()) vals = kv.second.arr;
+        else vals.push_back(kv.second);
+        if (vals.empty()) { err = "empty axis \"" + kv.first + "\""; return false; }
+        axes.push_back(std::make_pair(kv.first, vals));
+    }
+
+    std::vector<size_t> at(axes.size(), 0);
+    for (;;) {
+        sweep_point p = { "", "gemv", 16, 8, 500, 0, 0, 0, 0 };
+        for (size_t a = 0; a < axes.size(); a++) {
+            const std::string& k = axes[a].first;
+            const json_value& v = axes[a].second[at[a]];
+            if (k == "config") p.config = v.as_string().empty() ? "" : grid_dir + "/" + v.as_string();
+            else if (k == "kernel") p.kernel = v.as_string();
+            else if (k == "n_acc") p.n_acc = (int)v.as_int();
+            else if (k == "sew") p.sew = (int)v.as_int();
+            else if (k == "insns") p.insns = (int)v.as_int();
+            else if (k == "ff") p.ff = (int)v.as_int();
+            else if (k == "warmup") p.warmup = (int)v.as_int();
+            else if (k == "red_lat") p.red_lat = (int)v.as_int();
+            else if (k == "xbar_lat") p.xbar_lat = (int)v.as_int();
+        }
+        points.push_back(p);
+
+        size_t a = axes.size();
+        while (a > 0) {
+            a--;
+            if (++at[a] < axes[a].second.size()) break;
+            at[a] = 0;
+            if (a == 0) return true;
+        }
+        if (axes.empty()) return true;
+    }
+}
+
+sew_e sew_of_bits(int bits) {
+    return bits == 32 ? SEW_32 : bits == 16 ? SEW_16 : SEW_8;
+}
+
+// Child side: elaborate the selected configuration, simulate, format the row
+template<class CFG>
+void simulate_point(const sweep_point& p, const bench_kernel_t& kern, std::ostream& row) {
+    vpu_tb_t<CFG> tb;
+    tb.csr_vtype = encode_vtype(sew_of_bits(p.sew));
+    tb.top.u_lanes->timing.red_level_lat = p.red_lat;
+    tb.top.u_lanes->timing.xbar_lat = p.xbar_lat;
+    tb.reset();
+
+    hybrid_cfg_t hcfg = { (uint64_t)p.ff, (uint64_t)p.warmup, 0 };
+    auto t0 = std::chrono::steady_clock::now();
+    hybrid_stats_t st = tb.runner.run(kern.prog, hcfg);
+    double host_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    tb.clkgen.sync_idle();
+
+    const hp_vpu_hazard& hz = *tb.top.u_hazard;
+    const hp_vpu_lanes_t<CFG>& ln = *tb.top.u_lanes;
+    // MACs of the measured window, pro rata when part of the stream is skipped
+    double vmpc = st.cycles ? (double)kern.vec_macs * st.insns / kern.prog.size() / st.cycles : 0.0;
+    row << "ok," << st.cycles << "," << st.ipc() << "," << vmpc << "," << vmpc * (CFG::DLEN / p.sew) << ","
+        << hz.stall_cycles[STALL_RAW] << "," << hz.stall_cycles[STALL_WAW] << ","
+        << hz.stall_cycles[STALL_BUSY] << "," << hz.stall_cycles[STALL_DRAIN] << ","
+        << hz.stall_overdue << "," << hz.stall_vx_field << "," << ln.xbar_passes << "," << ln.xbar_xlane_elems << "," << ln.red_tree_cycles << ","
+        << host_sec;
+}
+
+std::string run_point(size_t idx, const sweep_point& p) {
+    std::ostringstream row;
+    row << idx << "," << (p.config.empty() ? "builtin" : base_of(p.config)) << "," << p.kernel << ","
+        << p.n_acc << "," << p.sew << "," << p.insns << "," << p.red_lat << "," << p.xbar_lat << ",";
+
+    int vlen = VLEN, dlen = DLEN;
+    if (!p.config.empty()) {
+        std::string err;
+        if (!load_config_dims(p.config, vlen, dlen, &err)) {
+            row << "config_error,,,,,,,,,,,,,,";
+            return row.str();
+        }
+    }
+
+    bench_kernel_t kern = kernel_build(p.kernel, p.n_acc, p.insns);
+    if (kern.prog.empty()) {
+        row << "unknown_kernel,,,,,,,,,,,,,,";
+        return row.str();
+    }
+
+    bool ok = with_config(vlen, dlen, [&](auto cfg) {
+        simulate_point<decltype(cfg)>(p, kern, row);
+    });
+    if (!ok) row << "unsupported_config,,,,,,,,,,,,,,";
+    return row.str();
+}
+
+struct child_t {
+    size_t idx;
+    int fd;
+};
+
+} // namespace
+
+int sc_main(int argc, char* argv[]) {
+    // Usage: vpu_sweep GRID.json [--jobs N] [--out FILE.csv]
+    std::string grid_path;
+    std::string out_path;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "--jobs") && a + 1 < argc) jobs = atol(argv[++a]);
+        else if (!strcmp(argv[a], "--out") && a + 1 < argc) out_path = argv[++a];
+        else grid_path = argv[a];
+    }
+    if (grid_path.empty()) {
+        cerr << "usage: " << argv[0] << " GRID.json [--jobs N] [--out FILE.csv]" << endl;
+        return 2;
+    }
+    if (jobs < 1) jobs = 1;
+
+    json_value grid;
+    std::string err;
+    if (!json_load(grid_path, grid, &err)) {
+        cerr << "[SWEEP] " << grid_path << ": " << err << endl;
+        return 2;
+    }
+    std::vector<sweep_point> points;
+    if (!expand_grid(grid, dir_of(grid_path), points, err)) {
+        cerr << "[SWEEP] " << grid_path << ": " << err << endl;
+        return 2;
+    }
+    if (out_path.empty()) out_path = grid["output"]["csv"].as_string("sweep.csv");
+
+    cout << "[SWEEP] " << points.size() << " points, " << jobs << " jobs -> " << out_path << endl;
+    cout.flush();
+
+    std::vector<std::string> rows(points.size());
+    std::map<pid_t, child_t> running;
+    size_t next = 0, done = 0;
+    auto t0 = std::chrono::steady_clock::now();
+
+    while (done < points.size()) {
+        while (next < points.size() && (long)running.size() < jobs) {
+            int fds[2];
+            if (pipe(fds) != 0) { perror("pipe"); return 1; }
+            pid_t pid = fork();
+            if (pid < 0) { perror("fork"); return 1; }
+            if (pid == 0) {
+                // Child: keep the console for the parent's progress lines
+                close(fds[0]);
+                int null_fd = open("/dev/null", O_WRONLY);
+                if (null_fd >= 0) { dup2(null_fd, STDOUT_FILENO); close(null_fd); }
+                std::string r = run_point(next, points[next]) + "\n";
+                ssize_t off = 0;
+                while (off < (ssize_t)r.size()) {
+                    ssize_t n = write(fds[1], r.data() + off, r.size() - off);
+                    if (n <= 0) break;
+                    off += n;
+                }
+                close(fds[1]);
+                _exit(0);
+            }
+            close(fds[1]);
+            running[pid] = { next, fds[0] };
+            next++;
+        }
+
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            perror("waitpid");
+            return 1;
+        }
+        auto it = running.find(pid);
+        if (it == running.end()) continue;
+
+        // Rows are far below the pipe buffer, so the child never blocked on write
+        std::string r;
+        char buf[512];
+        ssize_t n;
+        while ((n = read(it->second.fd, buf, sizeof(buf))) > 0) r.append(buf, n);
+        close(it->second.fd);
+        while (!r.empty() && r.back() == '\n') r.pop_back();
+
+        size_t idx = it->second.idx;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || r.empty()) {
+            const sweep_point& p = points[idx];
+            std::ostringstream os;
+            os << idx << "," << (p.config.empty() ? "builtin" : base_of(p.config)) << "," << p.kernel << ","
+               << p.n_acc << "," << p.sew << "," << p.insns << "," << p.red_lat << ","
+               << p.xbar_lat << ",crashed,,,,,,,,,,,,,,";
+            r = os.str();
+        }
+        rows[idx] = r;
+        running.erase(it);
+        done++;
+        cout << "[SWEEP] " << done << "/" << points.size() << " " << r << endl;
+    }
+
+    std::ofstream csv(out_path);
+    if (!csv) {
+        cerr << "[SWEEP] cannot write " << out_path << endl;
+        return 1;
+    }
+    csv << CSV_HEADER << "\n";
+    for (const auto& r : rows) csv << r << "\n";
+
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    cout << "[SWEEP] Done in " << sec << " s" << endl;
+    return 0;
+}
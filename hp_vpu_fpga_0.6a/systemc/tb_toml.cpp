@@ -0,0 +1,459 @@
+#include <systemc.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <map>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "golden_model.h"
+#include "hp_vpu_kernels.h"
+#include "hp_vpu_tb.h"
+#include "hp_vpu_toml.h"
+
+using namespace hp_vpu;
+
+// TOML test-vector runner for tests/toml/*.toml
+// - Each row of a base/sew8/sew16/sew32 array is one test: operands named
+//   by the file's "format" (vd may be omitted), replicated across the
+//   register, scalar rs1 sign-extended from SEW, imm as the 5-bit field;
+//   base rows run at SEW=8, sew64 rows are not run (ELEN=32)
+// - Every row runs three ways: unmasked on separate registers, masked
+//   (vm=0) under a v0 pattern that changes per batch, and with vd = vs2
+// - Operands go in through the VRF backdoor (u_vrf->poke, zero cycles);
+//   up to --batch independent tests of one SEW share a register window
+//   (vd/vs2/vs1 = v1..v30, v0 holds the mask) and are issued back to back, then
+//   a one-cycle soft reset separates the batch from the next
+// - Every result is read back (u_vrf->peek) and compared with GoldenModel
+// - Tests are sharded over forked processes (--jobs, default all cores),
+//   one elaboration each; every compiled-in width runs unless --config
+//   picks some
+
+namespace {
+
+struct toml_op_t {
+    const char* name;
+    int funct6;
+    bool opm; // OPMVV/OPMVX (multiply, MAC) rather than OPIVV/OPIVX/OPIVI
+};
+
+const toml_op_t TOML_OPS[] = {
+    { "vadd", 0b000000, false },  { "vsub", 0b000010, false },  { "vrsub", 0b000011, false },
+    { "vminu", 0b000100, false }, { "vmin", 0b000101, false },  { "vmaxu", 0b000110, false },
+    { "vmax", 0b000111, false },  { "vand", 0b001001, false },  { "vor", 0b001010, false },
+    { "vxor", 0b001011, false },  { "vsaddu", 0b100000, false }, { "vsadd", 0b100001, false },
+    { "vssubu", 0b100010, false }, { "vssub", 0b100011, false }, { "vsll", 0b100101, false },
+    { "vsrl", 0b101000, false },  { "vsra", 0b101001, false },  { "vssrl", 0b101010, false },
+    { "vssra", 0b101011, false }, { "vmulhu", 0b100100, true }, { "vmul", 0b100101, true },
+    { "vmulhsu", 0b100110, true }, { "vmulh", 0b100111, true }, { "vmadd", 0b101001, true },
+    { "vnmsub", 0b101011, true }, { "vmacc", 0b101101, true },  { "vnmsac", 0b101111, true },
+};
+
+struct toml_test_t {
+    std::string op;      // "vadd.vv"
+    std::string section; // "sew8"
+    int row;
+    int sew;
+    uint32_t funct6;
+    int funct3;
+    uint64_t vd, vs1, vs2; // Element values (vd: old value)
+    uint32_t scalar;     // rs1 (sign-extended) or imm5
+    int variant;         // run_variant_e
+};
+
+// How a row is issued; the name is appended to failure reports
+enum run_variant_e { RUN_PLAIN = 0, RUN_MASKED, RUN_VD_VS2, RUN_VARIANTS };
+const char* const VARIANT_NAMES[RUN_VARIANTS] = { "", "vm=0", "vd=vs2" };
+
+struct config_dims {
+    int vlen, dlen;
+};
+const config_dims CONFIGS[] = { { 64, 64 }, { 128, 128 }, { 256, 256 }, { 512, 512 } };
+
+const uint64_t VD_FILL = 0x5A; // Old vd when the row does not give one (as gen_compliance_tests.py)
+
+std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, sep)) {
+        size_t b = item.find_first_not_of(' '), e = item.find_last_not_of(' ');
+        if (b != std::string::npos) out.push_back(item.substr(b, e - b + 1));
+    }
+    return out;
+}
+
+bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// tests/toml or explicit files, sorted
+bool list_files(const std::vector<std::string>& paths, std::vector<std::string>& files, std::string& err) {
+    for (const std::string& p : paths) {
+        struct stat st;
+        if (stat(p.c_str(), &st) != 0) { err = "cannot open " + p; return false; }
+        if (!S_ISDIR(st.st_mode)) { files.push_back(p); continue; }
+        DIR* d = opendir(p.c_str());
+        if (!d) { err = "cannot open " + p; return false; }
+        std::vector<std::string> in_dir;
+        while (struct dirent* e = readdir(d)) {
+            std::string n = e->d_name;
+            if (ends_with(n, ".toml")) in_dir.push_back(p + "/" + n);
+        }
+        closedir(d);
+        std::sort(in_dir.begin(), in_dir.end());
+        files.insert(files.end(), in_dir.begin(), in_dir.end());
+    }
+    return true;
+}
+
+// One file's rows as tests; unsupported opcodes and sew64 rows are counted
+// in `skipped` with a note
+bool expand_file(const std::string& path, std::vector<toml_test_t>& tests, uint64_t& skipped, std::string& err) {
+    toml_doc doc;
+    if (!toml_load(path, doc, &err)) return false;
+    std::string name = doc["name"].as_string();
+    std::vector<std::string> parts = split(name, '.');
+    if (parts.size() != 2) { err = path + ": bad name \"" + name + "\""; return false; }
+
+    const toml_op_t* op = nullptr;
+    for (const toml_op_t& o : TOML_OPS)
+        if (parts[0] == o.name) op = &o;
+    int funct3 = -1;
+    if (op && parts[1] == "vv") funct3 = op->opm ? OPMVV : OPIVV;
+    if (op && parts[1] == "vx") funct3 = op->opm ? OPMVX : OPIVX;
+    if (op && parts[1] == "vi" && !op->opm) funct3 = OPIVI;
+
+    std::vector<std::string> roles;
+    for (const std::string& r : split(doc["format"].as_string(), ','))
+        if (r != "vm") roles.push_back(r);
+
+    static const struct { const char* key; int sew; } sections[] = {
+        { "base", 8 }, { "sew8", 8 }, { "sew16", 16 }, { "sew32", 32 }, { "sew64", 64 }
+    };
+    for (const auto& sec : sections) {
+        const toml_value& rows = doc[std::string("tests.") + sec.key];
+        if (!rows.is_array()) continue;
+        if (funct3 < 0 || sec.sew > 32) {
+            cout << "[TOML] " << name << " " << sec.key << ": " << rows.arr.size() << " rows not run ("
+                 << (funct3 < 0 ? "opcode not supported by the runner" : "SEW above ELEN") << ")" << endl;
+            skipped += rows.arr.size();
+            continue;
+        }
+        for (size_t r = 0; r < rows.arr.size(); r++) {
+            const toml_value& row = rows.arr[r];
+            // The destination column is optional: only read for accumulators
+            size_t first = row.arr.size() + 1 == roles.size() && !roles.empty() && roles[0] == "vd" ? 1 : 0;
+            if (!row.is_array() || row.arr.size() + first != roles.size()) {
+                std::ostringstream os;
+                os << path << ": " << sec.key << "[" << r << "] does not match format " << doc["format"].as_string();
+                err = os.str();
+                return false;
+            }
+            toml_test_t t;
+            t.op = name;
+            t.section = sec.key;
+            t.row = (int)r;
+            t.sew = sec.sew;
+            t.funct6 = op->funct6;
+            t.funct3 = funct3;
+            t.vd = VD_FILL;
+            t.vs1 = t.vs2 = 0;
+            t.scalar = 0;
+            uint64_t emask = (1ull << sec.sew) - 1;
+            for (size_t c = first; c < roles.size(); c++) {
+                uint64_t v = 0;
+                if (!row.arr[c - first].as_u64(v)) {
+                    err = path + ": bad value in " + sec.key;
+                    return false;
+                }
+                const std::string& role = roles[c];
+                if (role == "vd") t.vd = v & emask;
+                else if (role == "vs1") t.vs1 = v & emask;
+                else if (role == "vs2") t.vs2 = v & emask;
+                else if (role == "rs1") t.scalar = (uint32_t)sext(v & emask, sec.sew);
+                else if (role == "imm") t.scalar = (uint32_t)(v & 0x1F);
+                else { err = path + ": unknown operand " + role; return false; }
+            }
+            t.vd &= emask;
+            for (int v = 0; v < RUN_VARIANTS; v++) {
+                t.variant = v;
+                tests.push_back(t);
+            }
+        }
+    }
+    return true;
+}
+
+// Child side: the given tests on one elaboration. Returns
+// "R <pass> <fail> <skip>" and one "F <idx> <dut> <gold>" line per failure.
+template<class CFG>
+std::string run_shard(const std::vector<toml_test_t>& tests, std::vector<size_t> idx, int batch) {
+    typedef typename vpu_tb_t<CFG>::vreg_t vreg_t;
+    typedef GoldenModel_t<CFG> golden_t;
+    vpu_tb_t<CFG> tb;
+    tb.reset();
+
+    // Batches never mix SEW (vtype is a pin)
+    std::stable_sort(idx.begin(), idx.end(), [&](size_t a, size_t b) { return tests[a].sew < tests[b].sew; });
+
+    decode_cache dc;
+    uint64_t mask_seed = 0x243F6A8885A308D3ull;
+    uint64_t pass = 0, fail = 0, skip = 0;
+    std::ostringstream out;
+    size_t k = 0;
+    while (k < idx.size()) {
+        int sew = tests[idx[k]].sew;
+        std::vector<size_t> grp;
+        while (k < idx.size() && (int)grp.size() < batch && tests[idx[k]].sew == sew) grp.push_back(idx[k++]);
+
+        sew_e vsew = sew == 32 ? SEW_32 : sew == 16 ? SEW_16 : SEW_8;
+        uint32_t vtype = encode_vtype(vsew);
+        tb.csr_vtype = vtype;
+
+        // Mask for the vm=0 rows: a different mix of set and clear bits per
+        // batch, so each element position sees both across the run
+        vreg_t mask;
+        for (int w = 0; w < vreg_t::NWORDS; w++) {
+            mask_seed = mask_seed * 6364136223846793005ull + 1442695040888963407ull;
+            mask.w[w] = mask_seed ^ (mask_seed >> 29);
+        }
+        tb.top.u_vrf->poke(0, mask);
+
+        std::vector<cvxif_issue_t> prog;
+        for (size_t s = 0; s < grp.size(); s++) {
+            const toml_test_t& t = tests[grp[s]];
+            int vd = 1 + 3 * (int)s, vs2 = t.variant == RUN_VD_VS2 ? vd : vd + 1, vs1 = vd + 2;
+            vreg_t r;
+            r.broadcast(sew, t.vd);
+            tb.top.u_vrf->poke(vd, r);
+            r.broadcast(sew, t.vs2);
+            tb.top.u_vrf->poke(vs2, r);
+            r.broadcast(sew, t.vs1);
+            tb.top.u_vrf->poke(vs1, r);
+            int src1 = t.funct3 == OPIVI ? (int)t.scalar : vs1;
+            cvxif_issue_t req = { encode_opv(t.funct6, t.funct3, vd, src1, vs2, t.variant != RUN_MASKED),
+                                  (uint32_t)s, t.scalar, 0 };
+            prog.push_back(req);
+        }
+
+        // Expected results from the poked operands, before anything runs
+        std::vector<vreg_t> gold(grp.size());
+        std::vector<bool> known(grp.size());
+        const vreg_t& v0 = tb.top.u_vrf->peek(0);
+        for (size_t s = 0; s < grp.size(); s++) {
+            const decoded_uop_t& d = dc.lookup(prog[s].instr, vtype & 0x3F);
+            int vd = 1 + 3 * (int)s;
+            known[s] = golden_t::supports(d.op);
+            if (!known[s]) continue;
+            uint32_t scalar = d.is_vx ? (d.is_opivi ? d.imm.to_uint() : prog[s].rs1) : 0;
+            gold[s] = golden_t::compute(d.op, vsew, tb.top.u_vrf->peek(d.vs1.to_uint()), tb.top.u_vrf->peek(d.vs2.to_uint()),
+                                        tb.top.u_vrf->peek(vd), v0, d.vm, d.is_vx, scalar);
+        }
+
+        tb.issue.push(prog);
+        sc_start(); // Paused by the driver once drained
+        bool timed_out = tb.issue.timed_out;
+
+        for (size_t s = 0; s < grp.size(); s++) {
+            if (!known[s]) { skip++; continue; }
+            const vreg_t& dut = tb.top.u_vrf->peek(1 + 3 * (int)s);
+            if (!timed_out && dut == gold[s]) { pass++; continue; }
+            fail++;
+            out << "F " << grp[s] << " " << dut << " " << gold[s] << (timed_out ? " timeout" : "") << "\n";
+        }
+        tb.soft_reset();
+    }
+    std::ostringstream head;
+    head << "R " << pass << " " << fail << " " << skip << "\n";
+    return head.str() + out.str();
+}
+
+struct unit_t {
+    int cfg;      // Index into the configuration list
+    int shard;
+    std::vector<size_t> idx;
+};
+
+struct child_t {
+    size_t unit;
+    int fd;
+};
+
+struct cfg_result_t {
+    uint64_t pass, fail, skip, crashed;
+    std::vector<std::string> fails;
+};
+
+} // namespace
+
+int sc_main(int argc, char* argv[]) {
+    // Usage: vpu_toml [DIR|FILE.toml ...] [--config FILE.json ...] [--jobs N] [--batch N]
+    //   DIR/FILE:  vector files (default ../tests/toml)
+    //   --config:  datapath width(s) to run (default every compiled-in width)
+    //   --jobs:    processes at once (default all online cores)
+    //   --batch:   independent tests between soft resets (1..10, default 10)
+    std::vector<std::string> paths;
+    std::vector<config_dims> configs;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    int batch = 10;
+    for (int a = 1; a < argc; a++) {
+        if (!strcmp(argv[a], "--jobs") && a + 1 < argc) jobs = atol(argv[++a]);
+        else if (!strcmp(argv[a], "--batch") && a + 1 < argc) batch = atoi(argv[++a]);
+        else if (!strcmp(argv[a], "--config") && a + 1 < argc) {
+            config_dims c;
+            std::string err;
+            if (!load_config_dims(argv[++a], c.vlen, c.dlen, &err)) {
+                cerr << "[TOML] " << err << endl;
+                return 2;
+            }
+            configs.push_back(c);
+        } else {
+            paths.push_back(argv[a]);
+        }
+    }
+    if (paths.empty()) paths.push_back("../tests/toml");
+    if (configs.empty()) configs.assign(CONFIGS, CONFIGS + sizeof(CONFIGS) / sizeof(CONFIGS[0]));
+    for (const config_dims& c : configs) {
+        if (!with_config(c.vlen, c.dlen, [](auto) {})) {
+            cerr << "[TOML] No compiled-in configuration for VLEN=" << c.vlen << " DLEN=" << c.dlen << endl;
+            return 2;
+        }
+    }
+    if (jobs < 1) jobs = 1;
+    batch = std::max(1, std::min(batch, 10)); // Three registers per test in v1..v30
+
+    std::vector<std::string> files;
+    std::vector<toml_test_t> tests;
+    uint64_t not_run = 0;
+    std::string err;
+    if (!list_files(paths, files, err)) {
+        cerr << "[TOML] " << err << endl;
+        return 2;
+    }
+    for (const std::string& f : files) {
+        if (!expand_file(f, tests, not_run, err)) {
+            cerr << "[TOML] " << err << endl;
+            return 2;
+        }
+    }
+    cout << "[TOML] " << files.size() << " files, " << tests.size() << " tests (" << not_run << " rows not run), "
+         << configs.size() << " configurations, " << jobs << " jobs" << endl;
+    cout.flush();
+
+    // Shards per configuration: round-robin, at most one per batch of tests
+    long shards = std::max(1L, std::min(jobs, (long)((tests.size() + batch - 1) / batch)));
+    std::vector<unit_t> units;
+    for (size_t c = 0; c < configs.size(); c++) {
+        for (long s = 0; s < shards; s++) {
+            unit_t u;
+            u.cfg = (int)c;
+            u.shard = (int)s;
+            for (size_t i = s; i < tests.size(); i += shards) u.idx.push_back(i);
+            if (!u.idx.empty()) units.push_back(u);
+        }
+    }
+
+    std::vector<cfg_result_t> res(configs.size(), cfg_result_t{ 0, 0, 0, 0, {} });
+    std::map<pid_t, child_t> running;
+    size_t next = 0, done = 0;
+    auto t0 = std::chrono::steady_clock::now();
+
+    while (done < units.size()) {
+        while (next < units.size() && (long)running.size() < jobs) {
+            int fds[2];
+            if (pipe(fds) != 0) { perror("pipe"); return 1; }
+            pid_t pid = fork();
+            if (pid < 0) { perror("fork"); return 1; }
+            if (pid == 0) {
+                close(fds[0]);
+                int null_fd = open("/dev/null", O_WRONLY);
+                if (null_fd >= 0) { dup2(null_fd, STDOUT_FILENO); close(null_fd); }
+                const unit_t& u = units[next];
+                std::string r;
+                with_config(configs[u.cfg].vlen, configs[u.cfg].dlen, [&](auto cfg) {
+                    r = run_shard<decltype(cfg)>(tests, u.idx, batch);
+                });
+                ssize_t off = 0;
+                while (off < (ssize_t)r.size()) {
+                    ssize_t n = write(fds[1], r.data() + off, r.size() - off);
+                    if (n <= 0) break;
+                    off += n;
+                }
+                close(fds[1]);
+                _exit(0);
+            }
+            close(fds[1]);
+            running[pid] = { next, fds[0] };
+            next++;
+        }
+
+        // Oldest child first, its pipe read to EOF before the wait: a long
+        // failure list may not fit in the pipe buffer
+        auto it = running.begin();
+        std::string r;
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(it->second.fd, buf, sizeof(buf))) > 0) r.append(buf, n);
+        close(it->second.fd);
+        int status = 0;
+        while (waitpid(it->first, &status, 0) < 0) {
+            if (errno != EINTR) { perror("waitpid"); return 1; }
+        }
+
+        const unit_t& u = units[it->second.unit];
+        cfg_result_t& cr = res[u.cfg];
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || r.compare(0, 2, "R ") != 0) {
+            cr.crashed += u.idx.size();
+        } else {
+            std::istringstream is(r);
+            std::string line;
+            while (std::getline(is, line)) {
+                std::istringstream ls(line);
+                std::string tag;
+                ls >> tag;
+                if (tag == "R") {
+                    uint64_t p, f, s;
+                    ls >> p >> f >> s;
+                    cr.pass += p;
+                    cr.fail += f;
+                    cr.skip += s;
+                } else if (tag == "F") {
+                    size_t i;
+                    std::string dut, gold, note;
+                    ls >> i >> dut >> gold >> note;
+                    const toml_test_t& t = tests[i];
+                    std::ostringstream os;
+                    os << t.op << " " << t.section << "[" << t.row << "]"
+                       << (t.variant != RUN_PLAIN ? std::string(" ") + VARIANT_NAMES[t.variant] : "")
+                       << (note.empty() ? "" : " " + note)
+                       << ": DUT " << dut << " GOLD " << gold;
+                    cr.fails.push_back(os.str());
+                }
+            }
+        }
+        running.erase(it);
+        done++;
+    }
+    double host_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    int rc = 0;
+    for (size_t c = 0; c < configs.size(); c++) {
+        const cfg_result_t& cr = res[c];
+        cout << "[TOML] VLEN=" << configs[c].vlen << " DLEN=" << configs[c].dlen << ": " << cr.pass << " passed, "
+             << cr.fail << " failed, " << cr.skip << " without golden";
+        if (cr.crashed) cout << ", " << cr.crashed << " lost to a crashed process";
+        cout << endl;
+        for (size_t i = 0; i < cr.fails.size() && i < 20; i++) cout << "[TOML]   FAIL " << cr.fails[i] << endl;
+        if (cr.fails.size() > 20) cout << "[TOML]   ... " << cr.fails.size() - 20 << " more" << endl;
+        if (cr.fail || cr.crashed) rc = 1;
+    }
+    cout << "[TOML] Host: " << host_sec << " s" << endl;
+    cout << "[TOML] " << (rc ? "FAIL" : "PASS") << endl;
+    return rc;
+}